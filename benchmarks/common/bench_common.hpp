@@ -0,0 +1,283 @@
+#ifndef VGW_BENCH_COMMON_HPP
+#define VGW_BENCH_COMMON_HPP
+
+#pragma once
+
+#include <vgw/vgw.hpp>
+
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <string_view>
+
+/**
+ * Helpers shared by the vgw benchmark targets.
+ * The benchmarks only need a Vulkan 1.3 device, so they also run on a software driver. To force lavapipe (the first physical device
+ * is used), run with `VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json`.
+ */
+namespace vgw_bench
+{
+    struct BenchOptions
+    {
+        // Results are written to stdout when empty.
+        std::string outputFilename{};
+        // Only benchmarks whose name contains the filter are run.
+        std::string filter{};
+        std::uint32_t repetitions{ 15 };
+    };
+
+    // Benchmark specific option, e.g. `--frames <count>`.
+    struct UintOption
+    {
+        std::string_view name{};
+        std::uint32_t* value{};
+    };
+
+    inline auto parse_options(int argc, char** argv, BenchOptions& options, const std::vector<UintOption>& extraOptions = {}) -> bool
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            const auto extraIt = std::ranges::find(extraOptions, arg, &UintOption::name);
+            if (extraIt != extraOptions.end() && hasValue)
+            {
+                *extraIt->value = std::uint32_t(std::max(1, std::stoi(argv[++i])));
+            }
+            else if (arg == "--output" && hasValue)
+            {
+                options.outputFilename = argv[++i];
+            }
+            else if (arg == "--filter" && hasValue)
+            {
+                options.filter = argv[++i];
+            }
+            else if (arg == "--repetitions" && hasValue)
+            {
+                options.repetitions = std::uint32_t(std::max(1, std::stoi(argv[++i])));
+            }
+            else
+            {
+                std::cerr << "Usage: " << argv[0] << " [--output <file.json>] [--filter <name>] [--repetitions <count>]";
+                for (const auto& extraOption : extraOptions)
+                {
+                    std::cerr << " [" << extraOption.name << " <count>]";
+                }
+                std::cerr << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct BenchResult
+    {
+        std::string name{};
+        std::string unit{};
+        // Number of samples (repetitions) and operations timed per sample.
+        std::uint32_t samples{};
+        std::uint32_t opsPerSample{};
+        double median{};
+        double mean{};
+        double min{};
+        double max{};
+        double stddev{};
+    };
+
+    inline auto make_result(std::string_view name, std::string_view unit, std::uint32_t opsPerSample, std::vector<double> values)
+        -> BenchResult
+    {
+        BenchResult result{
+            .name = std::string(name),
+            .unit = std::string(unit),
+            .samples = std::uint32_t(values.size()),
+            .opsPerSample = opsPerSample,
+        };
+        if (values.empty())
+        {
+            return result;
+        }
+
+        std::ranges::sort(values);
+        const auto count = values.size();
+        result.median = count % 2 == 1 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) * 0.5;
+        result.min = values.front();
+        result.max = values.back();
+
+        double sum = 0.0;
+        for (const auto value : values)
+        {
+            sum += value;
+        }
+        result.mean = sum / double(count);
+
+        double variance = 0.0;
+        for (const auto value : values)
+        {
+            variance += (value - result.mean) * (value - result.mean);
+        }
+        result.stddev = std::sqrt(variance / double(count));
+        return result;
+    }
+
+    inline auto now_ns() -> std::uint64_t
+    {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    }
+
+    // Times `fn`, returning nanoseconds.
+    template <typename Fn>
+    auto time_ns(Fn&& fn) -> std::uint64_t
+    {
+        const auto startNs = now_ns();
+        fn();
+        return now_ns() - startNs;
+    }
+
+    class BenchRunner
+    {
+    public:
+        explicit BenchRunner(BenchOptions options) : m_options(std::move(options)) {}
+
+        /**
+         * Runs `sampleFn(opsPerSample)` once to warm up, then once per repetition. `sampleFn` returns the nanoseconds spent on the
+         * timed operations only, so per-sample setup and teardown can be kept out of the measurement.
+         */
+        template <typename SampleFn>
+        void run(std::string_view name, std::uint32_t opsPerSample, SampleFn&& sampleFn)
+        {
+            if (!m_options.filter.empty() && name.find(m_options.filter) == std::string_view::npos)
+            {
+                return;
+            }
+
+            std::cerr << "Running " << name << "..." << std::endl;
+            sampleFn(opsPerSample);
+
+            std::vector<double> values{};
+            values.reserve(m_options.repetitions);
+            for (std::uint32_t i = 0; i < m_options.repetitions; ++i)
+            {
+                const std::uint64_t elapsedNs = sampleFn(opsPerSample);
+                values.push_back(double(elapsedNs) / double(opsPerSample));
+            }
+            m_results.push_back(make_result(name, "ns/op", opsPerSample, std::move(values)));
+        }
+
+        void add_result(BenchResult result) { m_results.push_back(std::move(result)); }
+        // Written to the "info" object, e.g. the configuration or an output checksum. Not compared between runs.
+        void add_info(std::string_view key, std::string_view value) { m_info.emplace_back(std::string(key), std::string(value)); }
+
+        auto get_options() const -> const BenchOptions& { return m_options; }
+
+        auto to_json(std::string_view benchName) const -> std::string
+        {
+            std::string json = "{\n  \"benchmark\": \"" + std::string(benchName) + "\",\n  \"info\": {";
+            for (std::size_t i = 0; i < m_info.size(); ++i)
+            {
+                json += (i > 0 ? ", \"" : "\"") + m_info.at(i).first + "\": \"" + m_info.at(i).second + "\"";
+            }
+            json += "},\n  \"results\": [";
+            for (std::size_t i = 0; i < m_results.size(); ++i)
+            {
+                const auto& result = m_results.at(i);
+                json += i > 0 ? ",\n" : "\n";
+                json += "    {\"name\": \"" + result.name + "\", \"unit\": \"" + result.unit + "\"";
+                json += ", \"samples\": " + std::to_string(result.samples);
+                json += ", \"opsPerSample\": " + std::to_string(result.opsPerSample);
+                json += ", \"median\": " + std::to_string(result.median);
+                json += ", \"mean\": " + std::to_string(result.mean);
+                json += ", \"min\": " + std::to_string(result.min);
+                json += ", \"max\": " + std::to_string(result.max);
+                json += ", \"stddev\": " + std::to_string(result.stddev) + "}";
+            }
+            json += "\n  ]\n}\n";
+            return json;
+        }
+
+        auto write_json(std::string_view benchName) const -> bool
+        {
+            const auto json = to_json(benchName);
+            if (m_options.outputFilename.empty())
+            {
+                std::cout << json;
+                return true;
+            }
+
+            std::ofstream fileOut(m_options.outputFilename, std::ios::out | std::ios::trunc);
+            if (!fileOut.is_open())
+            {
+                std::cerr << "Failed to open " << m_options.outputFilename << " for writing!" << std::endl;
+                return false;
+            }
+            fileOut << json;
+            return true;
+        }
+
+    private:
+        BenchOptions m_options;
+        std::vector<BenchResult> m_results;
+        std::vector<std::pair<std::string, std::string>> m_info;
+    };
+
+    inline void message_callback(vgw::MessageType msgType, std::string_view msg)
+    {
+        // Keep stdout clean for the JSON results.
+        if (msgType == vgw::MessageType::eError || msgType == vgw::MessageType::eWarning)
+        {
+            std::cerr << msg << std::endl;
+        }
+    }
+
+    // Single graphics+compute queue, no surfaces. Validation is disabled so it does not skew the timings.
+    inline auto initialise_headless(std::uint32_t maxDescriptorSets, std::vector<vk::DescriptorPoolSize> descriptorPoolSizes) -> bool
+    {
+        vgw::set_message_callback(message_callback);
+
+        vgw::ContextInfo contextInfo{
+            .appName = "vgw_bench",
+            .appVersion = VK_MAKE_API_VERSION(0, 1, 0, 0),
+            .engineName = "vgw",
+            .engineVersion = VK_MAKE_API_VERSION(0, 1, 0, 0),
+            .enableSurfaces = false,
+            .enableDebug = false,
+        };
+        if (vgw::initialise_context(contextInfo) != vgw::ResultCode::eSuccess)
+        {
+            std::cerr << "Failed to initialise VGW context!" << std::endl;
+            return false;
+        }
+
+        vgw::DeviceInfo deviceInfo{
+            .wantedQueues = {
+                vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute,
+            },
+            .enableSwapChains = false,
+            .enableDynamicRendering = true,
+            .maxDescriptorSets = maxDescriptorSets,
+            .descriptorPoolSizes = std::move(descriptorPoolSizes),
+        };
+        if (vgw::initialise_device(deviceInfo) != vgw::ResultCode::eSuccess)
+        {
+            std::cerr << "Failed to initialise VGW device!" << std::endl;
+            vgw::destroy_context();
+            return false;
+        }
+        return true;
+    }
+
+    inline void destroy_headless()
+    {
+        vgw::destroy_device();
+        vgw::destroy_context();
+    }
+}
+
+#endif  // VGW_BENCH_COMMON_HPP
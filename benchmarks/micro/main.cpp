@@ -0,0 +1,527 @@
+#include "bench_common.hpp"
+
+#include <vgw/vgw.hpp>
+#include <vgw/utility.hpp>
+
+#ifdef VGW_ENABLE_TRACING
+    #include "internal/internal_trace.hpp"
+#endif
+
+#include <array>
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace
+{
+    constexpr std::uint32_t TARGET_SIZE = 64;
+
+    const std::string VERTEX_SHADER = R"(#version 450
+layout(push_constant) uniform Constants { vec4 color; } constants;
+layout(location = 0) out vec4 outColor;
+void main()
+{
+    const vec2 positions[3] = vec2[](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));
+    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
+    outColor = constants.color;
+}
+)";
+
+    const std::string FRAGMENT_SHADER = R"(#version 450
+layout(location = 0) in vec4 inColor;
+layout(location = 0) out vec4 outColor;
+void main()
+{
+    outColor = inColor;
+}
+)";
+
+    const std::string COMPUTE_SHADER = R"(#version 450
+layout(local_size_x = 64) in;
+layout(set = 0, binding = 0) buffer Data { uint values[]; } data;
+void main()
+{
+    data.values[gl_GlobalInvocationID.x] += 1u;
+}
+)";
+
+    void bench_resources(vgw_bench::BenchRunner& runner)
+    {
+        const vgw::BufferInfo bufferInfo{
+            .size = 1024,
+            .usage = vk::BufferUsageFlagBits::eUniformBuffer,
+            .memUsage = VMA_MEMORY_USAGE_AUTO,
+        };
+        runner.run("buffer_create_destroy",
+                   256,
+                   [&](std::uint32_t count)
+                   {
+                       return vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   vgw::destroy_buffer(vgw::create_buffer(bufferInfo).value());
+                               }
+                           });
+                   });
+
+        const vgw::ImageInfo imageInfo{
+            .type = vk::ImageType::e2D,
+            .width = 256,
+            .height = 256,
+            .depth = 1,
+            .mipLevels = 1,
+            .format = vk::Format::eR8G8B8A8Unorm,
+            .usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
+        };
+        runner.run("image_create_destroy",
+                   256,
+                   [&](std::uint32_t count)
+                   {
+                       return vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   vgw::destroy_image(vgw::create_image(imageInfo).value());
+                               }
+                           });
+                   });
+
+        const vgw::BufferInfo hostBufferInfo{
+            .size = 64 * 1024,
+            .usage = vk::BufferUsageFlagBits::eStorageBuffer,
+            .memUsage = VMA_MEMORY_USAGE_AUTO,
+            .allocFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+        };
+        auto hostBuffer = vgw::create_buffer(hostBufferInfo).value();
+        runner.run("map_unmap_buffer",
+                   4096,
+                   [&](std::uint32_t count)
+                   {
+                       return vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   static_cast<std::uint32_t*>(vgw::map_buffer(hostBuffer).value())[0] = i;
+                                   vgw::unmap_buffer(hostBuffer);
+                               }
+                           });
+                   });
+        vgw::destroy_buffer(hostBuffer);
+    }
+
+    // Uploads of a large texture, through a staging buffer versus written by the CPU (VK_EXT_host_image_copy).
+    void bench_image_upload(vgw_bench::BenchRunner& runner)
+    {
+        constexpr std::uint32_t TEXTURE_SIZE = 2048;
+        constexpr auto TEXTURE_FORMAT = vk::Format::eR8G8B8A8Unorm;
+        const std::vector<std::uint8_t> pixels(std::size_t(TEXTURE_SIZE) * TEXTURE_SIZE * 4, 0x7f);
+
+        const bool isHostCopySupported = vgw::is_host_image_copy_supported(TEXTURE_FORMAT);
+        runner.add_info("hostImageCopy", isHostCopySupported ? "supported" : "unsupported");
+
+        auto bench_upload = [&](std::string_view name, bool hostTransfer)
+        {
+            const vgw::ImageInfo imageInfo{
+                .type = vk::ImageType::e2D,
+                .width = TEXTURE_SIZE,
+                .height = TEXTURE_SIZE,
+                .depth = 1,
+                .mipLevels = 1,
+                .format = TEXTURE_FORMAT,
+                .usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
+                .hostTransfer = hostTransfer,
+            };
+            auto image = vgw::create_image(imageInfo).value();
+
+            vgw::ImageUploadInfo uploadInfo{
+                .image = image,
+                .pixels = pixels,
+                .regions = { vk::BufferImageCopy2(
+                    0, 0, 0, { vk::ImageAspectFlagBits::eColor, 0, 0, 1 }, {}, { TEXTURE_SIZE, TEXTURE_SIZE, 1 }) },
+            };
+            runner.run(name,
+                       4,
+                       [&](std::uint32_t count)
+                       {
+                           return vgw_bench::time_ns(
+                               [&]
+                               {
+                                   for (std::uint32_t i = 0; i < count; ++i)
+                                   {
+                                       vgw::upload_image_host(uploadInfo);
+                                   }
+                               });
+                       });
+            vgw::destroy_image(image);
+        };
+        bench_upload("upload_image_staging", false);
+        // Falls back to staging (and matches the above) when host image copy is unsupported.
+        bench_upload("upload_image_host_copy", true);
+    }
+
+    void bench_set_writes(vgw_bench::BenchRunner& runner, vk::DescriptorSetLayout setLayout, vk::Buffer buffer)
+    {
+        auto sets = vgw::allocate_sets({ .layout = setLayout, .count = 64 }).value();
+
+        vgw::SetBufferBindInfo bindInfo{
+            .binding = 0,
+            .type = vk::DescriptorType::eStorageBuffer,
+            .buffer = buffer,
+            .offset = 0,
+            .range = 256,
+        };
+        runner.run("bind_buffer_to_set_flush",
+                   1024,
+                   [&](std::uint32_t count)
+                   {
+                       return vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   bindInfo.set = sets.at(i % sets.size());
+                                   vgw::bind_buffer_to_set(bindInfo);
+                                   vgw::flush_set_writes();
+                               }
+                           });
+                   });
+
+        // Per write, when writes are batched into one flush.
+        runner.run("bind_buffer_to_set_batched_flush",
+                   64 * 16,
+                   [&](std::uint32_t count)
+                   {
+                       return vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   bindInfo.set = sets.at(i % sets.size());
+                                   vgw::bind_buffer_to_set(bindInfo);
+                                   if (i % sets.size() == sets.size() - 1)
+                                   {
+                                       vgw::flush_set_writes();
+                                   }
+                               }
+                           });
+                   });
+
+        // The set pool is not created with eFreeDescriptorSet, so the sets are released with the device.
+    }
+
+    void bench_lookups(vgw_bench::BenchRunner& runner, const vgw::SetLayoutInfo& setLayoutInfo)
+    {
+        runner.run("get_set_layout_cached",
+                   16384,
+                   [&](std::uint32_t count)
+                   {
+                       return vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   static_cast<void>(vgw::get_set_layout(setLayoutInfo));
+                               }
+                           });
+                   });
+
+        const vgw::SamplerInfo samplerInfo{};
+        runner.run("get_sampler_cached",
+                   16384,
+                   [&](std::uint32_t count)
+                   {
+                       return vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   static_cast<void>(vgw::get_sampler(samplerInfo));
+                               }
+                           });
+                   });
+    }
+
+    void bench_recording(vgw_bench::BenchRunner& runner,
+                         vgw::CommandBuffer cmd,
+                         vk::DescriptorSetLayout computeSetLayout,
+                         vk::DescriptorSet computeSet)
+    {
+        const vgw::PipelineLayoutInfo pipelineLayoutInfo{
+            .setLayouts = {},
+            .constantRange = { vk::ShaderStageFlagBits::eVertex, 0, sizeof(float) * 4 },
+        };
+        auto pipelineLayout = vgw::get_pipeline_layout(pipelineLayoutInfo).value();
+        auto vertexCode = vgw::compile_glsl(VERTEX_SHADER, vk::ShaderStageFlagBits::eVertex, false, "bench.vert").value();
+        auto fragmentCode = vgw::compile_glsl(FRAGMENT_SHADER, vk::ShaderStageFlagBits::eFragment, false, "bench.frag").value();
+        vgw::GraphicsPipelineInfo graphicsPipelineInfo{
+            .layout = pipelineLayout,
+            .vertexCode = vertexCode,
+            .fragmentCode = fragmentCode,
+            .colorAttachmentFormats = { vk::Format::eR8G8B8A8Unorm },
+            .topology = vk::PrimitiveTopology::eTriangleList,
+            .frontFace = vk::FrontFace::eClockwise,
+            .cullMode = vk::CullModeFlagBits::eNone,
+            .lineWidth = 1.0f,
+            .depthTest = false,
+            .depthWrite = false,
+            .name = "bench_graphics",
+        };
+        auto graphicsPipeline = vgw::create_graphics_pipeline(graphicsPipelineInfo).value();
+
+        const vgw::ImageInfo targetImageInfo{
+            .type = vk::ImageType::e2D,
+            .width = TARGET_SIZE,
+            .height = TARGET_SIZE,
+            .depth = 1,
+            .mipLevels = 1,
+            .format = vk::Format::eR8G8B8A8Unorm,
+            .usage = vk::ImageUsageFlagBits::eColorAttachment,
+        };
+        auto targetImage = vgw::create_image(targetImageInfo).value();
+
+        const vgw::ImageViewInfo targetViewInfo{
+            .image = targetImage,
+            .type = vk::ImageViewType::e2D,
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+        };
+        auto targetView = vgw::create_image_view(targetViewInfo).value();
+
+        const vgw::RenderPassInfo renderPassInfo{
+            .width = TARGET_SIZE,
+            .height = TARGET_SIZE,
+            .colorAttachments = { {
+                .imageView = targetView,
+                .loadOp = vk::AttachmentLoadOp::eClear,
+                .storeOp = vk::AttachmentStoreOp::eStore,
+            } },
+        };
+        auto renderPass = vgw::create_render_pass(renderPassInfo).value();
+
+        // Records `count` draws into a fresh command buffer, timing only the draw calls.
+        auto record_draws = [&](std::uint32_t count, bool setConstants)
+        {
+            cmd->reset();
+            cmd->begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+            cmd->transition_image({
+                .image = targetImage,
+                .oldLayout = vk::ImageLayout::eUndefined,
+                .newLayout = vk::ImageLayout::eColorAttachmentOptimal,
+                .srcAccess = vk::AccessFlagBits2::eNone,
+                .dstAccess = vk::AccessFlagBits2::eColorAttachmentWrite,
+                .srcStage = vk::PipelineStageFlagBits2::eTopOfPipe,
+                .dstStage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                .subresourceRange = { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 },
+            });
+            cmd->begin_pass(renderPass);
+            cmd->set_viewport(0, 0, TARGET_SIZE, TARGET_SIZE);
+            cmd->set_scissor(0, 0, TARGET_SIZE, TARGET_SIZE);
+            cmd->bind_pipeline(graphicsPipeline);
+
+            const std::array color = { 1.0f, 0.5f, 0.25f, 1.0f };
+            const auto elapsedNs = vgw_bench::time_ns(
+                [&]
+                {
+                    for (std::uint32_t i = 0; i < count; ++i)
+                    {
+                        if (setConstants)
+                        {
+                            cmd->set_constants(vk::ShaderStageFlagBits::eVertex, 0, sizeof(color), color.data());
+                        }
+                        cmd->draw(3, 1, 0, 0);
+                    }
+                });
+
+            cmd->end_pass();
+            cmd->end();
+            return elapsedNs;
+        };
+        runner.run("record_draw", 4096, [&](std::uint32_t count) { return record_draws(count, false); });
+        runner.run("record_draw_with_constants", 4096, [&](std::uint32_t count) { return record_draws(count, true); });
+
+        auto computePipelineLayout = vgw::get_pipeline_layout({ .setLayouts = { computeSetLayout }, .constantRange = {} }).value();
+        auto computeCode = vgw::compile_glsl(COMPUTE_SHADER, vk::ShaderStageFlagBits::eCompute, false, "bench.comp").value();
+        const vgw::ComputePipelineInfo computePipelineInfo{
+            .layout = computePipelineLayout,
+            .computeCode = computeCode,
+            .name = "bench_compute",
+        };
+        auto computePipeline = vgw::create_compute_pipeline(computePipelineInfo).value();
+
+        runner.run("record_dispatch",
+                   4096,
+                   [&](std::uint32_t count)
+                   {
+                       cmd->reset();
+                       cmd->begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+                       cmd->bind_pipeline(computePipeline);
+                       const auto elapsedNs = vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   cmd->bind_sets(0, { computeSet });
+                                   cmd->dispatch(1, 1, 1);
+                               }
+                           });
+                       cmd->end();
+                       return elapsedNs;
+                   });
+
+        vgw::destroy_render_pass(renderPass);
+        vgw::destroy_image_view(targetView);
+        vgw::destroy_image(targetImage);
+    }
+
+    void bench_submit(vgw_bench::BenchRunner& runner, vgw::CommandBuffer cmd)
+    {
+        cmd->reset();
+        cmd->begin({});
+        cmd->end();
+
+        auto fence = vgw::create_fence({}).value();
+        const vgw::SubmitInfo submitInfo{
+            .queueIndex = 0,
+            .cmdBuffers = { *cmd },
+            .signalFence = fence,
+        };
+
+        // Submit call only; waiting for the GPU is not timed.
+        runner.run("submit",
+                   256,
+                   [&](std::uint32_t count)
+                   {
+                       std::uint64_t elapsedNs = 0;
+                       for (std::uint32_t i = 0; i < count; ++i)
+                       {
+                           elapsedNs += vgw_bench::time_ns([&] { vgw::submit(submitInfo); });
+                           vgw::wait_on_fence(fence);
+                           vgw::reset_fence(fence);
+                       }
+                       return elapsedNs;
+                   });
+
+        // Submit of an empty command buffer until its fence is signalled.
+        runner.run("submit_wait_roundtrip",
+                   256,
+                   [&](std::uint32_t count)
+                   {
+                       return vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   vgw::submit(submitInfo);
+                                   vgw::wait_on_fence(fence);
+                                   vgw::reset_fence(fence);
+                               }
+                           });
+                   });
+
+        vgw::destroy_fence(fence);
+    }
+
+    // Cost of one `VGW_TRACE_SCOPE`, which every public function records when built with VGW_ENABLE_TRACING.
+    void bench_trace_scope([[maybe_unused]] vgw_bench::BenchRunner& runner)
+    {
+#ifdef VGW_ENABLE_TRACING
+        runner.run("trace_scope",
+                   16384,
+                   [&](std::uint32_t count)
+                   {
+                       return vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   VGW_TRACE_SCOPE("bench_trace_scope");
+                               }
+                           });
+                   });
+        vgw::clear_trace();
+#endif
+    }
+
+    void bench_compile(vgw_bench::BenchRunner& runner)
+    {
+        runner.run("compile_glsl",
+                   8,
+                   [&](std::uint32_t count)
+                   {
+                       return vgw_bench::time_ns(
+                           [&]
+                           {
+                               for (std::uint32_t i = 0; i < count; ++i)
+                               {
+                                   const auto compileResult =
+                                       vgw::compile_glsl(COMPUTE_SHADER, vk::ShaderStageFlagBits::eCompute, false, "bench.comp");
+                                   static_cast<void>(compileResult);
+                               }
+                           });
+                   });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    vgw_bench::BenchOptions options{};
+    if (!vgw_bench::parse_options(argc, argv, options))
+    {
+        return 1;
+    }
+
+    if (!vgw_bench::initialise_headless(128, { { vk::DescriptorType::eStorageBuffer, 128 } }))
+    {
+        return 1;
+    }
+
+    vgw_bench::BenchRunner runner(options);
+
+    const vgw::SetLayoutInfo setLayoutInfo{
+        .bindings = {
+            { 0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute },
+        },
+    };
+    auto setLayout = vgw::get_set_layout(setLayoutInfo).value();
+
+    const vgw::BufferInfo storageBufferInfo{
+        .size = 64 * 1024,
+        .usage = vk::BufferUsageFlagBits::eStorageBuffer,
+        .memUsage = VMA_MEMORY_USAGE_AUTO,
+    };
+    auto storageBuffer = vgw::create_buffer(storageBufferInfo).value();
+    auto computeSet = vgw::allocate_sets({ .layout = setLayout, .count = 1 }).value()[0];
+    vgw::bind_buffer_to_set({
+        .set = computeSet,
+        .binding = 0,
+        .type = vk::DescriptorType::eStorageBuffer,
+        .buffer = storageBuffer,
+        .offset = 0,
+        .range = storageBufferInfo.size,
+    });
+    vgw::flush_set_writes();
+
+    vgw::CmdBufferAllocInfo cmdAllocInfo{
+        1,
+        vk::CommandBufferLevel::ePrimary,
+        vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+    };
+    vgw::CommandBuffer cmd = vgw::allocate_command_buffers(cmdAllocInfo).value()[0];
+
+    bench_resources(runner);
+    bench_image_upload(runner);
+    bench_set_writes(runner, setLayout, storageBuffer);
+    bench_lookups(runner, setLayoutInfo);
+    bench_recording(runner, cmd, setLayout, computeSet);
+    bench_submit(runner, cmd);
+    bench_trace_scope(runner);
+    bench_compile(runner);
+
+    vgw::destroy_buffer(storageBuffer);
+    vgw_bench::destroy_headless();
+
+    return runner.write_json("vgw_bench") ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""Runs the vgw benchmark executables several times and compares them against a checked-in baseline.
+
+Each benchmark executable writes JSON results (see benchmarks/common/bench_common.hpp). For every metric the per-run medians are
+combined into a median across runs, with the median absolute deviation (relative to the median) as the dispersion. A metric
+regresses when its median exceeds the baseline by more than its tolerance; all metrics are lower-is-better.
+
+    run_regression.py --bench build/benchmarks/micro/vgw_bench --bench build/benchmarks/scene/vgw_bench_scene --lavapipe
+
+Use --update-baseline on the reference machine to record new baseline values (the tolerances are kept). With --strict, metrics
+that have no baseline value (NEW) or are no longer produced (MISSING) also fail, so an empty or stale baseline cannot pass.
+Exits with 1 on regression (or unmatched metrics in strict mode), 2 if a benchmark fails to run.
+"""
+
+import argparse
+import glob
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+
+DEFAULT_BASELINE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "baseline.json")
+LAVAPIPE_ICD_GLOBS = ["/usr/share/vulkan/icd.d/lvp_icd*.json", "/usr/local/share/vulkan/icd.d/lvp_icd*.json"]
+
+
+def find_lavapipe_icd():
+    for pattern in LAVAPIPE_ICD_GLOBS:
+        matches = sorted(glob.glob(pattern))
+        if matches:
+            return matches[0]
+    return None
+
+
+def run_benchmark(executable, repetitions, env):
+    """Runs the executable once, returning its parsed JSON results."""
+    with tempfile.TemporaryDirectory() as tempDir:
+        outputFilename = os.path.join(tempDir, "results.json")
+        command = [os.path.abspath(executable), "--output", outputFilename]
+        if repetitions is not None:
+            command += ["--repetitions", str(repetitions)]
+        # Benchmarks load their assets relative to the executable.
+        process = subprocess.run(command, cwd=os.path.dirname(os.path.abspath(executable)), env=env,
+                                 stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+        if process.returncode != 0:
+            raise RuntimeError(f"{executable} exited with {process.returncode}:\n{process.stderr}")
+        with open(outputFilename, "r", encoding="utf-8") as fileIn:
+            return json.load(fileIn)
+
+
+def collect_metrics(executables, runs, repetitions, env):
+    """Returns {"benchmark/metric": {"unit", "medians"}} with one median per run."""
+    metrics = {}
+    for executable in executables:
+        for run in range(runs):
+            print(f"Running {os.path.basename(executable)} ({run + 1}/{runs})...", file=sys.stderr)
+            results = run_benchmark(executable, repetitions, env)
+            for result in results["results"]:
+                key = f"{results['benchmark']}/{result['name']}"
+                metric = metrics.setdefault(key, {"unit": result["unit"], "medians": []})
+                metric["medians"].append(result["median"])
+    return metrics
+
+
+def summarise(medians):
+    median = statistics.median(medians)
+    mad = statistics.median(abs(value - median) for value in medians)
+    return median, (mad / median if median > 0 else 0.0)
+
+
+def load_baseline(filename):
+    if not os.path.exists(filename):
+        return {"defaultTolerance": 0.1, "tolerances": {}, "metrics": {}}
+    with open(filename, "r", encoding="utf-8") as fileIn:
+        baseline = json.load(fileIn)
+    baseline.setdefault("defaultTolerance", 0.1)
+    baseline.setdefault("tolerances", {})
+    baseline.setdefault("metrics", {})
+    return baseline
+
+
+def compare(metrics, baseline):
+    """Prints a table of the differences and returns the number of regressed metrics and of metrics without a match."""
+    rows = []
+    regressions = 0
+    unmatched = 0
+    for key in sorted(metrics):
+        median, dispersion = summarise(metrics[key]["medians"])
+        unit = metrics[key]["unit"]
+        tolerance = baseline["tolerances"].get(key, baseline["defaultTolerance"])
+        reference = baseline["metrics"].get(key)
+        if reference is None:
+            rows.append((key, "-", f"{median:.3f}", unit, "-", f"{dispersion * 100:.1f}%", f"{tolerance * 100:.0f}%", "NEW"))
+            unmatched += 1
+            continue
+
+        baselineMedian = reference["median"]
+        change = (median - baselineMedian) / baselineMedian if baselineMedian > 0 else 0.0
+        if change > tolerance:
+            status = "REGRESSED"
+            regressions += 1
+        elif change < -tolerance:
+            status = "improved"
+        else:
+            status = "ok"
+        # Results are unreliable when the runs disagree by about as much as the tolerance.
+        if dispersion > tolerance / 2:
+            status += " (noisy)"
+        rows.append((key, f"{baselineMedian:.3f}", f"{median:.3f}", unit, f"{change * 100:+.1f}%", f"{dispersion * 100:.1f}%",
+                     f"{tolerance * 100:.0f}%", status))
+
+    for key in sorted(set(baseline["metrics"]) - set(metrics)):
+        rows.append((key, f"{baseline['metrics'][key]['median']:.3f}", "-", baseline["metrics"][key].get("unit", ""), "-", "-", "-",
+                     "MISSING"))
+        unmatched += 1
+
+    header = ("metric", "baseline", "current", "unit", "change", "mad", "tolerance", "status")
+    widths = [max(len(str(row[i])) for row in [header] + rows) for i in range(len(header))]
+    for row in [header] + rows:
+        print("  ".join(str(cell).ljust(width) for cell, width in zip(row, widths)).rstrip())
+    return regressions, unmatched
+
+
+def update_baseline(metrics, baseline, filename):
+    baseline["metrics"] = {}
+    for key in sorted(metrics):
+        median, dispersion = summarise(metrics[key]["medians"])
+        baseline["metrics"][key] = {"median": round(median, 3), "unit": metrics[key]["unit"], "mad": round(dispersion, 4)}
+    with open(filename, "w", encoding="utf-8") as fileOut:
+        json.dump(baseline, fileOut, indent=2, sort_keys=True)
+        fileOut.write("\n")
+    print(f"Wrote {len(metrics)} metrics to {filename}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare vgw benchmark results against a baseline.")
+    parser.add_argument("--bench", action="append", required=True, help="Benchmark executable (can be repeated).")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE, help="Baseline JSON file.")
+    parser.add_argument("--runs", type=int, default=5, help="Number of times each benchmark is run.")
+    parser.add_argument("--repetitions", type=int, help="Passed to the benchmarks as --repetitions.")
+    parser.add_argument("--lavapipe", action="store_true", help="Force the lavapipe software driver (VK_ICD_FILENAMES).")
+    parser.add_argument("--update-baseline", action="store_true", help="Write the results as the new baseline.")
+    parser.add_argument("--strict", action="store_true", help="Fail when a metric has no baseline or a baseline metric is missing.")
+    args = parser.parse_args()
+
+    env = dict(os.environ)
+    if args.lavapipe:
+        icd = find_lavapipe_icd()
+        if icd is None:
+            print("Could not find the lavapipe ICD (is mesa-vulkan-drivers installed?)", file=sys.stderr)
+            return 2
+        env["VK_ICD_FILENAMES"] = icd
+
+    try:
+        metrics = collect_metrics(args.bench, max(1, args.runs), args.repetitions, env)
+    except (RuntimeError, OSError, ValueError, KeyError) as error:
+        print(error, file=sys.stderr)
+        return 2
+
+    baseline = load_baseline(args.baseline)
+    if args.update_baseline:
+        update_baseline(metrics, baseline, args.baseline)
+        return 0
+
+    regressions, unmatched = compare(metrics, baseline)
+    if regressions > 0:
+        print(f"\n{regressions} metric(s) regressed beyond their tolerance.")
+        return 1
+    if unmatched > 0 and args.strict:
+        print(f"\n{unmatched} metric(s) have no baseline to compare against. Record one with --update-baseline.")
+        return 1
+    if unmatched > 0:
+        print(f"\nNo regressions, but {unmatched} metric(s) were not compared.")
+        return 0
+    print("\nNo regressions.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,524 @@
+/**
+ * Headless variant of examples/scene_render: renders the viking_room scene into an offscreen target for a number of frames and
+ * reports CPU record/submit times and GPU frame times. Each frame waits for the previous one, so the timings are per frame in
+ * isolation rather than pipelined throughput. The output includes a checksum of the final image, so rendering changes can be spotted.
+ * Run from the build directory (the scene assets are copied next to the executable).
+ */
+
+#include "bench_common.hpp"
+
+#include <vgw/vgw.hpp>
+#include <vgw/utility.hpp>
+
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_LEFT_HANDED
+#include <glm/glm.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/ext/matrix_clip_space.hpp>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <cmath>
+#include <format>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+
+namespace
+{
+    constexpr std::uint32_t TARGET_WIDTH = 800;
+    constexpr std::uint32_t TARGET_HEIGHT = 600;
+    constexpr vk::Format COLOR_FORMAT = vk::Format::eR8G8B8A8Unorm;
+    constexpr vk::Format DEPTH_FORMAT = vk::Format::eD16Unorm;
+
+    struct Vertex
+    {
+        glm::vec3 pos;
+        glm::vec3 normal;
+        glm::vec2 texCoord;
+    };
+
+    struct Mesh
+    {
+        vk::Buffer vertexBuffer{};
+        vk::Buffer indexBuffer{};
+        std::uint32_t indexCount{};
+    };
+
+    struct Texture
+    {
+        vk::Image image{};
+        vk::ImageView view{};
+    };
+
+    struct UniformData
+    {
+        glm::mat4 projMatrix{ 1.0f };
+        glm::mat4 viewMatrix{ 1.0f };
+    };
+    struct PushConstants
+    {
+        glm::mat4 worldMatrix{ 1.0f };
+    };
+
+    auto read_file(const std::string& filename) -> std::optional<std::string>
+    {
+        auto fileIn = std::ifstream(filename, std::ios::in | std::ios::binary);
+        if (!fileIn.is_open())
+        {
+            return std::nullopt;
+        }
+
+        std::string buffer;
+        fileIn.seekg(0, std::ios::end);
+        buffer.resize(fileIn.tellg());
+        fileIn.seekg(0, std::ios::beg);
+        fileIn.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        return buffer;
+    }
+
+    bool read_obj_model(const std::string& filename, std::vector<Vertex>& outVertices, std::vector<std::uint32_t>& outTriangles)
+    {
+        tinyobj::ObjReaderConfig readerConfig{};
+        readerConfig.triangulate = true;
+        tinyobj::ObjReader reader{};
+        if (!reader.ParseFromFile(filename, readerConfig))
+        {
+            std::cerr << reader.Error() << std::endl;
+            return false;
+        }
+
+        const auto& attrib = reader.GetAttrib();
+        for (const auto& shape : reader.GetShapes())
+        {
+            for (const auto& idx : shape.mesh.indices)
+            {
+                outTriangles.push_back(std::uint32_t(outVertices.size()));
+                auto& vertex = outVertices.emplace_back();
+                vertex.pos = { attrib.vertices[3 * idx.vertex_index + 0],
+                               attrib.vertices[3 * idx.vertex_index + 1],
+                               attrib.vertices[3 * idx.vertex_index + 2] };
+                if (idx.normal_index >= 0)
+                {
+                    vertex.normal = { attrib.normals[3 * idx.normal_index + 0],
+                                      attrib.normals[3 * idx.normal_index + 1],
+                                      attrib.normals[3 * idx.normal_index + 2] };
+                }
+                if (idx.texcoord_index >= 0)
+                {
+                    vertex.texCoord = { attrib.texcoords[2 * idx.texcoord_index + 0], attrib.texcoords[2 * idx.texcoord_index + 1] };
+                }
+            }
+        }
+        return true;
+    }
+
+    auto create_host_buffer(std::size_t size, vk::BufferUsageFlags usage, const void* data) -> vk::Buffer
+    {
+        vgw::BufferInfo bufferInfo{
+            .size = size,
+            .usage = usage,
+            .memUsage = VMA_MEMORY_USAGE_AUTO,
+            .allocFlags = data != nullptr ? VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+                                          : VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
+        };
+        auto buffer = vgw::create_buffer(bufferInfo).value();
+        if (data != nullptr)
+        {
+            std::memcpy(vgw::map_buffer(buffer).value(), data, size);
+            vgw::unmap_buffer(buffer);
+        }
+        return buffer;
+    }
+
+    void submit_and_wait(vgw::CommandBuffer cmd, vk::Fence fence)
+    {
+        vgw::SubmitInfo submitInfo{
+            .queueIndex = 0,
+            .cmdBuffers = { *cmd },
+            .signalFence = fence,
+        };
+        vgw::submit(submitInfo);
+        vgw::wait_on_fence(fence);
+        vgw::reset_fence(fence);
+    }
+
+    auto create_texture(const std::string& filename, vgw::CommandBuffer cmd, vk::Fence fence) -> std::optional<Texture>
+    {
+        int width{};
+        int height{};
+        int comp{};
+        stbi_set_flip_vertically_on_load(true);
+        auto* pixels = stbi_load(filename.c_str(), &width, &height, &comp, 4);
+        if (pixels == nullptr)
+        {
+            return std::nullopt;
+        }
+        auto stagingBuffer = create_host_buffer(std::size_t(width) * height * 4, vk::BufferUsageFlagBits::eTransferSrc, pixels);
+        stbi_image_free(pixels);
+
+        vgw::ImageInfo imageInfo{
+            .type = vk::ImageType::e2D,
+            .width = std::uint32_t(width),
+            .height = std::uint32_t(height),
+            .depth = 1,
+            .mipLevels = 1,
+            .format = vk::Format::eR8G8B8A8Srgb,
+            .usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
+        };
+        auto image = vgw::create_image(imageInfo).value();
+
+        vgw::ImageViewInfo viewInfo{
+            .image = image,
+            .type = vk::ImageViewType::e2D,
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+        };
+        auto view = vgw::create_image_view(viewInfo).value();
+
+        vgw::CopyBufferToImageInfo copyInfo{
+            .srcBuffer = stagingBuffer,
+            .dstImage = image,
+            .dstImageLayout = vk::ImageLayout::eTransferDstOptimal,
+            .regions = { { 0, 0, 0, { vk::ImageAspectFlagBits::eColor, 0, 0, 1 }, { 0, 0, 0 }, { imageInfo.width, imageInfo.height, 1 } } },
+        };
+
+        cmd->reset();
+        cmd->begin({});
+        cmd->require_image_state(
+            image, vk::ImageLayout::eTransferDstOptimal, vk::AccessFlagBits2::eTransferWrite, vk::PipelineStageFlagBits2::eTransfer);
+        cmd->copy_buffer_to_image(copyInfo);
+        cmd->require_image_state(
+            image, vk::ImageLayout::eShaderReadOnlyOptimal, vk::AccessFlagBits2::eShaderRead, vk::PipelineStageFlagBits2::eFragmentShader);
+        cmd->end();
+        submit_and_wait(cmd, fence);
+
+        vgw::destroy_buffer(stagingBuffer);
+        return Texture{ image, view };
+    }
+
+    auto create_attachment(vk::Format format, vk::ImageUsageFlags usage, vk::ImageAspectFlags aspectMask) -> Texture
+    {
+        vgw::ImageInfo imageInfo{
+            .type = vk::ImageType::e2D,
+            .width = TARGET_WIDTH,
+            .height = TARGET_HEIGHT,
+            .depth = 1,
+            .mipLevels = 1,
+            .format = format,
+            .usage = usage,
+        };
+        auto image = vgw::create_image(imageInfo).value();
+
+        vgw::ImageViewInfo viewInfo{
+            .image = image,
+            .type = vk::ImageViewType::e2D,
+            .aspectMask = aspectMask,
+        };
+        return { image, vgw::create_image_view(viewInfo).value() };
+    }
+
+    auto create_geometry_pipeline(vk::PipelineLayout layout) -> std::optional<vk::Pipeline>
+    {
+        auto vertexCode = read_file("geometry.vert");
+        auto fragmentCode = read_file("geometry.frag");
+        if (!vertexCode || !fragmentCode)
+        {
+            return std::nullopt;
+        }
+
+        vgw::GraphicsPipelineInfo graphicsPipelineInfo{
+            .layout = layout,
+            .vertexCode = vgw::compile_glsl(vertexCode.value(), vk::ShaderStageFlagBits::eVertex, false, "geometry.vert").value(),
+            .fragmentCode = vgw::compile_glsl(fragmentCode.value(), vk::ShaderStageFlagBits::eFragment, false, "geometry.frag").value(),
+            .inputBindings = {
+                { 0, sizeof(Vertex), vk::VertexInputRate::eVertex },
+            },
+            .inputAttributes = {
+                { 0, 0, vk::Format::eR32G32B32Sfloat, std::uint32_t(offsetof(Vertex, pos)) },
+                { 1, 0, vk::Format::eR32G32B32Sfloat, std::uint32_t(offsetof(Vertex, normal)) },
+                { 2, 0, vk::Format::eR32G32Sfloat, std::uint32_t(offsetof(Vertex, texCoord)) },
+            },
+            .colorAttachmentFormats = { COLOR_FORMAT },
+            .depthStencilAttachmentFormat = DEPTH_FORMAT,
+            .topology = vk::PrimitiveTopology::eTriangleList,
+            .frontFace = vk::FrontFace::eClockwise,
+            .cullMode = vk::CullModeFlagBits::eBack,
+            .lineWidth = 1.0f,
+            .depthTest = true,
+            .depthWrite = true,
+            .name = "scene_geometry",
+        };
+        return vgw::create_graphics_pipeline(graphicsPipelineInfo).value();
+    }
+
+    // Instances are laid out on a square grid, scaled to fit the same space as the single model.
+    auto make_instance_matrices(std::uint32_t instanceCount) -> std::vector<PushConstants>
+    {
+        const auto gridSize = std::uint32_t(std::ceil(std::sqrt(float(instanceCount))));
+        const float scale = 1.0f / float(gridSize);
+
+        std::vector<PushConstants> instances(instanceCount);
+        for (std::uint32_t i = 0; i < instanceCount; ++i)
+        {
+            const float x = (float(i % gridSize) + 0.5f) * scale - 0.5f;
+            const float z = (float(i / gridSize) + 0.5f) * scale - 0.5f;
+            instances[i].worldMatrix = glm::scale(glm::translate(glm::mat4(1.0f), { x, 0.0f, z }), glm::vec3(scale));
+        }
+        return instances;
+    }
+
+    // FNV-1a over the rendered pixels.
+    auto hash_bytes(const std::uint8_t* data, std::size_t size) -> std::uint64_t
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ data[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::uint32_t frameCount = 200;
+    std::uint32_t instanceCount = 16;
+
+    vgw_bench::BenchOptions options{};
+    if (!vgw_bench::parse_options(argc, argv, options, { { "--frames", &frameCount }, { "--instances", &instanceCount } }))
+    {
+        return 1;
+    }
+
+    if (!vgw_bench::initialise_headless(1,
+                                        {
+                                            { vk::DescriptorType::eUniformBuffer, 1 },
+                                            { vk::DescriptorType::eCombinedImageSampler, 1 },
+                                        }))
+    {
+        return 1;
+    }
+
+    vgw::CmdBufferAllocInfo cmdAllocInfo{
+        1,
+        vk::CommandBufferLevel::ePrimary,
+        vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+    };
+    vgw::CommandBuffer cmd = vgw::allocate_command_buffers(cmdAllocInfo).value()[0];
+    auto fence = vgw::create_fence({}).value();
+
+    vgw::SetLayoutInfo setLayoutInfo{
+        .bindings = {
+            { 0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex },
+            { 1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment },
+        },
+    };
+    auto setLayout = vgw::get_set_layout(setLayoutInfo).value();
+
+    vgw::PipelineLayoutInfo pipelineLayoutInfo{
+        .setLayouts = { setLayout },
+        .constantRange = { vk::ShaderStageFlagBits::eVertex, 0, sizeof(PushConstants) },
+    };
+    auto pipelineLayout = vgw::get_pipeline_layout(pipelineLayoutInfo).value();
+
+    auto geometryPipeline = create_geometry_pipeline(pipelineLayout);
+    if (!geometryPipeline)
+    {
+        std::cerr << "Failed to create geometry pipeline!" << std::endl;
+        return 1;
+    }
+
+    std::vector<Vertex> vertices{};
+    std::vector<std::uint32_t> triangles{};
+    if (!read_obj_model("viking_room.obj", vertices, triangles))
+    {
+        std::cerr << "Failed to load OBJ model!" << std::endl;
+        return 1;
+    }
+    const Mesh mesh{
+        create_host_buffer(sizeof(Vertex) * vertices.size(), vk::BufferUsageFlagBits::eVertexBuffer, vertices.data()),
+        create_host_buffer(sizeof(std::uint32_t) * triangles.size(), vk::BufferUsageFlagBits::eIndexBuffer, triangles.data()),
+        std::uint32_t(triangles.size()),
+    };
+
+    auto texture = create_texture("viking_room.png", cmd, fence);
+    if (!texture)
+    {
+        std::cerr << "Failed to load image!" << std::endl;
+        return 1;
+    }
+
+    const UniformData uniformData{
+        .projMatrix = glm::perspective(glm::radians(70.0f), float(TARGET_WIDTH) / float(TARGET_HEIGHT), 0.1f, 100.0f),
+        .viewMatrix = glm::lookAt(glm::vec3(-1.0f, 1.0f, -0.5f), glm::vec3(0.0f, 0.2f, 0.1f), glm::vec3(0.0f, 1.0f, 0.0f)),
+    };
+    auto uniformBuffer = create_host_buffer(sizeof(UniformData), vk::BufferUsageFlagBits::eUniformBuffer, &uniformData);
+
+    auto set = vgw::allocate_sets({ .layout = setLayout, .count = 1 }).value()[0];
+    vgw::bind_buffer_to_set({
+        .set = set,
+        .binding = 0,
+        .type = vk::DescriptorType::eUniformBuffer,
+        .buffer = uniformBuffer,
+        .offset = 0,
+        .range = sizeof(UniformData),
+    });
+    vgw::bind_image_to_set({
+        .set = set,
+        .binding = 1,
+        .type = vk::DescriptorType::eCombinedImageSampler,
+        .sampler = vgw::get_sampler({}).value(),
+        .imageView = texture->view,
+        .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+    });
+    vgw::flush_set_writes();
+
+    const auto colorAttachment = create_attachment(
+        COLOR_FORMAT, vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc, vk::ImageAspectFlagBits::eColor);
+    const auto depthAttachment =
+        create_attachment(DEPTH_FORMAT, vk::ImageUsageFlagBits::eDepthStencilAttachment, vk::ImageAspectFlagBits::eDepth);
+
+    vgw::RenderPassInfo renderPassInfo{
+        .width = TARGET_WIDTH,
+        .height = TARGET_HEIGHT,
+        .colorAttachments = { {
+            .imageView = colorAttachment.view,
+            .loadOp = vk::AttachmentLoadOp::eClear,
+            .storeOp = vk::AttachmentStoreOp::eStore,
+            .clearColor = { 0.045f, 0.03f, 0.05f, 1.0f },
+        } },
+        .depthAttachment = {
+            .imageView = depthAttachment.view,
+            .loadOp = vk::AttachmentLoadOp::eClear,
+            .storeOp = vk::AttachmentStoreOp::eDontCare,
+        },
+    };
+    auto renderPass = vgw::create_render_pass(renderPassInfo).value();
+
+    const auto instances = make_instance_matrices(instanceCount);
+
+    vgw::initialise_gpu_profiler({ .frameCount = 1 });
+
+    std::vector<double> recordMs{};
+    std::vector<double> submitMs{};
+    std::vector<double> gpuFrameMs{};
+    std::vector<double> frameMs{};
+
+    // Reports are only collected once per resolved frame.
+    std::optional<std::uint64_t> lastReportedFrame{};
+    auto collect_gpu_frame = [&]
+    {
+        auto report = vgw::get_gpu_frame_report();
+        if (report && report->frameNumber != lastReportedFrame)
+        {
+            gpuFrameMs.push_back(report->frameMs);
+            lastReportedFrame = report->frameNumber;
+        }
+    };
+
+    for (std::uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        // The previous frame has completed, so this resolves its GPU timings.
+        vgw::begin_gpu_profiler_frame();
+        collect_gpu_frame();
+
+        const auto frameStartNs = vgw_bench::now_ns();
+
+        cmd->reset();
+        cmd->begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        cmd->begin_gpu_scope("Frame");
+        cmd->require_image_state(colorAttachment.image,
+                                 vk::ImageLayout::eColorAttachmentOptimal,
+                                 vk::AccessFlagBits2::eColorAttachmentWrite,
+                                 vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+        cmd->require_image_state(depthAttachment.image,
+                                 vk::ImageLayout::eDepthStencilAttachmentOptimal,
+                                 vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                                 vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests);
+
+        cmd->begin_pass(renderPass);
+        cmd->set_viewport(0, TARGET_HEIGHT, TARGET_WIDTH, -float(TARGET_HEIGHT));
+        cmd->set_scissor(0, 0, TARGET_WIDTH, TARGET_HEIGHT);
+        cmd->bind_pipeline(geometryPipeline.value());
+        cmd->bind_sets(0, { set });
+        cmd->bind_vertex_buffer(mesh.vertexBuffer);
+        cmd->bind_index_buffer(mesh.indexBuffer, vk::IndexType::eUint32);
+        for (const auto& instance : instances)
+        {
+            cmd->set_constants(vk::ShaderStageFlagBits::eVertex, 0, sizeof(PushConstants), &instance);
+            cmd->draw_indexed(mesh.indexCount, 1, 0, 0, 0);
+        }
+        cmd->end_pass();
+        cmd->end_gpu_scope();
+        cmd->end();
+
+        const auto recordEndNs = vgw_bench::now_ns();
+        vgw::SubmitInfo submitInfo{
+            .queueIndex = 0,
+            .cmdBuffers = { *cmd },
+            .signalFence = fence,
+        };
+        vgw::submit(submitInfo);
+        const auto submitEndNs = vgw_bench::now_ns();
+
+        vgw::wait_on_fence(fence);
+        vgw::reset_fence(fence);
+        const auto frameEndNs = vgw_bench::now_ns();
+
+        recordMs.push_back(double(recordEndNs - frameStartNs) / 1e6);
+        submitMs.push_back(double(submitEndNs - recordEndNs) / 1e6);
+        frameMs.push_back(double(frameEndNs - frameStartNs) / 1e6);
+    }
+    vgw::begin_gpu_profiler_frame();
+    collect_gpu_frame();
+    vgw::destroy_gpu_profiler();
+
+    // Read back the last frame.
+    const std::size_t readbackSize = std::size_t(TARGET_WIDTH) * TARGET_HEIGHT * 4;
+    auto readbackBuffer = create_host_buffer(readbackSize, vk::BufferUsageFlagBits::eTransferDst, nullptr);
+    vgw::CopyImageToBufferInfo copyInfo{
+        .srcImage = colorAttachment.image,
+        .srcImageLayout = vk::ImageLayout::eTransferSrcOptimal,
+        .dstBuffer = readbackBuffer,
+        .regions = { { 0, 0, 0, { vk::ImageAspectFlagBits::eColor, 0, 0, 1 }, { 0, 0, 0 }, { TARGET_WIDTH, TARGET_HEIGHT, 1 } } },
+    };
+    cmd->reset();
+    cmd->begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    cmd->require_image_state(colorAttachment.image,
+                             vk::ImageLayout::eTransferSrcOptimal,
+                             vk::AccessFlagBits2::eTransferRead,
+                             vk::PipelineStageFlagBits2::eTransfer);
+    cmd->copy_image_to_buffer(copyInfo);
+    cmd->buffer_barrier({
+        .buffer = readbackBuffer,
+        .srcAccess = vk::AccessFlagBits2::eTransferWrite,
+        .dstAccess = vk::AccessFlagBits2::eHostRead,
+        .srcStage = vk::PipelineStageFlagBits2::eTransfer,
+        .dstStage = vk::PipelineStageFlagBits2::eHost,
+    });
+    cmd->end();
+    submit_and_wait(cmd, fence);
+
+    const auto* pixels = static_cast<const std::uint8_t*>(vgw::map_buffer(readbackBuffer).value());
+    const auto checksum = hash_bytes(pixels, readbackSize);
+    vgw::unmap_buffer(readbackBuffer);
+
+    vgw_bench::BenchRunner runner(options);
+    runner.add_info("frames", std::to_string(frameCount));
+    runner.add_info("instances", std::to_string(instanceCount));
+    runner.add_info("resolution", std::format("{}x{}", TARGET_WIDTH, TARGET_HEIGHT));
+    runner.add_info("checksum", std::format("{:016x}", checksum));
+    runner.add_result(vgw_bench::make_result("cpu_record", "ms", 1, std::move(recordMs)));
+    runner.add_result(vgw_bench::make_result("cpu_submit", "ms", 1, std::move(submitMs)));
+    runner.add_result(vgw_bench::make_result("gpu_frame", "ms", 1, std::move(gpuFrameMs)));
+    runner.add_result(vgw_bench::make_result("frame_roundtrip", "ms", 1, std::move(frameMs)));
+
+    vgw_bench::destroy_headless();
+
+    return runner.write_json("vgw_bench_scene") ? 0 : 1;
+}
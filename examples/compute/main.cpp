@@ -131,11 +131,13 @@ int main(int argc, char** argv)
         .buffer = inBuffer,
         .offset = 0,
         .range = inBufferInfo.size,
+        .readOnly = true,
     };
     vgw::bind_buffer_to_set(bufferBindInfo);
 
     bufferBindInfo.binding = 1;
     bufferBindInfo.buffer = outBuffer;
+    bufferBindInfo.readOnly = false;
     vgw::bind_buffer_to_set(bufferBindInfo);
 
     vgw::flush_set_writes();
@@ -147,11 +149,27 @@ int main(int argc, char** argv)
     };
     vgw::CommandBuffer mainCmd = vgw::allocate_command_buffers(cmdAllocInfo).value()[0];
 
+    auto statisticsQuery = vgw::create_query(vgw::QueryType::ePipelineStatistics).value();
+
+    vgw::initialise_gpu_profiler({ .frameCount = 1 });
+    vgw::begin_gpu_profiler_frame();
+
     vk::CommandBufferBeginInfo beginInfo{};
     mainCmd->begin(beginInfo);
+    mainCmd->begin_gpu_scope("Compute");
     mainCmd->bind_pipeline(computePipeline);
     mainCmd->bind_sets(0, { descriptorSet });
+    mainCmd->begin_query(statisticsQuery);
     mainCmd->dispatch(NumElements, 1, 1);
+    mainCmd->end_query(statisticsQuery);
+    mainCmd->end_gpu_scope();
+    mainCmd->buffer_barrier({
+        .buffer = outBuffer,
+        .srcAccess = vk::AccessFlagBits2::eShaderStorageWrite,
+        .dstAccess = vk::AccessFlagBits2::eHostRead,
+        .srcStage = vk::PipelineStageFlagBits2::eComputeShader,
+        .dstStage = vk::PipelineStageFlagBits2::eHost,
+    });
     mainCmd->end();
 
     auto fence = vgw::create_fence({}).value();
@@ -180,6 +198,18 @@ int main(int argc, char** argv)
     vgw::unmap_buffer(outBuffer);
     std::cout << "\n";
 
+    // Starting the next profiler frame resolves the finished one.
+    vgw::begin_gpu_profiler_frame();
+    if (auto report = vgw::get_gpu_frame_report())
+    {
+        std::cout << vgw::format_gpu_frame_report(report.value());
+    }
+    if (auto statistics = vgw::get_pipeline_statistics(statisticsQuery))
+    {
+        std::cout << "Compute shader invocations: " << statistics->computeShaderInvocations << "\n";
+    }
+    vgw::destroy_query(statisticsQuery);
+
     vgw::destroy_device();
     vgw::destroy_context();
 
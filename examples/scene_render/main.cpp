@@ -2,6 +2,7 @@
 
 #include <vgw/vgw.hpp>
 #include <vgw/utility.hpp>
+#include <vgw/mesh_pool.hpp>
 
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
@@ -67,11 +68,11 @@ struct Vertex
 
 bool read_obj_model(const std::string& filename, std::vector<Vertex>& outVertices, std::vector<std::uint32_t>& outTriangles);
 
+vgw::MeshPool meshPool{};
+
 struct Mesh
 {
-    vk::Buffer vertexBuffer{};
-    vk::Buffer indexBuffer{};
-    std::uint64_t indexCount{};
+    vgw::MeshAllocation allocation{};
 };
 auto create_mesh(const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& indices) -> Mesh;
 
@@ -177,6 +178,7 @@ int main(int argc, char** argv)
     {
         throw std::runtime_error("Failed to load OBJ model!");
     }
+    meshPool.initialise({ .vertexStride = sizeof(Vertex) });
     auto mesh = create_mesh(vertices, triangles);
 
     vgw::CmdBufferAllocInfo cmdAllocInfo{
@@ -290,17 +292,14 @@ int main(int argc, char** argv)
         cmd->reset();
         vk::CommandBufferBeginInfo beginInfo{};
         cmd->begin(beginInfo);
-        vgw::ImageTransitionInfo attachmentTransition{
-            .image = swapchainImages.at(imageIndex),
-            .oldLayout = vk::ImageLayout::eUndefined,
-            .newLayout = vk::ImageLayout::eColorAttachmentOptimal,
-            .srcAccess = vk::AccessFlagBits2::eNone,
-            .dstAccess = vk::AccessFlagBits2::eColorAttachmentWrite,
-            .srcStage = vk::PipelineStageFlagBits2::eTopOfPipe,
-            .dstStage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
-            .subresourceRange = { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 },
-        };
-        cmd->transition_image(attachmentTransition);
+        cmd->require_image_state(swapchainImages.at(imageIndex),
+                                 vk::ImageLayout::eColorAttachmentOptimal,
+                                 vk::AccessFlagBits2::eColorAttachmentWrite,
+                                 vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+        cmd->require_image_state(depthBufferAttachment.image,
+                                 vk::ImageLayout::eDepthStencilAttachmentOptimal,
+                                 vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                                 vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests);
 
         cmd->begin_pass(swapchainRenderPasses.at(imageIndex));
         cmd->set_viewport(0, WINDOW_HEIGHT, WINDOW_WIDTH, -WINDOW_HEIGHT);
@@ -308,22 +307,15 @@ int main(int argc, char** argv)
         cmd->bind_pipeline(geometryPipeline);
         cmd->bind_sets(0, { set });
         cmd->set_constants(vk::ShaderStageFlagBits::eVertex, 0, sizeof(PushConstants), &pushConstants);
-        cmd->bind_vertex_buffer(mesh.vertexBuffer);
-        cmd->bind_index_buffer(mesh.indexBuffer, vk::IndexType::eUint32);
-        cmd->draw_indexed(mesh.indexCount, 1, 0, 0, 0);
+        meshPool.bind(cmd, mesh.allocation.page);
+        meshPool.draw(cmd, mesh.allocation);
         cmd->end_pass();
 
-        vgw::ImageTransitionInfo presentTransition{
-            .image = swapchainImages.at(imageIndex),
-            .oldLayout = vk::ImageLayout::eColorAttachmentOptimal,
-            .newLayout = vk::ImageLayout::ePresentSrcKHR,
-            .srcAccess = vk::AccessFlagBits2::eColorAttachmentWrite,
-            .dstAccess = vk::AccessFlagBits2::eNone,
-            .srcStage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
-            .dstStage = vk::PipelineStageFlagBits2::eBottomOfPipe,
-            .subresourceRange = { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 },
-        };
-        cmd->transition_image(presentTransition);
+        // Recorded at the stage the image ready semaphore is waited on, so next frame's transition out of present chains with it.
+        cmd->require_image_state(swapchainImages.at(imageIndex),
+                                 vk::ImageLayout::ePresentSrcKHR,
+                                 vk::AccessFlagBits2::eNone,
+                                 vk::PipelineStageFlagBits2::eColorAttachmentOutput);
 
         cmd->end();
 
@@ -345,6 +337,9 @@ int main(int argc, char** argv)
         vgw::present_swapchain(presentInfo);
     }
 
+    vgw::wait_on_fence(fence);
+    meshPool.destroy();
+
     vgw::destroy_device();
     vgw::destroy_context();
 
@@ -451,31 +446,9 @@ bool read_obj_model(const std::string& filename, std::vector<Vertex>& outVertice
 
 auto create_mesh(const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& indices) -> Mesh
 {
-    void* mappedPtr{ nullptr };
-
-    vgw::BufferInfo vertexBufferInfo{
-        .size = sizeof(Vertex) * vertices.size(),
-        .usage = vk::BufferUsageFlagBits::eVertexBuffer,
-        .memUsage = VMA_MEMORY_USAGE_AUTO,
-        .allocFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
-    };
-    auto vertexBuffer = vgw::create_buffer(vertexBufferInfo).value();
-    mappedPtr = vgw::map_buffer(vertexBuffer).value();
-    std::memcpy(mappedPtr, vertices.data(), vertexBufferInfo.size);
-    vgw::unmap_buffer(vertexBuffer);
-
-    vgw::BufferInfo indexBufferInfo{
-        .size = sizeof(std::uint32_t) * indices.size(),
-        .usage = vk::BufferUsageFlagBits::eIndexBuffer,
-        .memUsage = VMA_MEMORY_USAGE_AUTO,
-        .allocFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
-    };
-    auto indexBuffer = vgw::create_buffer(indexBufferInfo).value();
-    mappedPtr = vgw::map_buffer(indexBuffer).value();
-    std::memcpy(mappedPtr, indices.data(), indexBufferInfo.size);
-    vgw::unmap_buffer(indexBuffer);
-
-    return { vertexBuffer, indexBuffer, indices.size() };
+    auto allocation = meshPool.allocate_mesh(sizeof(Vertex) * vertices.size(), std::uint32_t(indices.size())).value();
+    meshPool.write_mesh(allocation, vertices.data(), indices.data());
+    return { allocation };
 }
 
 bool read_image(const std::string& filename, std::uint32_t& outWidth, std::uint32_t& outHeight, std::vector<std::uint8_t>& outPixels)
@@ -500,17 +473,6 @@ bool read_image(const std::string& filename, std::uint32_t& outWidth, std::uint3
 
 auto create_texture(std::uint32_t width, std::uint32_t height, const std::vector<std::uint8_t>& pixels) -> Texture
 {
-    vgw::BufferInfo bufferInfo{
-        .size = pixels.size(),
-        .usage = vk::BufferUsageFlagBits::eTransferSrc,
-        .memUsage = VMA_MEMORY_USAGE_AUTO,
-        .allocFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
-    };
-    auto stagingBuffer = vgw::create_buffer(bufferInfo).value();
-    auto* mappedData = vgw::map_buffer(stagingBuffer).value();
-    std::memcpy(mappedData, pixels.data(), bufferInfo.size);
-    vgw::unmap_buffer(stagingBuffer);
-
     vgw::ImageInfo imageInfo{
         .type = vk::ImageType::e2D,
         .width = width,
@@ -519,6 +481,7 @@ auto create_texture(std::uint32_t width, std::uint32_t height, const std::vector
         .mipLevels = 1,
         .format = vk::Format::eR8G8B8A8Srgb,
         .usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
+        .hostTransfer = true,
     };
     auto image = vgw::create_image(imageInfo).value();
 
@@ -529,28 +492,10 @@ auto create_texture(std::uint32_t width, std::uint32_t height, const std::vector
     };
     auto view = vgw::create_image_view(viewInfo).value();
 
-    vgw::CmdBufferAllocInfo cmdAllocInfo{
-        .count = 1,
-        .level = vk::CommandBufferLevel::ePrimary,
-        .poolFlags = vk::CommandPoolCreateFlagBits::eTransient,
-    };
-    auto* cmd = vgw::allocate_command_buffers(cmdAllocInfo).value()[0];
-
-    vgw::ImageTransitionInfo transferTransition{
+    // Written directly by the CPU with VK_EXT_host_image_copy, otherwise through a staging buffer.
+    vgw::ImageUploadInfo uploadInfo{
         .image = image,
-        .oldLayout = vk::ImageLayout::eUndefined,
-        .newLayout = vk::ImageLayout::eTransferDstOptimal,
-        .srcAccess = vk::AccessFlagBits2::eNone,
-        .dstAccess = vk::AccessFlagBits2::eTransferWrite,
-        .srcStage = vk::PipelineStageFlagBits2::eTopOfPipe,
-        .dstStage = vk::PipelineStageFlagBits2::eTransfer,
-        .subresourceRange = { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 },
-    };
-
-    vgw::CopyBufferToImageInfo copyInfo{
-        .srcBuffer = stagingBuffer,
-        .dstImage = image,
-        .dstImageLayout = vk::ImageLayout::eTransferDstOptimal,
+        .pixels = pixels,
         .regions = { { 0,
                        0,
                        0,
@@ -562,33 +507,9 @@ auto create_texture(std::uint32_t width, std::uint32_t height, const std::vector
                        },
                        { 0, 0, 0 },
                        { width, height, 1 } } },
+        .finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
     };
-
-    vgw::ImageTransitionInfo shaderReadOnlyTransition{
-        .image = image,
-        .oldLayout = vk::ImageLayout::eTransferDstOptimal,
-        .newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
-        .srcAccess = vk::AccessFlagBits2::eTransferWrite,
-        .dstAccess = vk::AccessFlagBits2::eShaderRead,
-        .srcStage = vk::PipelineStageFlagBits2::eTransfer,
-        .dstStage = vk::PipelineStageFlagBits2::eFragmentShader,
-        .subresourceRange = { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 },
-    };
-
-    cmd->begin({});
-    cmd->transition_image(transferTransition);
-    cmd->copy_buffer_to_image(copyInfo);
-    cmd->transition_image(shaderReadOnlyTransition);
-    cmd->end();
-
-    auto fence = vgw::create_fence({}).value();
-    vgw::SubmitInfo submitInfo{
-        .queueIndex = 0,
-        .cmdBuffers = { *cmd },
-        .signalFence = fence,
-    };
-    vgw::submit(submitInfo);
-    vgw::wait_on_fence(fence);
+    vgw::upload_image_host(uploadInfo);
 
     return { image, view };
 }
@@ -0,0 +1,111 @@
+#ifndef VGW_MESH_POOL_HPP
+#define VGW_MESH_POOL_HPP
+
+#pragma once
+
+#include "vgw.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace vgw
+{
+    struct MeshPoolInfo
+    {
+        // Size of one vertex. Meshes are placed at whole vertex offsets so they can be drawn with `vertexOffset`.
+        std::uint32_t vertexStride{};
+        vk::IndexType indexType{ vk::IndexType::eUint32 };
+        // Capacity of each page. A new page is created when a mesh does not fit in the existing ones.
+        std::uint32_t pageVertexCount{ 1u << 20 };
+        std::uint32_t pageIndexCount{ 3u << 20 };
+        // Added to the vertex/index buffer usage, e.g. `eStorageBuffer` to pull vertices in shaders.
+        vk::BufferUsageFlags extraUsage{};
+        /**
+         * Pages are device local and `write_mesh()` uploads through a staging buffer. When set, pages are host visible instead and
+         * written directly, which only keeps them in VRAM with ReBAR or on UMA devices.
+         */
+        bool hostVisiblePages{ false };
+        // Queue the staging copies are submitted to.
+        std::uint32_t queueIndex{};
+    };
+
+    struct MeshAllocation
+    {
+        std::uint32_t page{};
+        // Pass as `draw_indexed()`'s `vertexOffset` and `firstIndex`.
+        std::int32_t vertexOffset{};
+        std::uint32_t firstIndex{};
+        std::uint32_t vertexCount{};
+        std::uint32_t indexCount{};
+
+        VmaVirtualAllocation vertexAllocation{};
+        VmaVirtualAllocation indexAllocation{};
+    };
+
+    /**
+     * Places meshes in a few large vertex/index buffers (pages), sub-allocated with VMA virtual blocks. Every mesh in a page is drawn
+     * after a single `bind()`, using its `vertexOffset`/`firstIndex`, which also allows drawing a whole page indirectly.
+     */
+    class MeshPool
+    {
+    public:
+        MeshPool() = default;
+        ~MeshPool();
+
+        MeshPool(const MeshPool&) = delete;
+        auto operator=(const MeshPool&) -> MeshPool& = delete;
+
+        auto initialise(const MeshPoolInfo& poolInfo) -> ResultCode;
+        // Destroys every page. Must only be called once the GPU has finished using them.
+        void destroy();
+
+        // `vertexBytes` must be a multiple of the vertex stride.
+        auto allocate_mesh(vk::DeviceSize vertexBytes, std::uint32_t indexCount) -> std::expected<MeshAllocation, ResultCode>;
+        // The mesh must not be in use by pending GPU work.
+        void free_mesh(const MeshAllocation& mesh);
+
+        /**
+         * Copies the vertices and indices into the mesh's range of the page buffers. Unless the pages are host visible, this submits a
+         * staging copy and waits for it.
+         */
+        auto write_mesh(const MeshAllocation& mesh, const void* vertexData, const void* indexData) -> ResultCode;
+
+        // Binds the page's vertex and index buffers.
+        void bind(CommandBuffer cmd, std::uint32_t page) const;
+        void draw(CommandBuffer cmd, const MeshAllocation& mesh, std::uint32_t instanceCount = 1, std::uint32_t firstInstance = 0) const;
+        auto get_draw_command(const MeshAllocation& mesh, std::uint32_t instanceCount = 1, std::uint32_t firstInstance = 0) const
+            -> vk::DrawIndexedIndirectCommand;
+
+        auto get_page_count() const -> std::uint32_t;
+        auto get_vertex_buffer(std::uint32_t page) const -> vk::Buffer;
+        auto get_index_buffer(std::uint32_t page) const -> vk::Buffer;
+
+    private:
+        struct Page
+        {
+            vk::Buffer vertexBuffer{};
+            vk::Buffer indexBuffer{};
+            // Sized in vertices/indices rather than bytes, so every offset is a whole vertex/index.
+            VmaVirtualBlock vertexBlock{};
+            VmaVirtualBlock indexBlock{};
+        };
+
+        auto create_page() -> std::expected<std::uint32_t, ResultCode>;
+        void destroy_page(Page& page);
+        auto write_mapped(vk::Buffer buffer, vk::DeviceSize offset, const void* data, vk::DeviceSize size) -> ResultCode;
+        auto upload_staged(const Page& page, const MeshAllocation& mesh, const void* vertexData, const void* indexData) -> ResultCode;
+        auto allocate_from_page(std::uint32_t pageIndex, std::uint32_t vertexCount, std::uint32_t indexCount, MeshAllocation& outMesh)
+            -> bool;
+        auto get_index_size() const -> std::uint32_t;
+
+    private:
+        MeshPoolInfo m_info{};
+        bool m_isInitialised{ false };
+        CommandBuffer m_cmd{};
+        vk::Fence m_fence{};
+
+        std::vector<Page> m_pages{};
+    };
+}
+
+#endif  // VGW_MESH_POOL_HPP
@@ -0,0 +1,200 @@
+#ifndef VGW_RENDER_GRAPH_HPP
+#define VGW_RENDER_GRAPH_HPP
+
+#pragma once
+
+#include "vgw.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+
+namespace vgw
+{
+    struct RenderGraphImage
+    {
+        std::uint32_t index{ std::uint32_t(-1) };
+
+        auto operator<=>(const RenderGraphImage&) const = default;
+    };
+    struct RenderGraphBuffer
+    {
+        std::uint32_t index{ std::uint32_t(-1) };
+
+        auto operator<=>(const RenderGraphBuffer&) const = default;
+    };
+
+    enum class RenderGraphAccess : std::uint8_t
+    {
+        eSampled,
+        eStorageRead,
+        eStorageWrite,
+        eUniform,
+        eVertexBuffer,
+        eIndexBuffer,
+        eIndirectBuffer,
+        eTransferSrc,
+        eTransferDst,
+        eColorAttachment,
+        eDepthAttachment,
+        // Left at eColorAttachmentOutput, so the image's acquire semaphore must be waited on at that stage (or an earlier one).
+        ePresent,
+    };
+
+    struct RenderGraphImportedImageInfo
+    {
+        vk::Image image{};
+        vk::ImageView view{};
+        std::uint32_t width{};
+        std::uint32_t height{};
+    };
+    /**
+     * Transient images are created by `RenderGraph::compile`. Usage flags are derived from the declared accesses, and images whose
+     * lifetimes do not overlap share memory.
+     */
+    struct RenderGraphImageInfo
+    {
+        std::uint32_t width{};
+        std::uint32_t height{};
+        vk::Format format{};
+    };
+
+    struct RenderGraphImageUse
+    {
+        RenderGraphImage image{};
+        RenderGraphAccess access{};
+    };
+    struct RenderGraphBufferUse
+    {
+        RenderGraphBuffer buffer{};
+        RenderGraphAccess access{};
+    };
+    struct RenderGraphColorAttachment
+    {
+        RenderGraphImage image{};
+        vk::AttachmentLoadOp loadOp{ vk::AttachmentLoadOp::eDontCare };
+        std::array<float, 4> clearColor{ 0.0f, 0.0f, 0.0f, 1.0f };
+    };
+    struct RenderGraphDepthAttachment
+    {
+        RenderGraphImage image{};
+        vk::AttachmentLoadOp loadOp{ vk::AttachmentLoadOp::eDontCare };
+        float clearDepth{ 1.0f };
+    };
+
+    /**
+     * Passes with attachments are recorded inside `begin_pass`/`end_pass` with a full viewport and scissor already set.
+     * Store ops are chosen by the graph: attachments are only stored if a later pass reads them or they are imported.
+     * Passes whose results are never read (and that write no imported resource) are culled unless `hasSideEffects` is set.
+     */
+    struct RenderGraphPassInfo
+    {
+        std::string name{};
+        bool isCompute{ false };
+        bool hasSideEffects{ false };
+        std::vector<RenderGraphImageUse> imageReads{};
+        std::vector<RenderGraphImageUse> imageWrites{};
+        std::vector<RenderGraphBufferUse> bufferReads{};
+        std::vector<RenderGraphBufferUse> bufferWrites{};
+        std::vector<RenderGraphColorAttachment> colorAttachments{};
+        std::optional<RenderGraphDepthAttachment> depthAttachment{};
+        std::function<void(CommandBuffer)> execute{};
+    };
+
+    class RenderGraph
+    {
+    public:
+        RenderGraph() = default;
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph&) = delete;
+        auto operator=(const RenderGraph&) -> RenderGraph& = delete;
+
+        auto import_image(const RenderGraphImportedImageInfo& importInfo) -> RenderGraphImage;
+        auto create_image(const RenderGraphImageInfo& imageInfo) -> RenderGraphImage;
+        auto import_buffer(vk::Buffer buffer) -> RenderGraphBuffer;
+
+        void add_pass(const RenderGraphPassInfo& passInfo);
+
+        /**
+         * Sorts and culls passes, creates transient images in shared memory, computes barriers and creates render passes.
+         * Initial states of imported resources are taken from the image/buffer state tracking.
+         */
+        auto compile() -> ResultCode;
+
+        // Records all passes into an already begun command buffer.
+        void execute(CommandBuffer cmd);
+        /**
+         * Records contiguous ranges of passes into `cmdBuffers` on one thread each. The command buffers must already be begun, come from
+         * different pool indices, and be submitted in order. State tracking is disabled on them while recording (see
+         * `CommandBuffer_T::set_state_tracking`), so callbacks must rely on the declared accesses for their barriers. Callbacks must
+         * not create or destroy resources or write descriptor sets.
+         */
+        void execute_parallel(const std::vector<CommandBuffer>& cmdBuffers);
+
+        /**
+         * Destroys transient resources and clears the graph. Must only be called once the GPU has finished the recorded work.
+         */
+        void reset();
+
+        auto get_image(RenderGraphImage image) const -> vk::Image;
+        auto get_image_view(RenderGraphImage image) const -> vk::ImageView;
+
+        auto get_pass_order() const -> std::vector<std::string>;
+        auto get_transient_memory_size() const -> std::size_t;
+
+    private:
+        struct ImageResource
+        {
+            vk::Image image{};
+            vk::ImageView view{};
+            RenderGraphImageInfo info{};
+            bool isImported{ false };
+        };
+        struct BufferResource
+        {
+            vk::Buffer buffer{};
+        };
+        struct Pass
+        {
+            RenderGraphPassInfo info{};
+            RenderPass renderPass{};
+            std::uint32_t width{};
+            std::uint32_t height{};
+            std::vector<vk::ImageMemoryBarrier2> imageBarriers{};
+            std::vector<vk::BufferMemoryBarrier2> bufferBarriers{};
+        };
+        struct FinalImageState
+        {
+            vk::Image image{};
+            vk::ImageLayout layout{};
+            vk::AccessFlags2 access{};
+            vk::PipelineStageFlags2 stage{};
+        };
+        struct FinalBufferState
+        {
+            vk::Buffer buffer{};
+            vk::AccessFlags2 access{};
+            vk::PipelineStageFlags2 stage{};
+        };
+
+        void record_pass(CommandBuffer cmd, const Pass& pass);
+        void apply_final_states();
+
+    private:
+        std::vector<ImageResource> m_images{};
+        std::vector<BufferResource> m_buffers{};
+        std::vector<Pass> m_passes{};
+
+        std::vector<std::uint32_t> m_passOrder{};
+        VmaAllocation m_transientMemory{};
+        std::size_t m_transientMemorySize{};
+
+        std::vector<FinalImageState> m_finalImageStates{};
+        std::vector<FinalBufferState> m_finalBufferStates{};
+    };
+}
+
+#endif  // VGW_RENDER_GRAPH_HPP
@@ -0,0 +1,145 @@
+#ifndef VGW_TEXTURE_RESIDENCY_HPP
+#define VGW_TEXTURE_RESIDENCY_HPP
+
+#pragma once
+
+#include "vgw.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+namespace vgw
+{
+    struct ResidentTexture
+    {
+        std::uint32_t index{ std::uint32_t(-1) };
+
+        auto operator<=>(const ResidentTexture&) const = default;
+    };
+
+    struct TextureResidencyInfo
+    {
+        // Textures are evicted once they use more than this. When 0, the limit is derived from the device local heap budgets.
+        vk::DeviceSize maxResidentBytes{};
+        // Fraction of the device local heap budgets the whole process may use before textures are evicted.
+        float budgetFraction{ 0.9f };
+        // Mips no larger than this (in both dimensions) are never evicted, so a low resolution fallback is always resident.
+        std::uint32_t fallbackSize{ 64 };
+        /**
+         * Textures used within this many frames are not evicted, as the GPU may still be reading them. Replaced images are destroyed
+         * after the same number of frames.
+         */
+        std::uint32_t framesInFlight{ 3 };
+        // Limits the pixels streamed in by each `update()`.
+        vk::DeviceSize maxUploadBytesPerUpdate{ 16ull * 1024 * 1024 };
+        /**
+         * Queue the uploads and mip copies are submitted to. Must be the queue the textures are sampled on: the replaced image is read
+         * by the copy while earlier frames may still sample it, which is only ordered by barriers within the same queue (there are no
+         * queue family ownership transfers).
+         */
+        std::uint32_t queueIndex{};
+    };
+
+    struct ResidentTextureInfo
+    {
+        std::uint32_t width{};
+        std::uint32_t height{};
+        std::uint32_t mipLevels{ 1 };
+        vk::Format format{ vk::Format::eR8G8B8A8Srgb };
+        // Returns the tightly packed pixels of a mip. Called every time the mip is streamed in.
+        std::function<std::vector<std::uint8_t>(std::uint32_t mip)> loadMip{};
+    };
+
+    /**
+     * Keeps sampled textures within a memory budget. Each texture is an image holding its mips from `residentMip` down: evicting
+     * recreates the image without its most detailed mips (the remaining mips are copied on the GPU) and streaming in recreates it with
+     * more mips, loading only the missing ones. Textures are sampled in `eShaderReadOnlyOptimal`.
+     */
+    class TextureResidency
+    {
+    public:
+        TextureResidency() = default;
+        ~TextureResidency();
+
+        TextureResidency(const TextureResidency&) = delete;
+        auto operator=(const TextureResidency&) -> TextureResidency& = delete;
+
+        auto initialise(const TextureResidencyInfo& residencyInfo) -> ResultCode;
+        // Destroys every texture. Must only be called once the GPU has finished using them.
+        void destroy();
+
+        // Only the fallback mips are loaded (immediately); the rest are streamed in once the texture is used.
+        auto add_texture(const ResidentTextureInfo& textureInfo) -> std::expected<ResidentTexture, ResultCode>;
+        // The image is destroyed after `framesInFlight` frames.
+        void remove_texture(ResidentTexture texture);
+
+        // Marks the texture as used in the current frame, which also requests all of its mips.
+        void touch(ResidentTexture texture);
+        /**
+         * Touches the texture and binds its current view (flushed by `flush_set_writes()`). The set must not be in use by pending GPU
+         * work, so call this every frame on that frame's set (e.g. one set per frame in flight). `update()` never rewrites sets: frames
+         * still in flight keep sampling the previous view, which stays alive for `framesInFlight` frames.
+         */
+        void bind_to_set(ResidentTexture texture, const SetImageBindInfo& bindInfo);
+
+        /**
+         * Starts a new frame. While over budget, evicts mips of the least recently used textures, then streams in the missing mips of
+         * recently used textures. Waits for the GPU copies it submits.
+         */
+        auto update() -> ResultCode;
+
+        auto get_image_view(ResidentTexture texture) const -> vk::ImageView;
+        // Most detailed resident mip, 0 when the texture is fully resident.
+        auto get_resident_mip(ResidentTexture texture) const -> std::uint32_t;
+        auto get_resident_bytes() const -> vk::DeviceSize;
+
+    private:
+        struct Texture
+        {
+            ResidentTextureInfo info{};
+            vk::Image image{};
+            vk::ImageView view{};
+            std::uint32_t residentMip{};
+            // Mips from here down are never evicted.
+            std::uint32_t fallbackMip{};
+            vk::DeviceSize residentBytes{};
+            std::uint64_t lastUsedFrame{};
+            bool isValid{ false };
+        };
+        struct RetiredImage
+        {
+            vk::Image image{};
+            vk::ImageView view{};
+            std::uint64_t retiredFrame{};
+        };
+        struct Change
+        {
+            std::uint32_t texture{};
+            std::uint32_t targetMip{};
+        };
+
+        auto get_memory_limit() const -> vk::DeviceSize;
+        auto get_mip_chain_bytes(const ResidentTextureInfo& info, std::uint32_t baseMip) const -> vk::DeviceSize;
+        auto is_in_use(const Texture& texture) const -> bool;
+
+        // Recreates the images of the changed textures with their target mips, in a single submission.
+        auto apply_changes(const std::vector<Change>& changes) -> ResultCode;
+        void retire_image(vk::Image image, vk::ImageView view);
+
+    private:
+        TextureResidencyInfo m_info{};
+        bool m_isInitialised{ false };
+        CommandBuffer m_cmd{};
+        vk::Fence m_fence{};
+
+        std::vector<Texture> m_textures{};
+        std::vector<std::uint32_t> m_freeTextures{};
+        std::vector<RetiredImage> m_retiredImages{};
+
+        std::uint64_t m_frame{};
+        vk::DeviceSize m_residentBytes{};
+    };
+}
+
+#endif  // VGW_TEXTURE_RESIDENCY_HPP
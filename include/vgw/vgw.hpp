@@ -11,6 +11,9 @@
 #include "common.hpp"
 
 #include <expected>
+#include <span>
+#include <string>
+#include <optional>
 #include <functional>
 #include <string_view>
 
@@ -25,6 +28,19 @@ namespace vgw
     };
     using MessageCallbackFn = std::function<void(MessageType, std::string_view)>;
     void set_message_callback(const MessageCallbackFn& callbackFn);
+    /**
+     * Messages below `minLevel` are discarded before they are formatted (default: all). Independently, messages below the
+     * compile-time `VGW_LOG_LEVEL` (0 = debug ... 3 = error, defaulting to 1 with NDEBUG) are compiled out of the library.
+     */
+    void set_message_level(MessageType minLevel);
+    /**
+     * When enabled, messages are formatted into a fixed-size stack buffer (truncated to 256 characters) and passed through a
+     * lock-free queue to a background thread, which invokes the callback. Logging threads never wait or allocate; if the queue
+     * is full the message is dropped and a warning reports the count. The callback must be safe to call from that thread.
+     */
+    void set_async_messages(bool enabled);
+    // Waits until all queued async messages have been passed to the callback.
+    void flush_messages();
 
     struct ContextInfo
     {
@@ -49,10 +65,21 @@ namespace vgw
         bool enableDynamicRendering;
         std::uint32_t maxDescriptorSets;
         std::vector<vk::DescriptorPoolSize> descriptorPoolSizes;
+        /**
+         * Seeds the device's pipeline cache, which every pipeline is created with, e.g. with `get_pipeline_cache_data()` saved by a
+         * previous run (see `read_pipeline_cache_from_file()`). Data from another driver or device is ignored by the driver.
+         */
+        std::vector<std::uint8_t> pipelineCacheData;
     };
     auto initialise_device(const DeviceInfo& deviceInfo) -> ResultCode;
     void destroy_device();
 
+    /**
+     * Queue family selected for `DeviceInfo::wantedQueues[queueIndex]`.
+     * Dedicated compute-only/transfer-only families are preferred when the wanted flags allow it.
+     */
+    auto get_queue_family_index(std::uint32_t queueIndex) -> std::expected<std::uint32_t, ResultCode>;
+
     struct SwapchainInfo
     {
         vk::SurfaceKHR surface{};
@@ -101,6 +128,8 @@ namespace vgw
     {
         vk::PipelineLayout layout{};
         std::vector<std::uint32_t> computeCode{};
+        // Used to identify the pipeline in creation feedback and traces.
+        std::string name{};
     };
     auto create_compute_pipeline(const ComputePipelineInfo& pipelineInfo) -> std::expected<vk::Pipeline, ResultCode>;
 
@@ -120,22 +149,219 @@ namespace vgw
         float lineWidth{ 1.0f };
         bool depthTest;
         bool depthWrite;
+        // Used to identify the pipeline in creation feedback and traces.
+        std::string name{};
     };
     auto create_graphics_pipeline(const GraphicsPipelineInfo& pipelineInfo) -> std::expected<vk::Pipeline, ResultCode>;
 
+    struct PipelineStageFeedback
+    {
+        vk::ShaderStageFlagBits stage{};
+        // The remaining fields are only meaningful if the driver provided feedback for the stage.
+        bool isValid{ false };
+        bool isCacheHit{ false };
+        double durationMs{};
+    };
+    /**
+     * Filled from VkPipelineCreationFeedback when the pipeline is created. `isCacheHit` means the driver found the whole pipeline
+     * in the device's pipeline cache (see `DeviceInfo::pipelineCacheData`), without compiling it.
+     */
+    struct PipelineFeedback
+    {
+        vk::Pipeline pipeline{};
+        std::string name{};
+        vk::PipelineBindPoint bindPoint{};
+        bool isValid{ false };
+        bool isCacheHit{ false };
+        bool usedBasePipelineAcceleration{ false };
+        double durationMs{};
+        std::vector<PipelineStageFeedback> stages{};
+    };
+    auto get_pipeline_feedback(vk::Pipeline pipeline) -> std::expected<PipelineFeedback, ResultCode>;
+    // All live pipelines, slowest to create first.
+    auto get_pipeline_feedback_report() -> std::vector<PipelineFeedback>;
+    // Contents of the device's pipeline cache, to seed `DeviceInfo::pipelineCacheData` with on the next run.
+    auto get_pipeline_cache_data() -> std::expected<std::vector<std::uint8_t>, ResultCode>;
+
+    enum class PoolAlgorithm : std::uint8_t
+    {
+        // General purpose, for resources with unrelated lifetimes.
+        eDefault,
+        // Allocations are appended, so freeing only returns memory at the end (stack) or when the pool is empty. For short lived data.
+        eLinear,
+        // Linear with a single block, allocating at the end and freeing from the start, e.g. per-frame data freed in creation order.
+        eRing,
+    };
+    struct PoolInfo
+    {
+        PoolAlgorithm algorithm{ PoolAlgorithm::eDefault };
+        // 0 uses the allocator's default block size. Ring pools use a single block of this size.
+        vk::DeviceSize blockSize{};
+        std::uint32_t minBlockCount{};
+        // 0 for no limit.
+        std::uint32_t maxBlockCount{};
+        // The memory type is chosen for resources with this usage. Set the buffer usage for a buffer pool, or the image format and
+        // usage for an image pool.
+        vk::BufferUsageFlags bufferUsage{};
+        vk::Format imageFormat{};
+        vk::ImageUsageFlags imageUsage{};
+        VmaMemoryUsage memUsage{ VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE };
+        VmaAllocationCreateFlags allocFlags{};
+    };
+    namespace internal
+    {
+        struct MemoryPoolData;
+    }
+    using MemoryPool = struct internal::MemoryPoolData*;
+    auto create_memory_pool(const PoolInfo& poolInfo) -> std::expected<MemoryPool, ResultCode>;
+    // Every buffer and image allocated from the pool must be destroyed first.
+    void destroy_memory_pool(MemoryPool pool);
+
+    namespace internal
+    {
+        struct AliasingHeapData;
+    }
+    using AliasingHeap = struct internal::AliasingHeapData*;
+
+    // Places a buffer/image in an aliasing heap instead of giving it its own allocation. The offset usually comes from
+    // `create_aliasing_heap()`.
+    struct AliasingPlacement
+    {
+        AliasingHeap heap{};
+        vk::DeviceSize offset{};
+    };
+
+    // Allocation policy for a buffer/image. Ignored when the resource is placed in an aliasing heap.
+    struct MemoryHints
+    {
+        /**
+         * Gives the resource its own VkDeviceMemory, e.g. for large render targets, which some drivers place better when dedicated.
+         * Creation fails when combined with a memory pool.
+         */
+        bool dedicated{ false };
+        /**
+         * 0 (lowest) to 1 (highest). With VK_EXT_memory_priority, lower priority memory is moved out of device local memory first when
+         * it is oversubscribed. Only applies to memory allocated for the resource, i.e. dedicated allocations or new blocks.
+         */
+        float priority{ 0.5f };
+        /**
+         * Prefer device local memory the CPU can write directly (ReBAR/UMA), so the resource can be mapped and written without a staging
+         * copy. Falls back to host visible memory when there is none (see `get_memory_capabilities()`).
+         */
+        bool hostVisibleDeviceLocal{ false };
+    };
+
     struct BufferInfo
     {
         std::size_t size{};
         vk::BufferUsageFlags usage{};
         VmaMemoryUsage memUsage{};
         VmaAllocationCreateFlags allocFlags{};
+        // Allocate from a custom pool instead of the default pools. The pool's memory type overrides `memUsage`.
+        MemoryPool pool{};
+        // When a heap is set, `memUsage`, `allocFlags` and `pool` are ignored and the buffer is bound into the heap's device local memory.
+        AliasingPlacement aliasing{};
+        MemoryHints memoryHints{};
     };
     auto create_buffer(const BufferInfo& bufferInfo) -> std::expected<vk::Buffer, ResultCode>;
     void destroy_buffer(vk::Buffer buffer);
 
+    // A range of a buffer that is shared with other sub-allocated buffers.
+    struct SubBuffer
+    {
+        vk::Buffer buffer{};
+        vk::DeviceSize offset{};
+        vk::DeviceSize size{};
+
+        VmaVirtualAllocation allocation{};
+    };
+    /**
+     * Carves the buffer out of a large shared buffer (sub-allocated with a VMA virtual block) instead of creating a buffer and allocation
+     * of its own, which suits small buffers such as uniform blocks. Buffers created with the same usage, memory usage, flags, pool and
+     * hints share buffers, and the offset is aligned for the usage. Aliasing and dedicated memory are not supported. To write it, map
+     * the shared buffer with `map_buffer()` and add the offset. Barriers are tracked per shared buffer.
+     */
+    auto create_suballocated_buffer(const BufferInfo& bufferInfo) -> std::expected<SubBuffer, ResultCode>;
+    /**
+     * The range must not be in use by pending GPU work. A shared buffer left empty is destroyed, except for one default sized buffer per
+     * kind that is kept for later sub-allocations.
+     */
+    void destroy_suballocated_buffer(const SubBuffer& subBuffer);
+
+    /**
+     * GPU address of a buffer created with `eShaderDeviceAddress` usage (requires the bufferDeviceAddress feature, enabled when
+     * supported). Shaders read it through `GL_EXT_buffer_reference`, e.g. from push constants, without binding the buffer to a set.
+     */
+    auto get_buffer_address(vk::Buffer buffer) -> std::expected<vk::DeviceAddress, ResultCode>;
+
+    // Typed buffer address, matching a GLSL `buffer_reference` member (8 bytes) in push constants and buffers.
+    template <typename T>
+    struct DevicePointer
+    {
+        vk::DeviceAddress address{};
+
+        // Address of the element `count` elements further on.
+        auto operator+(std::uint64_t count) const -> DevicePointer { return { address + count * sizeof(T) }; }
+        explicit operator bool() const { return address != 0; }
+    };
+    static_assert(sizeof(DevicePointer<int>) == 8);
+
+    template <typename T>
+    auto get_buffer_pointer(vk::Buffer buffer, vk::DeviceSize offset = 0) -> std::expected<DevicePointer<T>, ResultCode>
+    {
+        return get_buffer_address(buffer).transform([offset](vk::DeviceAddress address) { return DevicePointer<T>{ address + offset }; });
+    }
+
     auto map_buffer(vk::Buffer buffer) -> std::expected<void*, ResultCode>;
     void unmap_buffer(vk::Buffer buffer);
 
+    struct MemoryHeapBudget
+    {
+        std::uint32_t heapIndex{};
+        vk::MemoryHeapFlags flags{};
+        std::uint64_t heapSize{};
+        // Estimated by VMA (80% of the heap, minus usage by this process) when VK_EXT_memory_budget is not supported.
+        std::uint64_t budget{};
+        // Usage by all processes if VK_EXT_memory_budget is supported, otherwise by this process only.
+        std::uint64_t usage{};
+        std::uint64_t blockBytes{};
+        std::uint64_t allocationBytes{};
+        std::uint32_t blockCount{};
+        std::uint32_t allocationCount{};
+    };
+    auto get_memory_budget() -> std::expected<std::vector<MemoryHeapBudget>, ResultCode>;
+
+    struct MemoryCapabilities
+    {
+        // Some memory type is both device local and host visible (ReBAR, UMA or the 256 MiB BAR window).
+        bool hasHostVisibleDeviceLocal{ false };
+        // Size of the heaps backing those memory types. Only a full ReBAR/UMA heap is big enough for more than per-frame data.
+        std::uint64_t hostVisibleDeviceLocalBytes{};
+        // Every heap is device local, i.e. an integrated GPU sharing system memory.
+        bool isUnifiedMemory{ false };
+        // `MemoryHints::priority` has an effect.
+        bool isMemoryPrioritySupported{ false };
+    };
+    auto get_memory_capabilities() -> std::expected<MemoryCapabilities, ResultCode>;
+
+    struct MemoryStats
+    {
+        std::uint32_t blockCount{};
+        std::uint32_t allocationCount{};
+        std::uint32_t unusedRangeCount{};
+        std::uint64_t blockBytes{};
+        std::uint64_t allocationBytes{};
+        std::uint64_t largestAllocation{};
+        std::uint64_t largestUnusedRange{};
+        // 0 when all unused memory is one contiguous range, approaching 1 as it is split into many small ranges.
+        float fragmentation{};
+    };
+    // Walks every allocation, so this is slower than `get_memory_budget()`.
+    auto get_memory_stats() -> std::expected<MemoryStats, ResultCode>;
+    auto get_memory_pool_stats(MemoryPool pool) -> std::expected<MemoryStats, ResultCode>;
+    // JSON from `vmaBuildStatsString`. With `detailed`, every allocation and unused range is listed.
+    auto dump_memory_json(bool detailed) -> std::expected<std::string, ResultCode>;
+
     struct ImageInfo
     {
         vk::ImageType type{};
@@ -145,10 +371,122 @@ namespace vgw
         std::uint32_t mipLevels{};
         vk::Format format{};
         vk::ImageUsageFlags usage{};
+        // Allocate from a custom pool instead of the default pools.
+        MemoryPool pool{};
+        // When a heap is set, the image is bound into the heap's memory instead of getting its own allocation.
+        AliasingPlacement aliasing{};
+        // Adds `eHostTransferEXT` usage when `is_host_image_copy_supported(format)`, so `upload_image_host()` can skip staging.
+        bool hostTransfer{ false };
+        MemoryHints memoryHints{};
     };
     auto create_image(const ImageInfo& imageInfo) -> std::expected<vk::Image, ResultCode>;
     void destroy_image(vk::Image image);
 
+    struct ImageUploadInfo
+    {
+        vk::Image image{};
+        // Region `bufferOffset`s index into the pixels, which are tightly packed unless `bufferRowLength`/`bufferImageHeight` are set.
+        std::span<const std::uint8_t> pixels{};
+        std::vector<vk::BufferImageCopy2> regions{};
+        // Layout the uploaded subresources are left in.
+        vk::ImageLayout finalLayout{ vk::ImageLayout::eShaderReadOnlyOptimal };
+        // Queue the staging fallback submits its copy to.
+        std::uint32_t queueIndex{};
+    };
+    /**
+     * Writes the pixels straight into the image from the CPU (VK_EXT_host_image_copy) when it was created with `hostTransfer`,
+     * otherwise copies them through a staging buffer and waits for the copy. The image must not be in use by the GPU.
+     */
+    auto upload_image_host(const ImageUploadInfo& uploadInfo) -> ResultCode;
+    auto is_host_image_copy_supported(vk::Format format) -> bool;
+
+    auto get_buffer_memory_requirements(const BufferInfo& bufferInfo) -> std::expected<vk::MemoryRequirements, ResultCode>;
+    auto get_image_memory_requirements(const ImageInfo& imageInfo) -> std::expected<vk::MemoryRequirements, ResultCode>;
+
+    // Linear resources are buffers and linear tiling images; optimal tiling images are non-linear.
+    enum class ResourceLinearity : std::uint8_t
+    {
+        // Kept apart from every other resource, as if it were of the other kind.
+        eUnknown,
+        eLinear,
+        eNonLinear,
+    };
+    struct TransientResourceInfo
+    {
+        // From `get_buffer_memory_requirements()` or `get_image_memory_requirements()`.
+        vk::MemoryRequirements requirements{};
+        // Linear and non-linear resources alive at the same time are placed `bufferImageGranularity` apart.
+        ResourceLinearity linearity{};
+        // Inclusive range of the passes (or any other increasing position, e.g. submit order) the resource is used in.
+        std::uint32_t firstUse{};
+        std::uint32_t lastUse{};
+    };
+    struct AliasingHeapInfo
+    {
+        std::vector<TransientResourceInfo> resources{};
+    };
+    struct AliasingHeapLayout
+    {
+        AliasingHeap heap{};
+        // Offset of each resource, in the order of `AliasingHeapInfo::resources`.
+        std::vector<vk::DeviceSize> offsets{};
+        vk::DeviceSize size{};
+        // Memory the resources would need without aliasing.
+        vk::DeviceSize unaliasedSize{};
+    };
+    /**
+     * Allocates one device local allocation and packs the resources into it, so resources whose lifetimes do not overlap share memory.
+     * Resources that do share memory have undefined contents when first used, and need a barrier between the last use of the previous
+     * resource and the first use of the next.
+     */
+    auto create_aliasing_heap(const AliasingHeapInfo& heapInfo) -> std::expected<AliasingHeapLayout, ResultCode>;
+    // Buffers and images placed in the heap must be destroyed first.
+    void destroy_aliasing_heap(AliasingHeap heap);
+
+    // A buffer or image moved by defragmentation. Only one of the pairs is set.
+    struct DefragmentationMove
+    {
+        vk::Buffer oldBuffer{};
+        vk::Buffer newBuffer{};
+        vk::Image oldImage{};
+        vk::Image newImage{};
+    };
+    using DefragmentationCallbackFn = std::function<void(const DefragmentationMove&)>;
+    struct DefragmentationInfo
+    {
+        // Defragments this pool only, otherwise the default pools.
+        MemoryPool pool{};
+        // Limits of a single pass, 0 for no limit. Smaller passes spread the work over more `defragment()` calls.
+        vk::DeviceSize maxBytesPerPass{};
+        std::uint32_t maxAllocationsPerPass{};
+        // Queue the copies are submitted to.
+        std::uint32_t queueIndex{};
+        /**
+         * Called for every moved resource once its contents are copied, before the old resource is destroyed. Image views, descriptor
+         * sets and anything else referring to the old handle must be recreated/updated. Mapped pointers to a moved buffer are invalid.
+         */
+        DefragmentationCallbackFn moveCallback{};
+    };
+    struct DefragmentationStats
+    {
+        std::uint64_t bytesMoved{};
+        std::uint64_t bytesFreed{};
+        std::uint32_t allocationsMoved{};
+        std::uint32_t deviceMemoryBlocksFreed{};
+    };
+    /**
+     * Starts incremental defragmentation, done by calling `defragment()` (e.g. once per frame) until it returns true.
+     * Only buffers and images with both transfer src and dst usage are moved.
+     */
+    auto begin_defragmentation(const DefragmentationInfo& defragInfo) -> ResultCode;
+    /**
+     * Runs defragmentation passes until `timeBudgetMs` is spent (at least one pass). Each pass copies the resources it moves on the GPU
+     * and waits for the copies, so it must be called when the GPU is not using any resource that may be moved, e.g. after waiting on the
+     * previous frame's fence. Returns true when there is nothing left to move.
+     */
+    auto defragment(double timeBudgetMs) -> std::expected<bool, ResultCode>;
+    auto end_defragmentation() -> DefragmentationStats;
+
     struct ImageViewInfo
     {
         vk::Image image{};
@@ -217,8 +555,11 @@ namespace vgw
         vk::Buffer buffer{};
         std::size_t offset{};
         std::size_t range{};
+        // Storage buffers only. The shaders never write the binding (`readonly`/NonWritable), so hazard tracking treats it as a read.
+        bool readOnly{ false };
     };
     void bind_buffer_to_set(const SetBufferBindInfo& bindInfo);
+    void bind_buffer_to_set(vk::DescriptorSet set, std::uint32_t binding, vk::DescriptorType type, const SubBuffer& subBuffer);
     struct SetImageBindInfo
     {
         vk::DescriptorSet set{};
@@ -238,9 +579,13 @@ namespace vgw
         std::uint32_t count{};
         vk::CommandBufferLevel level{};
         vk::CommandPoolCreateFlagBits poolFlags{};
+        // Queue the command buffers will be submitted to (index into `DeviceInfo::wantedQueues`).
+        std::uint32_t queueIndex{};
+        // Command buffers recorded concurrently on different threads must use different pool indices.
+        std::uint32_t poolIndex{};
     };
     auto allocate_command_buffers(const CmdBufferAllocInfo& allocInfo) -> std::expected<std::vector<CommandBuffer>, ResultCode>;
-    auto free_command_buffers(const std::vector<CommandBuffer>& cmdBuffers);
+    void free_command_buffers(const std::vector<CommandBuffer>& cmdBuffers);
 
     struct ImageTransitionInfo
     {
@@ -252,6 +597,94 @@ namespace vgw
         vk::PipelineStageFlags2 srcStage{};
         vk::PipelineStageFlags2 dstStage{};
         vk::ImageSubresourceRange subresourceRange{};
+        std::uint32_t srcQueueFamily{ VK_QUEUE_FAMILY_IGNORED };
+        std::uint32_t dstQueueFamily{ VK_QUEUE_FAMILY_IGNORED };
+    };
+    struct BufferBarrierInfo
+    {
+        vk::Buffer buffer{};
+        std::size_t offset{};
+        std::size_t size{ VK_WHOLE_SIZE };
+        vk::AccessFlags2 srcAccess{};
+        vk::AccessFlags2 dstAccess{};
+        vk::PipelineStageFlags2 srcStage{};
+        vk::PipelineStageFlags2 dstStage{};
+        std::uint32_t srcQueueFamily{ VK_QUEUE_FAMILY_IGNORED };
+        std::uint32_t dstQueueFamily{ VK_QUEUE_FAMILY_IGNORED };
+    };
+    struct MemoryBarrierInfo
+    {
+        vk::AccessFlags2 srcAccess{};
+        vk::AccessFlags2 dstAccess{};
+        vk::PipelineStageFlags2 srcStage{};
+        vk::PipelineStageFlags2 dstStage{};
+    };
+    /**
+     * Dependency of a split barrier. The barriers are released by `CommandBuffer_T::signal_event` right after the producer and
+     * acquired by `CommandBuffer_T::wait_event` right before the consumer, so unrelated work in between keeps running.
+     */
+    struct EventDependencyInfo
+    {
+        std::vector<MemoryBarrierInfo> memoryBarriers{};
+        std::vector<BufferBarrierInfo> bufferBarriers{};
+        std::vector<ImageTransitionInfo> imageTransitions{};
+    };
+    /**
+     * Queue family ownership transfer between two queues (indices into `DeviceInfo::wantedQueues`).
+     * Record the release on the source queue and the acquire on the destination queue, and order the two submissions with a semaphore.
+     * Nothing is released if both queues share a family; the acquire then becomes a regular barrier.
+     */
+    struct BufferOwnershipTransferInfo
+    {
+        vk::Buffer buffer{};
+        std::size_t offset{};
+        std::size_t size{ VK_WHOLE_SIZE };
+        std::uint32_t srcQueueIndex{};
+        std::uint32_t dstQueueIndex{};
+        vk::AccessFlags2 srcAccess{};
+        vk::AccessFlags2 dstAccess{};
+        vk::PipelineStageFlags2 srcStage{};
+        vk::PipelineStageFlags2 dstStage{};
+    };
+    struct ImageOwnershipTransferInfo
+    {
+        vk::Image image{};
+        vk::ImageLayout oldLayout{};
+        vk::ImageLayout newLayout{};
+        std::uint32_t srcQueueIndex{};
+        std::uint32_t dstQueueIndex{};
+        vk::AccessFlags2 srcAccess{};
+        vk::AccessFlags2 dstAccess{};
+        vk::PipelineStageFlags2 srcStage{};
+        vk::PipelineStageFlags2 dstStage{};
+        vk::ImageSubresourceRange subresourceRange{};
+    };
+    struct CopyBufferInfo
+    {
+        vk::Buffer srcBuffer{};
+        vk::Buffer dstBuffer{};
+        std::vector<vk::BufferCopy2> regions{};
+    };
+    struct ResizeBufferInfo
+    {
+        vk::Buffer buffer{};
+        // Minimum size of the new buffer.
+        vk::DeviceSize size{};
+        // Copy the old contents (up to the smaller size) to the new buffer on the GPU. The old buffer needs `eTransferSrc` usage.
+        bool preserve{ true };
+        /**
+         * When above 1, the buffer is only recreated if it is smaller than `size`, and then grows to at least `growthFactor` times its
+         * current size, so repeatedly appending costs amortised O(1) copies. Otherwise the buffer is recreated with exactly `size`.
+         */
+        float growthFactor{ 1.0f };
+    };
+    struct CopyImageInfo
+    {
+        vk::Image srcImage{};
+        vk::ImageLayout srcImageLayout{};
+        vk::Image dstImage{};
+        vk::ImageLayout dstImageLayout{};
+        std::vector<vk::ImageCopy2> regions{};
     };
     struct CopyBufferToImageInfo
     {
@@ -260,6 +693,24 @@ namespace vgw
         vk::ImageLayout dstImageLayout{};
         std::vector<vk::BufferImageCopy2> regions{};
     };
+    struct CopyImageToBufferInfo
+    {
+        vk::Image srcImage{};
+        vk::ImageLayout srcImageLayout{};
+        vk::Buffer dstBuffer{};
+        std::vector<vk::BufferImageCopy2> regions{};
+    };
+
+    enum class QueryType : std::uint8_t
+    {
+        eOcclusion,
+        ePipelineStatistics,
+    };
+    namespace internal
+    {
+        struct QueryData;
+    }
+    using Query = struct internal::QueryData*;
 
     class CommandBuffer_T
     {
@@ -296,8 +747,10 @@ namespace vgw
         void bind_sets(std::uint32_t firstSet, const std::vector<vk::DescriptorSet>& sets);
         void set_constants(vk::ShaderStageFlags shadeStages, std::uint64_t offset, std::uint64_t size, const void* data);
 
-        void bind_vertex_buffer(vk::Buffer buffer);
-        void bind_index_buffer(vk::Buffer buffer, vk::IndexType indexType);
+        void bind_vertex_buffer(vk::Buffer buffer, vk::DeviceSize offset = 0);
+        void bind_index_buffer(vk::Buffer buffer, vk::IndexType indexType, vk::DeviceSize offset = 0);
+        void bind_vertex_buffer(const SubBuffer& subBuffer);
+        void bind_index_buffer(const SubBuffer& subBuffer, vk::IndexType indexType);
 
         void draw(std::uint32_t vertexCount, std::uint32_t instanceCount, std::uint32_t firstVertex, std::uint32_t firstInstance);
         void draw_indexed(std::uint32_t indexCount,
@@ -309,8 +762,70 @@ namespace vgw
 
         void transition_image(const ImageTransitionInfo& transitionInfo);
 
+        /**
+         * Transitions the image from its tracked state, emitting only the barriers that are needed (possibly none).
+         * Tracking happens at record time, so command buffers must be submitted in the order they were recorded.
+         * An empty aspect mask in `subresourceRange` means the whole image.
+         */
+        void require_image_state(vk::Image image,
+                                 vk::ImageLayout layout,
+                                 vk::AccessFlags2 access,
+                                 vk::PipelineStageFlags2 stage,
+                                 const vk::ImageSubresourceRange& subresourceRange = {});
+
+        void buffer_barrier(const BufferBarrierInfo& barrierInfo);
+        void memory_barrier(const MemoryBarrierInfo& barrierInfo);
+
+        /**
+         * When enabled, storage buffers in the bound sets are treated as read/write (or read, if bound `readOnly`) by every dispatch
+         * and the required barriers are inserted automatically. Bindings are taken from `bind_buffer_to_set`. Draws are not tracked,
+         * as barriers cannot be recorded inside a pass; use `buffer_barrier` before `begin_pass` instead.
+         */
+        void set_buffer_hazard_tracking(bool enabled);
+        /**
+         * When disabled, barriers and transitions are still recorded but the tracked image/buffer states are neither read nor updated,
+         * so the command buffer can be recorded on another thread. `require_image_state`, buffer hazard tracking and `resize_buffer`
+         * are unavailable, and the caller is responsible for the final states. Enabled by default.
+         */
+        void set_state_tracking(bool enabled);
+
+        void signal_event(vk::Event event, const EventDependencyInfo& dependency);
+        // Also resets the event, so it can be signalled again by later commands.
+        void wait_event(vk::Event event);
+
+        void release_buffer(const BufferOwnershipTransferInfo& transferInfo);
+        void acquire_buffer(const BufferOwnershipTransferInfo& transferInfo);
+        void release_image(const ImageOwnershipTransferInfo& transferInfo);
+        void acquire_image(const ImageOwnershipTransferInfo& transferInfo);
+
+        void copy_buffer(const CopyBufferInfo& copyInfo);
+        // Copies as much of `srcBuffer` as fits in `dstBuffer`.
+        void copy_buffer(const SubBuffer& srcBuffer, const SubBuffer& dstBuffer);
+        void copy_image(const CopyImageInfo& copyInfo);
         void copy_buffer_to_image(const CopyBufferToImageInfo& copyInfo);
 
+        /**
+         * Creates a buffer of the new size (with the same usage plus `eTransferSrc | eTransferDst`, memory and pool) and records the
+         * copy of the old contents. The old buffer is destroyed when this command buffer is next begun, reset or freed, i.e. once the
+         * copy has retired, so it must not be used after this call. Returns the old buffer when no resize is needed.
+         */
+        auto resize_buffer(const ResizeBufferInfo& resizeInfo) -> std::expected<vk::Buffer, ResultCode>;
+        void copy_image_to_buffer(const CopyImageToBufferInfo& copyInfo);
+
+        /**
+         * Times the commands recorded between begin/end on the GPU. Scopes nest per command buffer and must be ended in the same
+         * command buffer and profiler frame they were begun in. Does nothing if the GPU profiler is not initialised.
+         */
+        void begin_gpu_scope(std::string_view name);
+        void end_gpu_scope();
+
+        /**
+         * Counts samples (occlusion) or pipeline statistics for the commands recorded between begin/end. A query can only be
+         * recorded again once its previous result has been read back.
+         */
+        void begin_query(Query query);
+        void end_query(Query query);
+
         operator vk::CommandBuffer() const noexcept { return m_commandBuffer; }
 
         explicit operator bool() const noexcept { return m_commandBuffer; }
@@ -318,13 +833,22 @@ namespace vgw
         bool operator!() const noexcept { return !m_commandBuffer; }
 
     private:
+        void track_bound_storage_buffers();
         void flush_pending_barriers();
 
     private:
         vk::CommandBuffer m_commandBuffer;
 
         vk::Pipeline m_boundPipeline;
+        std::vector<vk::DescriptorSet> m_boundSets;
+        bool m_bufferHazardTracking{ false };
+        bool m_stateTracking{ true };
+
         std::vector<ImageTransitionInfo> m_pendingImageTransitions;
+        std::vector<BufferBarrierInfo> m_pendingBufferBarriers;
+        std::optional<MemoryBarrierInfo> m_pendingMemoryBarrier;
+
+        std::vector<std::int32_t> m_gpuScopeStack;
     };
 
     struct SubmitInfo
@@ -335,6 +859,9 @@ namespace vgw
         std::vector<vk::PipelineStageFlags> waitStageMasks{};
         std::vector<vk::Semaphore> signalSemaphores{};
         vk::Fence signalFence{};
+        // Timeline semaphore values. If used, must match the semaphore counts (values for binary semaphores are ignored).
+        std::vector<std::uint64_t> waitValues{};
+        std::vector<std::uint64_t> signalValues{};
     };
     void submit(const SubmitInfo& submitInfo);
 
@@ -351,6 +878,117 @@ namespace vgw
     auto create_semaphore() -> std::expected<vk::Semaphore, ResultCode>;
     void destroy_semaphore(vk::Semaphore semaphore);
 
+    /**
+     * Events are pooled: destroyed events are returned to the device's pool and reused by later `create_event` calls, once the command
+     * buffers that signalled or waited on them have completed (are begun again, reset or freed).
+     */
+    auto create_event() -> std::expected<vk::Event, ResultCode>;
+    void destroy_event(vk::Event event);
+
+    auto create_timeline_semaphore(std::uint64_t initialValue) -> std::expected<vk::Semaphore, ResultCode>;
+    auto get_semaphore_value(vk::Semaphore semaphore) -> std::expected<std::uint64_t, ResultCode>;
+    void wait_on_semaphore(vk::Semaphore semaphore, std::uint64_t value);
+
+    struct GpuProfilerInfo
+    {
+        // Number of frames that can be in flight. Timestamps are read back asynchronously, at the latest when a frame's slot is reused.
+        std::uint32_t frameCount{ 3 };
+        std::uint32_t maxScopesPerFrame{ 256 };
+        // Number of resolved frames the rolling min/avg/max of each scope is computed over.
+        std::uint32_t historyLength{ 120 };
+    };
+    auto initialise_gpu_profiler(const GpuProfilerInfo& profilerInfo) -> ResultCode;
+    void destroy_gpu_profiler();
+
+    /**
+     * Starts a new profiler frame. Call once per frame before recording any GPU scopes, after waiting on the fence of the frame
+     * `GpuProfilerInfo::frameCount` frames ago. Finished frames are resolved here without waiting on the GPU.
+     */
+    void begin_gpu_profiler_frame();
+
+    struct GpuScopeTiming
+    {
+        std::string name{};
+        // Index into `GpuFrameReport::scopes`, or -1 for a root scope.
+        std::int32_t parent{ -1 };
+        std::uint32_t depth{};
+        // Relative to the earliest timestamp of the frame.
+        double startMs{};
+        double durationMs{};
+    };
+    struct GpuFrameReport
+    {
+        std::uint64_t frameNumber{};
+        double frameMs{};
+        // In the order the scopes were begun. Parents always come before their children.
+        std::vector<GpuScopeTiming> scopes{};
+    };
+    // The most recently resolved frame.
+    auto get_gpu_frame_report() -> std::optional<GpuFrameReport>;
+    auto format_gpu_frame_report(const GpuFrameReport& report) -> std::string;
+
+    struct GpuScopeStats
+    {
+        // Scope names joined with '/' from the root scope. Durations of scopes sharing a path are summed per frame.
+        std::string path{};
+        double minMs{};
+        double avgMs{};
+        double maxMs{};
+        std::uint32_t sampleCount{};
+    };
+    auto get_gpu_scope_stats() -> std::vector<GpuScopeStats>;
+
+    /**
+     * API call counters since the last `reset_frame_stats()`, typically called once per frame. Counters are global and always on.
+     * Resources are buffers, images, image views, pipelines, render passes, fences, semaphores, events and queries.
+     */
+    struct FrameStats
+    {
+        std::uint64_t draws{};
+        std::uint64_t dispatches{};
+        std::uint64_t pipelineBinds{};
+        std::uint64_t setBinds{};
+        std::uint64_t pushConstantUpdates{};
+        std::uint64_t barrierFlushes{};
+        std::uint64_t imageBarriers{};
+        std::uint64_t bufferBarriers{};
+        std::uint64_t memoryBarriers{};
+        std::uint64_t maxImageBarriersPerFlush{};
+        std::uint64_t descriptorWrites{};
+        std::uint64_t descriptorUpdateCalls{};
+        std::uint64_t bufferMaps{};
+        std::uint64_t bufferUnmaps{};
+        std::uint64_t submits{};
+        std::uint64_t resourcesCreated{};
+        std::uint64_t resourcesDestroyed{};
+    };
+    auto get_frame_stats() -> FrameStats;
+    void reset_frame_stats();
+
+    /**
+     * Queries are allocated from pooled query pools of the matching type. Pipeline statistics recorded on a queue without graphics
+     * support only count `computeShaderInvocations`.
+     */
+    auto create_query(QueryType type) -> std::expected<Query, ResultCode>;
+    void destroy_query(Query query);
+
+    struct PipelineStatistics
+    {
+        std::uint64_t inputAssemblyVertices{};
+        std::uint64_t inputAssemblyPrimitives{};
+        std::uint64_t vertexShaderInvocations{};
+        std::uint64_t clippingInvocations{};
+        std::uint64_t clippingPrimitives{};
+        std::uint64_t fragmentShaderInvocations{};
+        std::uint64_t computeShaderInvocations{};
+    };
+    /**
+     * Never waits on the GPU. Returns nothing while the result is not available yet, so poll again in a later frame.
+     * Once a result has been returned the query can be recorded again.
+     */
+    auto get_occlusion_result(Query query) -> std::optional<std::uint64_t>;
+    auto get_pipeline_statistics(Query query) -> std::optional<PipelineStatistics>;
+
 }
 
 namespace std
@@ -1,9 +1,70 @@
 #include "internal_buffers.hpp"
 
 #include "internal_device.hpp"
+#include "internal_memory.hpp"
+#include "internal_stats.hpp"
+#include "internal_synchronisation.hpp"
+
+#include <algorithm>
 
 namespace vgw::internal
 {
+    namespace
+    {
+        /**
+         * Size of the shared buffers sub-allocated buffers are carved out of. Larger requests get a shared buffer of their own size,
+         * which is released once it is empty.
+         */
+        constexpr vk::DeviceSize SUBALLOCATION_BLOCK_SIZE = 4ull * 1024 * 1024;
+
+        auto make_buffer_create_info(const BufferInfo& bufferInfo) -> vk::BufferCreateInfo
+        {
+            vk::BufferCreateInfo bufferCreateInfo{};
+            bufferCreateInfo.setSize(bufferInfo.size);
+            bufferCreateInfo.setUsage(bufferInfo.usage);
+            return bufferCreateInfo;
+        }
+
+        auto get_suballocation_key(const BufferInfo& bufferInfo) -> SubAllocationKey
+        {
+            return {
+                .usage = bufferInfo.usage,
+                .memUsage = bufferInfo.memUsage,
+                .allocFlags = bufferInfo.allocFlags,
+                .pool = bufferInfo.pool,
+                .priority = bufferInfo.memoryHints.priority,
+                .hostVisibleDeviceLocal = bufferInfo.memoryHints.hostVisibleDeviceLocal,
+            };
+        }
+
+        // Sub-allocations start at offsets that can be bound as any of the buffer's descriptor types and flushed independently.
+        auto get_suballocation_alignment(const DeviceData& deviceRef, const BufferInfo& bufferInfo) -> vk::DeviceSize
+        {
+            const auto limits = deviceRef.physicalDevice.getProperties().limits;
+
+            vk::DeviceSize alignment{ 16 };
+            if (bufferInfo.usage & vk::BufferUsageFlagBits::eUniformBuffer)
+            {
+                alignment = std::max(alignment, limits.minUniformBufferOffsetAlignment);
+            }
+            if (bufferInfo.usage & vk::BufferUsageFlagBits::eStorageBuffer)
+            {
+                alignment = std::max(alignment, limits.minStorageBufferOffsetAlignment);
+            }
+            if (bufferInfo.usage & (vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer))
+            {
+                alignment = std::max(alignment, limits.minTexelBufferOffsetAlignment);
+            }
+            constexpr VmaAllocationCreateFlags HostAccessFlags =
+                VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+            if (bufferInfo.allocFlags & HostAccessFlags)
+            {
+                alignment = std::max(alignment, limits.nonCoherentAtomSize);
+            }
+            return alignment;
+        }
+    }
+
     auto internal_buffer_create(const BufferInfo& bufferInfo) -> std::expected<vk::Buffer, ResultCode>
     {
         auto deviceResult = internal_device_get();
@@ -13,16 +74,50 @@ namespace vgw::internal
         }
         auto& deviceRef = deviceResult.value().get();
 
+        if ((bufferInfo.usage & vk::BufferUsageFlagBits::eShaderDeviceAddress) && !deviceRef.isBufferDeviceAddressEnabled)
+        {
+            log_error("Cannot create buffer with eShaderDeviceAddress usage. The bufferDeviceAddress feature is not supported!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        if (bufferInfo.aliasing.heap)
+        {
+            auto requirementsResult = internal_buffer_memory_requirements_get(bufferInfo);
+            if (!requirementsResult)
+            {
+                return std::unexpected(requirementsResult.error());
+            }
+            auto allocationResult = internal_aliasing_heap_allocation_get(bufferInfo.aliasing, requirementsResult.value());
+            if (!allocationResult)
+            {
+                return std::unexpected(allocationResult.error());
+            }
+            return internal_buffer_create_aliased(bufferInfo, allocationResult.value(), bufferInfo.aliasing.offset);
+        }
+
         VkBuffer vkBuffer{};
         VmaAllocation allocation{};
 
-        vk::BufferCreateInfo bufferCreateInfo{};
-        bufferCreateInfo.setSize(bufferInfo.size);
-        bufferCreateInfo.setUsage(bufferInfo.usage);
+        const auto bufferCreateInfo = make_buffer_create_info(bufferInfo);
 
         VmaAllocationCreateInfo allocCreateInfo{};
         allocCreateInfo.usage = bufferInfo.memUsage;
         allocCreateInfo.flags = bufferInfo.allocFlags;
+        if (bufferInfo.pool)
+        {
+            auto poolResult = internal_memory_pool_get(bufferInfo.pool);
+            if (!poolResult)
+            {
+                log_error("Unknown memory pool!");
+                return std::unexpected(poolResult.error());
+            }
+            allocCreateInfo.pool = poolResult.value().get().pool;
+        }
+        const auto hintsResult = internal_memory_hints_apply(bufferInfo.memoryHints, allocCreateInfo);
+        if (hintsResult != ResultCode::eSuccess)
+        {
+            return std::unexpected(hintsResult);
+        }
 
         VkBufferCreateInfo vkBufferCreateInfo = bufferCreateInfo;
         auto createResult = vmaCreateBuffer(deviceRef.allocator, &vkBufferCreateInfo, &allocCreateInfo, &vkBuffer, &allocation, nullptr);
@@ -33,10 +128,62 @@ namespace vgw::internal
         }
 
         const vk::Buffer buffer = vkBuffer;
-        deviceRef.bufferMap[buffer] = { buffer, allocation };
+        deviceRef.bufferMap[buffer] = { buffer, allocation, {}, bufferInfo };
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
         return buffer;
     }
 
+    auto internal_buffer_create_aliased(const BufferInfo& bufferInfo, VmaAllocation allocation, vk::DeviceSize offset)
+        -> std::expected<vk::Buffer, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto bufferCreateInfo = make_buffer_create_info(bufferInfo);
+        auto createResult = deviceRef.device.createBuffer(bufferCreateInfo);
+        if (createResult.result != vk::Result::eSuccess)
+        {
+            log_error("Failed to create vk::Buffer!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        const auto buffer = createResult.value;
+
+        auto bindResult = vmaBindBufferMemory2(deviceRef.allocator, allocation, offset, buffer, nullptr);
+        if (bindResult != VK_SUCCESS)
+        {
+            deviceRef.device.destroy(buffer);
+            log_error("Failed to bind vk::Buffer to VmaAllocation at offset {}!", offset);
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        // No allocation is stored, so destroying the buffer leaves the shared allocation alive.
+        deviceRef.bufferMap[buffer] = { buffer, nullptr, {}, bufferInfo };
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
+        return buffer;
+    }
+
+    auto internal_buffer_memory_requirements_get(const BufferInfo& bufferInfo) -> std::expected<vk::MemoryRequirements, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto bufferCreateInfo = make_buffer_create_info(bufferInfo);
+        const vk::DeviceBufferMemoryRequirements requirementsInfo{ &bufferCreateInfo };
+        return deviceRef.device.getBufferMemoryRequirements(requirementsInfo).memoryRequirements;
+    }
+
     void internal_buffer_destroy(vk::Buffer buffer)
     {
         auto deviceResult = internal_device_get();
@@ -54,9 +201,141 @@ namespace vgw::internal
             return;
         }
         auto& bufferRef = bufferResult.value().get();
+        if (deviceRef.subAllocationBlockMap.contains(buffer))
+        {
+            log_error("Cannot destroy a buffer shared by sub-allocated buffers!");
+            return;
+        }
 
         vmaDestroyBuffer(deviceRef.allocator, buffer, bufferRef.allocation);
         deviceRef.bufferMap.erase(buffer);
+        internal_stats_add(internal_stats_get().resourcesDestroyed);
+    }
+
+    auto internal_suballocated_buffer_create(const BufferInfo& bufferInfo) -> std::expected<SubBuffer, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        if (bufferInfo.size == 0)
+        {
+            log_error("Cannot create a sub-allocated buffer with a size of 0!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        if (bufferInfo.aliasing.heap)
+        {
+            log_error("Sub-allocated buffers cannot be placed in an aliasing heap!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        if (bufferInfo.memoryHints.dedicated)
+        {
+            log_error("Sub-allocated buffers cannot use dedicated memory!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        const auto key = get_suballocation_key(bufferInfo);
+
+        VmaVirtualAllocationCreateInfo allocCreateInfo{};
+        allocCreateInfo.size = bufferInfo.size;
+        allocCreateInfo.alignment = get_suballocation_alignment(deviceRef, bufferInfo);
+
+        VmaVirtualAllocation allocation{};
+        vk::DeviceSize offset{};
+        for (const auto& [buffer, blockData] : deviceRef.subAllocationBlockMap)
+        {
+            if (blockData.key == key && vmaVirtualAllocate(blockData.block, &allocCreateInfo, &allocation, &offset) == VK_SUCCESS)
+            {
+                return SubBuffer{ buffer, offset, bufferInfo.size, allocation };
+            }
+        }
+
+        // None of the shared buffers have room, so add another.
+        auto blockInfo = bufferInfo;
+        blockInfo.size = std::max<vk::DeviceSize>(bufferInfo.size, SUBALLOCATION_BLOCK_SIZE);
+        auto bufferResult = internal_buffer_create(blockInfo);
+        if (!bufferResult)
+        {
+            return std::unexpected(bufferResult.error());
+        }
+        const auto buffer = bufferResult.value();
+
+        VmaVirtualBlockCreateInfo blockCreateInfo{};
+        blockCreateInfo.size = blockInfo.size;
+        VmaVirtualBlock block{};
+        if (vmaCreateVirtualBlock(&blockCreateInfo, &block) != VK_SUCCESS)
+        {
+            log_error("Failed to create sub-allocation block!");
+            internal_buffer_destroy(buffer);
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        deviceRef.subAllocationBlockMap[buffer] = { block, blockInfo.size, key };
+        log_debug("Sub-allocation block created ({} bytes).", blockInfo.size);
+
+        if (vmaVirtualAllocate(block, &allocCreateInfo, &allocation, &offset) != VK_SUCCESS)
+        {
+            log_error("Failed to sub-allocate buffer from a new sub-allocation block!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        return SubBuffer{ buffer, offset, bufferInfo.size, allocation };
+    }
+
+    void internal_suballocated_buffer_destroy(const SubBuffer& subBuffer)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.subAllocationBlockMap.find(subBuffer.buffer);
+        if (it == deviceRef.subAllocationBlockMap.end() || subBuffer.allocation == VK_NULL_HANDLE)
+        {
+            log_warn("Tried to destroy unknown sub-allocated buffer.");
+            return;
+        }
+
+        const auto blockData = it->second;
+        vmaVirtualFree(blockData.block, subBuffer.allocation);
+        if (vmaIsVirtualBlockEmpty(blockData.block) == VK_FALSE)
+        {
+            return;
+        }
+
+        // One empty shared buffer of the default size is kept per key for later sub-allocations; oversized and spare ones are released.
+        const auto hasSpareBlock = std::ranges::any_of(deviceRef.subAllocationBlockMap,
+                                                       [&](const auto& entry)
+                                                       {
+                                                           return entry.first != subBuffer.buffer && entry.second.key == blockData.key &&
+                                                                  entry.second.size == SUBALLOCATION_BLOCK_SIZE &&
+                                                                  vmaIsVirtualBlockEmpty(entry.second.block) == VK_TRUE;
+                                                       });
+        if (blockData.size == SUBALLOCATION_BLOCK_SIZE && !hasSpareBlock)
+        {
+            return;
+        }
+
+        // Removed from the map first, as `internal_buffer_destroy()` refuses shared buffers.
+        deviceRef.subAllocationBlockMap.erase(it);
+        vmaDestroyVirtualBlock(blockData.block);
+        internal_buffer_destroy(subBuffer.buffer);
+        log_debug("Sub-allocation block released ({} bytes).", blockData.size);
+    }
+
+    auto internal_buffer_is_suballocation_block(vk::Buffer buffer) -> bool
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            return false;
+        }
+        return deviceResult.value().get().subAllocationBlockMap.contains(buffer);
     }
 
     auto internal_buffer_get(vk::Buffer buffer) -> std::expected<std::reference_wrapper<BufferData>, ResultCode>
@@ -77,6 +356,80 @@ namespace vgw::internal
         return it->second;
     }
 
+    auto internal_buffer_require_access(vk::Buffer buffer, const BufferAccessState& wantedState)
+        -> std::expected<std::optional<BufferBarrierInfo>, ResultCode>
+    {
+        auto bufferResult = internal_buffer_get(buffer);
+        if (!bufferResult)
+        {
+            return std::unexpected(bufferResult.error());
+        }
+        auto& state = bufferResult.value().get().accessState;
+
+        const bool writeHazard = is_write_access(state.access) || is_write_access(wantedState.access);
+        const bool alreadyVisible =
+            (state.access & wantedState.access) == wantedState.access && (state.stage & wantedState.stage) == wantedState.stage;
+        if (!writeHazard && alreadyVisible)
+        {
+            return std::nullopt;
+        }
+
+        BufferBarrierInfo barrierInfo{
+            .buffer = buffer,
+            .srcAccess = get_write_access(state.access),
+            .dstAccess = wantedState.access,
+            .srcStage = state.stage,
+            .dstStage = wantedState.stage,
+        };
+
+        if (writeHazard)
+        {
+            state = wantedState;
+        }
+        else
+        {
+            state.access |= wantedState.access;
+            state.stage |= wantedState.stage;
+        }
+        return barrierInfo;
+    }
+
+    void internal_buffer_access_set(vk::Buffer buffer, const BufferAccessState& state)
+    {
+        auto bufferResult = internal_buffer_get(buffer);
+        if (!bufferResult)
+        {
+            return;
+        }
+        bufferResult.value().get().accessState = state;
+    }
+
+    auto internal_buffer_address_get(vk::Buffer buffer) -> std::expected<vk::DeviceAddress, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        auto bufferResult = internal_buffer_get(buffer);
+        if (!bufferResult)
+        {
+            log_error("Cannot get address of unknown buffer!");
+            return std::unexpected(ResultCode::eInvalidHandle);
+        }
+        if (!(bufferResult.value().get().info.usage & vk::BufferUsageFlagBits::eShaderDeviceAddress))
+        {
+            log_error("Cannot get address of a buffer created without eShaderDeviceAddress usage!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+
+        const vk::BufferDeviceAddressInfo addressInfo{ buffer };
+        return deviceRef.device.getBufferAddress(addressInfo);
+    }
+
     auto internal_buffer_map(vk::Buffer buffer) -> std::expected<void*, ResultCode>
     {
         auto deviceResult = internal_device_get();
@@ -94,6 +447,11 @@ namespace vgw::internal
             return std::unexpected(ResultCode::eInvalidHandle);
         }
         auto& bufferRef = bufferResult.value().get();
+        if (!bufferRef.allocation)
+        {
+            log_error("Cannot map a buffer placed in an aliasing heap!");
+            return std::unexpected(ResultCode::eFailedToMapMemory);
+        }
 
         void* dataPtr{ nullptr };
         auto mapResult = vmaMapMemory(deviceRef.allocator, bufferRef.allocation, &dataPtr);
@@ -103,6 +461,7 @@ namespace vgw::internal
             return std::unexpected(ResultCode::eFailedToMapMemory);
         }
 
+        internal_stats_add(internal_stats_get().bufferMaps);
         return dataPtr;
     }
 
@@ -123,8 +482,13 @@ namespace vgw::internal
             return;
         }
         auto& bufferRef = bufferResult.value().get();
+        if (!bufferRef.allocation)
+        {
+            return;
+        }
 
         vmaUnmapMemory(deviceRef.allocator, bufferRef.allocation);
+        internal_stats_add(internal_stats_get().bufferUnmaps);
     }
 
 }
\ No newline at end of file
@@ -3,19 +3,67 @@
 #include "vgw/vgw.hpp"
 #include "internal_core.hpp"
 
+#include <optional>
+
 namespace vgw::internal
 {
+    struct BufferAccessState
+    {
+        vk::AccessFlags2 access{};
+        vk::PipelineStageFlags2 stage{};
+    };
+
     struct BufferData
     {
         vk::Buffer buffer{};
         VmaAllocation allocation{};
+        // Last known access of the whole buffer. Updated at record time.
+        BufferAccessState accessState{};
+        // What the buffer was created with, so it can be recreated (e.g. when defragmentation moves it).
+        BufferInfo info{};
+    };
+
+    // The buffer info fields that decide which sub-allocations can share a buffer.
+    struct SubAllocationKey
+    {
+        vk::BufferUsageFlags usage{};
+        VmaMemoryUsage memUsage{};
+        VmaAllocationCreateFlags allocFlags{};
+        MemoryPool pool{};
+        float priority{};
+        bool hostVisibleDeviceLocal{};
+
+        auto operator==(const SubAllocationKey&) const -> bool = default;
+    };
+
+    // A shared buffer that sub-allocated buffers are carved out of. The buffer itself is in `bufferMap`.
+    struct SubAllocationBlockData
+    {
+        VmaVirtualBlock block{};
+        vk::DeviceSize size{};
+        SubAllocationKey key{};
     };
 
     auto internal_buffer_create(const BufferInfo& bufferInfo) -> std::expected<vk::Buffer, ResultCode>;
+    // Creates a buffer bound to `allocation` at `offset`. The allocation is not owned by the buffer.
+    auto internal_buffer_create_aliased(const BufferInfo& bufferInfo, VmaAllocation allocation, vk::DeviceSize offset)
+        -> std::expected<vk::Buffer, ResultCode>;
+    auto internal_buffer_memory_requirements_get(const BufferInfo& bufferInfo) -> std::expected<vk::MemoryRequirements, ResultCode>;
     void internal_buffer_destroy(vk::Buffer buffer);
 
+    auto internal_suballocated_buffer_create(const BufferInfo& bufferInfo) -> std::expected<SubBuffer, ResultCode>;
+    void internal_suballocated_buffer_destroy(const SubBuffer& subBuffer);
+    // Whether sub-allocated buffers are carved out of the buffer, which must then outlive them.
+    auto internal_buffer_is_suballocation_block(vk::Buffer buffer) -> bool;
+
     auto internal_buffer_get(vk::Buffer buffer) -> std::expected<std::reference_wrapper<BufferData>, ResultCode>;
 
+    auto internal_buffer_require_access(vk::Buffer buffer, const BufferAccessState& wantedState)
+        -> std::expected<std::optional<BufferBarrierInfo>, ResultCode>;
+    void internal_buffer_access_set(vk::Buffer buffer, const BufferAccessState& state);
+
+    auto internal_buffer_address_get(vk::Buffer buffer) -> std::expected<vk::DeviceAddress, ResultCode>;
+
     auto internal_buffer_map(vk::Buffer buffer) -> std::expected<void*, ResultCode>;
     void internal_buffer_unmap(vk::Buffer buffer);
 }
\ No newline at end of file
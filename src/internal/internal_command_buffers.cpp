@@ -1,10 +1,14 @@
 #include "internal_command_buffers.hpp"
 
 #include "internal_device.hpp"
+#include "internal_stats.hpp"
+
+#include <algorithm>
 
 namespace vgw::internal
 {
-    auto internal_cmd_pool_get(vk::CommandPoolCreateFlagBits poolFlags) -> std::expected<vk::CommandPool, ResultCode>
+    auto internal_cmd_pool_get(vk::CommandPoolCreateFlagBits poolFlags, std::uint32_t queueIndex, std::uint32_t poolIndex)
+        -> std::expected<vk::CommandPool, ResultCode>
     {
         auto deviceResult = internal_device_get();
         if (!deviceResult)
@@ -13,7 +17,21 @@ namespace vgw::internal
         }
         auto& deviceRef = deviceResult.value().get();
 
-        const auto it = deviceRef.cmdPoolMap.find(poolFlags);
+        auto familyResult = internal_queue_family_get(queueIndex);
+        if (!familyResult)
+        {
+            log_error("Cannot create vk::CommandPool for invalid queue index {}!", queueIndex);
+            return std::unexpected(familyResult.error());
+        }
+        const auto queueFamily = familyResult.value();
+
+        const CmdPoolKey poolKey{
+            .flags = static_cast<VkCommandPoolCreateFlags>(vk::CommandPoolCreateFlags(poolFlags)),
+            .queueFamily = queueFamily,
+            .poolIndex = poolIndex,
+        };
+
+        const auto it = deviceRef.cmdPoolMap.find(poolKey);
         if (it != deviceRef.cmdPoolMap.end())
         {
             const auto cmdPool = it->second;
@@ -22,6 +40,7 @@ namespace vgw::internal
 
         vk::CommandPoolCreateInfo poolCreateInfo{};
         poolCreateInfo.setFlags(poolFlags);
+        poolCreateInfo.setQueueFamilyIndex(queueFamily);
         auto createResult = deviceRef.device.createCommandPool(poolCreateInfo);
         if (createResult.result != vk::Result::eSuccess)
         {
@@ -29,7 +48,7 @@ namespace vgw::internal
             return std::unexpected(ResultCode::eFailedToCreate);
         }
 
-        deviceRef.cmdPoolMap[poolFlags] = createResult.value;
+        deviceRef.cmdPoolMap[poolKey] = createResult.value;
         return createResult.value;
     }
 
@@ -42,13 +61,19 @@ namespace vgw::internal
         }
         auto& deviceRef = deviceResult.value().get();
 
-        auto poolResult = internal_cmd_pool_get(allocInfo.poolFlags);
+        auto poolResult = internal_cmd_pool_get(allocInfo.poolFlags, allocInfo.queueIndex, allocInfo.poolIndex);
         if (!poolResult)
         {
             return std::unexpected(poolResult.error());
         }
         const auto pool = poolResult.value();
 
+        vk::QueueFlags queueFlags{};
+        if (auto familyResult = internal_queue_family_get(allocInfo.queueIndex))
+        {
+            queueFlags = deviceRef.physicalDevice.getQueueFamilyProperties().at(familyResult.value()).queueFlags;
+        }
+
         vk::CommandBufferAllocateInfo allocCreateInfo{};
         allocCreateInfo.setCommandPool(pool);
         allocCreateInfo.setCommandBufferCount(allocInfo.count);
@@ -67,7 +92,7 @@ namespace vgw::internal
         std::vector<CommandBuffer> outCmdBuffers{};
         for (auto cmd : cmdBuffers)
         {
-            deviceRef.cmdBufferMap[cmd] = CmdBufferData{ pool, std::make_unique<CommandBuffer_T>(cmd) };
+            deviceRef.cmdBufferMap[cmd] = CmdBufferData{ pool, std::make_unique<CommandBuffer_T>(cmd), queueFlags };
             outCmdBuffers.push_back(deviceRef.cmdBufferMap.at(cmd).cmd.get());
         }
         return outCmdBuffers;
@@ -86,12 +111,93 @@ namespace vgw::internal
         {
             auto vkCmd = static_cast<vk::CommandBuffer>(*cmd);
             auto pool = deviceRef.cmdBufferMap.at(vkCmd).pool;
+            internal_cmd_buffer_retired_release(vkCmd);
 
             deviceRef.device.free(pool, vkCmd);
             deviceRef.cmdBufferMap.erase(vkCmd);
         }
     }
 
+    void internal_cmd_buffer_retire_buffer(vk::CommandBuffer cmd, vk::Buffer buffer)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.cmdBufferMap.find(cmd);
+        if (it == deviceRef.cmdBufferMap.end())
+        {
+            // Not allocated through vgw, so there is no way to tell when it retires.
+            log_warn("Buffer retired by unknown command buffer. It will be destroyed immediately.");
+            internal_buffer_destroy(buffer);
+            return;
+        }
+        it->second.retiredBuffers.push_back(buffer);
+    }
+
+    void internal_cmd_buffer_use_event(vk::CommandBuffer cmd, vk::Event event)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.cmdBufferMap.find(cmd);
+        if (it == deviceRef.cmdBufferMap.end())
+        {
+            // Not allocated through vgw, so the caller must wait for it before destroying the event.
+            return;
+        }
+        if (std::ranges::find(it->second.usedEvents, event) == it->second.usedEvents.end())
+        {
+            it->second.usedEvents.push_back(event);
+            ++deviceRef.eventUseCounts[event];
+        }
+    }
+
+    void internal_cmd_buffer_retired_release(vk::CommandBuffer cmd)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.cmdBufferMap.find(cmd);
+        if (it == deviceRef.cmdBufferMap.end())
+        {
+            return;
+        }
+        for (auto buffer : it->second.retiredBuffers)
+        {
+            internal_buffer_destroy(buffer);
+        }
+        it->second.retiredBuffers.clear();
+
+        for (auto event : it->second.usedEvents)
+        {
+            const auto countIt = deviceRef.eventUseCounts.find(event);
+            if (countIt == deviceRef.eventUseCounts.end() || --countIt->second > 0)
+            {
+                continue;
+            }
+            deviceRef.eventUseCounts.erase(countIt);
+            if (deviceRef.retiredEvents.erase(event) > 0)
+            {
+                deviceRef.freeEvents.push_back(event);
+            }
+        }
+        it->second.usedEvents.clear();
+    }
+
     void internal_submit(const SubmitInfo& submitInfo)
     {
         auto deviceResult = internal_device_get();
@@ -109,6 +215,16 @@ namespace vgw::internal
         vkSubmitInfo.setWaitSemaphores(submitInfo.waitSemaphores);
         vkSubmitInfo.setWaitDstStageMask(submitInfo.waitStageMasks);
         vkSubmitInfo.setSignalSemaphores(submitInfo.signalSemaphores);
+
+        vk::TimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+        if (!submitInfo.waitValues.empty() || !submitInfo.signalValues.empty())
+        {
+            timelineSubmitInfo.setWaitSemaphoreValues(submitInfo.waitValues);
+            timelineSubmitInfo.setSignalSemaphoreValues(submitInfo.signalValues);
+            vkSubmitInfo.setPNext(&timelineSubmitInfo);
+        }
+
         queue.submit(vkSubmitInfo, submitInfo.signalFence);
+        internal_stats_add(internal_stats_get().submits);
     }
 }
\ No newline at end of file
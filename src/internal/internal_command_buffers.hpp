@@ -7,15 +7,47 @@
 
 namespace vgw::internal
 {
-    auto internal_cmd_pool_get(vk::CommandPoolCreateFlagBits poolFlags) -> std::expected<vk::CommandPool, ResultCode>;
+    // Command pools are shared by the command buffers allocated with the same flags, queue family and pool index.
+    struct CmdPoolKey
+    {
+        VkCommandPoolCreateFlags flags{};
+        std::uint32_t queueFamily{};
+        std::uint32_t poolIndex{};
+
+        auto operator==(const CmdPoolKey&) const -> bool = default;
+    };
+    struct CmdPoolKeyHash
+    {
+        auto operator()(const CmdPoolKey& key) const noexcept -> std::size_t
+        {
+            std::size_t seed{ 0 };
+            hash_combine(seed, key.flags);
+            hash_combine(seed, key.queueFamily);
+            hash_combine(seed, key.poolIndex);
+            return seed;
+        }
+    };
+
+    auto internal_cmd_pool_get(vk::CommandPoolCreateFlagBits poolFlags, std::uint32_t queueIndex, std::uint32_t poolIndex)
+        -> std::expected<vk::CommandPool, ResultCode>;
 
     struct CmdBufferData
     {
         vk::CommandPool pool{};
         std::unique_ptr<CommandBuffer_T> cmd{};
+        // Capabilities of the queue family the command buffer is submitted to.
+        vk::QueueFlags queueFlags{};
+        // Destroyed once the command buffer's last submission has completed (when it is next begun, reset or freed).
+        std::vector<vk::Buffer> retiredBuffers{};
+        // Events recorded since then. Destroyed events are only recycled once no command buffer uses them.
+        std::vector<vk::Event> usedEvents{};
     };
     auto internal_cmd_buffers_allocate(const CmdBufferAllocInfo& allocInfo) -> std::expected<std::vector<CommandBuffer>, ResultCode>;
     void internal_cmd_buffers_free(const std::vector<CommandBuffer>& cmdBuffers);
 
+    void internal_cmd_buffer_retire_buffer(vk::CommandBuffer cmd, vk::Buffer buffer);
+    void internal_cmd_buffer_use_event(vk::CommandBuffer cmd, vk::Event event);
+    void internal_cmd_buffer_retired_release(vk::CommandBuffer cmd);
+
     void internal_submit(const SubmitInfo& submitInfo);
 }
\ No newline at end of file
@@ -85,16 +85,19 @@ namespace vgw::internal
             }
         }
 
-        log_debug("Enabled layers:");
-        for (const auto& layer : enabledLayers)
+        if (is_log_enabled(MessageType::eDebug))
         {
-            log_debug("  {}", layer);
-        }
-
-        log_debug("Enabled extensions:");
-        for (const auto& extension : enabledExtensions)
-        {
-            log_info("  {}", extension);
+            std::string layerList{};
+            for (const auto& layer : enabledLayers)
+            {
+                layerList += std::format("\n  {}", layer);
+            }
+            std::string extensionList{};
+            for (const auto& extension : enabledExtensions)
+            {
+                extensionList += std::format("\n  {}", extension);
+            }
+            log_debug("Enabled layers:{}\nEnabled instance extensions:{}", layerList, extensionList);
         }
 
 #pragma endregion
@@ -1,19 +1,253 @@
 #include "internal_core.hpp"
 
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstring>
+
 VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE;  // NOLINT(*-avoid-non-const-global-variables)
 
 namespace vgw::internal
 {
-    static MessageCallbackFn s_messageCallbackFn{};  // NOLINT(*-avoid-non-const-global-variables)
+    namespace
+    {
+        struct AsyncMessageSlot
+        {
+            std::atomic<std::uint64_t> sequence{};
+            MessageType type{};
+            std::uint32_t length{};
+            std::array<char, ASYNC_MESSAGE_SIZE> text{};
+        };
+
+        /**
+         * Bounded multi-producer/single-consumer queue (Vyukov). A slot's sequence equals its write position when free and the
+         * position + 1 once written, so producers only contend on `writePos` and never wait on the sink thread.
+         */
+        class AsyncMessageSink
+        {
+        public:
+            AsyncMessageSink()
+            {
+                for (std::uint64_t i = 0; i < m_slots.size(); ++i)
+                {
+                    m_slots[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+            ~AsyncMessageSink() { stop(); }
+
+            AsyncMessageSink(const AsyncMessageSink&) = delete;
+            auto operator=(const AsyncMessageSink&) -> AsyncMessageSink& = delete;
+
+            void start()
+            {
+                std::lock_guard lock(m_controlMutex);
+                if (m_thread.joinable())
+                {
+                    return;
+                }
+                m_stopRequested.store(false, std::memory_order_relaxed);
+                m_thread = std::thread([this] { run(); });
+            }
+
+            // Delivers the queued messages before returning.
+            void stop()
+            {
+                std::lock_guard lock(m_controlMutex);
+                if (!m_thread.joinable())
+                {
+                    return;
+                }
+                m_stopRequested.store(true, std::memory_order_release);
+                m_pushCount.fetch_add(1, std::memory_order_release);
+                m_pushCount.notify_one();
+                m_thread.join();
+            }
+
+            auto push(MessageType msgType, std::string_view msg) -> bool
+            {
+                auto pos = m_writePos.load(std::memory_order_relaxed);
+                AsyncMessageSlot* slot{ nullptr };
+                while (true)
+                {
+                    slot = &m_slots[pos % m_slots.size()];
+                    const auto sequence = slot->sequence.load(std::memory_order_acquire);
+                    const auto diff = std::int64_t(sequence) - std::int64_t(pos);
+                    if (diff == 0)
+                    {
+                        if (m_writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        {
+                            break;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    else
+                    {
+                        pos = m_writePos.load(std::memory_order_relaxed);
+                    }
+                }
+
+                slot->type = msgType;
+                slot->length = std::uint32_t(std::min(msg.size(), slot->text.size()));
+                std::memcpy(slot->text.data(), msg.data(), slot->length);
+                slot->sequence.store(pos + 1, std::memory_order_release);
+
+                m_pushCount.fetch_add(1, std::memory_order_release);
+                m_pushCount.notify_one();
+                return true;
+            }
+
+            // Waits until every message pushed before the call has been delivered.
+            void flush()
+            {
+                const auto target = m_writePos.load(std::memory_order_acquire);
+                while (m_thread.joinable() && m_deliveredPos.load(std::memory_order_acquire) < target)
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+        private:
+            void run()
+            {
+                while (true)
+                {
+                    const auto pushCount = m_pushCount.load(std::memory_order_acquire);
+                    while (pop_and_deliver())
+                    {
+                    }
+
+                    const auto droppedCount = m_droppedCount.exchange(0, std::memory_order_relaxed);
+                    const auto callbackFn = get_message_callback();
+                    if (droppedCount > 0 && callbackFn)
+                    {
+                        const auto msg = std::format("{} async messages were dropped (queue full).", droppedCount);
+                        (*callbackFn)(MessageType::eWarning, msg);
+                    }
+
+                    if (m_stopRequested.load(std::memory_order_acquire))
+                    {
+                        // Messages pushed while stopping are still delivered.
+                        while (pop_and_deliver())
+                        {
+                        }
+                        return;
+                    }
+                    m_pushCount.wait(pushCount, std::memory_order_acquire);
+                }
+            }
+
+            auto pop_and_deliver() -> bool
+            {
+                const auto pos = m_readPos;
+                auto& slot = m_slots[pos % m_slots.size()];
+                if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+                {
+                    return false;
+                }
+
+                if (const auto callbackFn = get_message_callback())
+                {
+                    (*callbackFn)(slot.type, { slot.text.data(), slot.length });
+                }
+
+                // Free the slot for the producer one lap ahead.
+                slot.sequence.store(pos + m_slots.size(), std::memory_order_release);
+                m_readPos = pos + 1;
+                m_deliveredPos.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+        private:
+            std::array<AsyncMessageSlot, ASYNC_MESSAGE_QUEUE_SIZE> m_slots{};
+            std::atomic<std::uint64_t> m_writePos{ 0 };
+            // Only used by the sink thread.
+            std::uint64_t m_readPos{ 0 };
+            std::atomic<std::uint64_t> m_deliveredPos{ 0 };
+            std::atomic<std::uint64_t> m_droppedCount{ 0 };
+
+            // Incremented on every push, for the sink thread to wait on.
+            std::atomic<std::uint32_t> m_pushCount{ 0 };
+            std::atomic<bool> m_stopRequested{ false };
+
+            std::mutex m_controlMutex{};
+            std::thread m_thread{};
+        };
+
+        auto get_async_sink() -> AsyncMessageSink&
+        {
+            static AsyncMessageSink sink{};
+            return sink;
+        }
+    }
+
+    static std::atomic<std::shared_ptr<const MessageCallbackFn>> s_messageCallbackFn{};  // NOLINT(*-avoid-non-const-global-variables)
+    // Checked by every log call, so filtered messages do not touch the shared pointer.
+    static std::atomic<bool> s_hasMessageCallback{ false };  // NOLINT(*-avoid-non-const-global-variables)
+    static std::atomic<MessageType> s_messageLevel{ MessageType::eDebug };  // NOLINT(*-avoid-non-const-global-variables)
+    static std::atomic<bool> s_asyncMessages{ false };                      // NOLINT(*-avoid-non-const-global-variables)
 
     void set_message_callback(const MessageCallbackFn& callbackFn)
     {
-        s_messageCallbackFn = callbackFn;
+        // Messages queued before the change go to the previous callback.
+        flush_messages();
+        s_messageCallbackFn.store(callbackFn ? std::make_shared<const MessageCallbackFn>(callbackFn) : nullptr, std::memory_order_release);
+        s_hasMessageCallback.store(bool(callbackFn), std::memory_order_release);
+    }
+
+    auto get_message_callback() -> std::shared_ptr<const MessageCallbackFn>
+    {
+        return s_messageCallbackFn.load(std::memory_order_acquire);
+    }
+
+    auto has_message_callback() -> bool
+    {
+        return s_hasMessageCallback.load(std::memory_order_acquire);
+    }
+
+    void set_message_level(MessageType minLevel)
+    {
+        s_messageLevel.store(minLevel, std::memory_order_relaxed);
+    }
+
+    auto get_message_level() -> MessageType
+    {
+        return s_messageLevel.load(std::memory_order_relaxed);
+    }
+
+    void set_async_messages(bool enabled)
+    {
+        if (enabled)
+        {
+            get_async_sink().start();
+            s_asyncMessages.store(true, std::memory_order_release);
+        }
+        else
+        {
+            s_asyncMessages.store(false, std::memory_order_release);
+            get_async_sink().stop();
+        }
+    }
+
+    auto is_async_messages_enabled() -> bool
+    {
+        return s_asyncMessages.load(std::memory_order_acquire);
+    }
+
+    auto push_async_message(MessageType msgType, std::string_view msg) -> bool
+    {
+        return get_async_sink().push(msgType, msg);
     }
 
-    auto get_message_callback() -> MessageCallbackFn&
+    void flush_messages()
     {
-        return s_messageCallbackFn;
+        if (is_async_messages_enabled())
+        {
+            get_async_sink().flush();
+        }
     }
 
-}
\ No newline at end of file
+}
@@ -2,7 +2,11 @@
 
 #include "vgw/vgw.hpp"
 
+#include <array>
+#include <memory>
 #include <format>
+#include <utility>
+#include <algorithm>
 #include <string_view>
 
 #ifdef _DEBUG
@@ -30,14 +34,93 @@
         }                                                \
     } while (false)
 
+// Messages below this level (the `MessageType` value) are compiled out. Defaults to stripping debug messages from release builds.
+#ifndef VGW_LOG_LEVEL
+    #ifdef NDEBUG
+        #define VGW_LOG_LEVEL 1
+    #else
+        #define VGW_LOG_LEVEL 0
+    #endif
+#endif
+
 namespace vgw::internal
 {
+    // Async messages longer than this are truncated.
+    constexpr std::size_t ASYNC_MESSAGE_SIZE = 256;
+    constexpr std::size_t ASYNC_MESSAGE_QUEUE_SIZE = 1024;
+
+    // The callback is swapped atomically, so it can be replaced while other threads (or the sink thread) are logging.
     void set_message_callback(const MessageCallbackFn& callbackFn);
-    auto get_message_callback() -> MessageCallbackFn&;
+    // Keeps the callback alive while it is invoked. Null when no callback is set.
+    auto get_message_callback() -> std::shared_ptr<const MessageCallbackFn>;
+    auto has_message_callback() -> bool;
+
+    void set_message_level(MessageType minLevel);
+    auto get_message_level() -> MessageType;
+
+    void set_async_messages(bool enabled);
+    auto is_async_messages_enabled() -> bool;
+    // Copies the message into the async queue. Returns false (and counts the message as dropped) if the queue is full.
+    auto push_async_message(MessageType msgType, std::string_view msg) -> bool;
+    void flush_messages();
+
+    struct AsyncMessageBuffer
+    {
+        std::array<char, ASYNC_MESSAGE_SIZE> data;
+        std::size_t size{};
+
+        // Output iterator for `std::vformat_to`, discarding anything past the end of the buffer.
+        struct Output
+        {
+            using difference_type = std::ptrdiff_t;
+
+            AsyncMessageBuffer* buffer{};
+
+            auto operator*() const -> const Output& { return *this; }
+            auto operator=(char c) const -> const Output&
+            {
+                if (buffer->size < buffer->data.size())
+                {
+                    buffer->data[buffer->size++] = c;
+                }
+                return *this;
+            }
+            auto operator++() -> Output& { return *this; }
+            auto operator++(int) -> Output { return *this; }
+        };
+    };
+
+    // Checked before formatting, so filtered messages cost a few loads and no allocation.
+    inline auto is_log_enabled(MessageType msgType) -> bool
+    {
+        return std::to_underlying(msgType) >= VGW_LOG_LEVEL && msgType >= get_message_level() && has_message_callback();
+    }
 
     template <typename... Args>
     void log(MessageType msgType, std::string_view fmt, Args... args)
     {
+        if (!is_log_enabled(msgType))
+        {
+            return;
+        }
+
+        if (is_async_messages_enabled())
+        {
+            // Formatted into a stack buffer, so hot paths do not allocate. The callback is invoked on the sink thread.
+            AsyncMessageBuffer buffer{};
+            if constexpr (sizeof...(Args) > 0)
+            {
+                std::vformat_to(AsyncMessageBuffer::Output{ &buffer }, fmt, std::make_format_args(args...));
+            }
+            else
+            {
+                buffer.size = std::min(fmt.size(), buffer.data.size());
+                std::copy_n(fmt.data(), buffer.size, buffer.data.data());
+            }
+            push_async_message(msgType, { buffer.data.data(), buffer.size });
+            return;
+        }
+
         std::string msg{};
         if constexpr (sizeof...(Args) > 0)
         {
@@ -48,25 +131,37 @@ namespace vgw::internal
             msg = fmt;
         }
 
-        get_message_callback()(msgType, msg);
+        if (const auto callbackFn = get_message_callback())
+        {
+            (*callbackFn)(msgType, msg);
+        }
     }
 
     template <typename... Args>
     void log_debug(std::string_view fmt, Args... args)
     {
-        log(MessageType::eDebug, fmt, std::forward<Args>(args)...);
+        if constexpr (VGW_LOG_LEVEL <= std::to_underlying(MessageType::eDebug))
+        {
+            log(MessageType::eDebug, fmt, std::forward<Args>(args)...);
+        }
     }
 
     template <typename... Args>
     void log_info(std::string_view fmt, Args... args)
     {
-        log(MessageType::eInfo, fmt, std::forward<Args>(args)...);
+        if constexpr (VGW_LOG_LEVEL <= std::to_underlying(MessageType::eInfo))
+        {
+            log(MessageType::eInfo, fmt, std::forward<Args>(args)...);
+        }
     }
 
     template <typename... Args>
     void log_warn(std::string_view fmt, Args... args)
     {
-        log(MessageType::eWarning, fmt, std::forward<Args>(args)...);
+        if constexpr (VGW_LOG_LEVEL <= std::to_underlying(MessageType::eWarning))
+        {
+            log(MessageType::eWarning, fmt, std::forward<Args>(args)...);
+        }
     }
 
     template <typename... Args>
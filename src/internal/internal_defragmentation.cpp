@@ -0,0 +1,441 @@
+#include "internal_defragmentation.hpp"
+
+#include "internal_device.hpp"
+#include "internal_images.hpp"
+#include "internal_buffers.hpp"
+#include "internal_stats.hpp"
+#include "internal_trace.hpp"
+
+#include <algorithm>
+
+namespace vgw::internal
+{
+    namespace
+    {
+        constexpr vk::BufferUsageFlags BUFFER_COPY_USAGE = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst;
+        constexpr vk::ImageUsageFlags IMAGE_COPY_USAGE = vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst;
+
+        struct PendingMove
+        {
+            VmaAllocation allocation{};
+            vk::Buffer oldBuffer{};
+            vk::Buffer newBuffer{};
+            vk::Image oldImage{};
+            vk::Image newImage{};
+        };
+
+        auto to_vk_barrier(const ImageTransitionInfo& transitionInfo) -> vk::ImageMemoryBarrier2
+        {
+            vk::ImageMemoryBarrier2 barrier{};
+            barrier.setImage(transitionInfo.image);
+            barrier.setOldLayout(transitionInfo.oldLayout);
+            barrier.setNewLayout(transitionInfo.newLayout);
+            barrier.setSrcAccessMask(transitionInfo.srcAccess);
+            barrier.setDstAccessMask(transitionInfo.dstAccess);
+            barrier.setSrcStageMask(transitionInfo.srcStage);
+            barrier.setDstStageMask(transitionInfo.dstStage);
+            barrier.setSubresourceRange(transitionInfo.subresourceRange);
+            return barrier;
+        }
+
+        auto make_subresource_barrier(vk::Image image, vk::ImageAspectFlags aspectMask, std::uint32_t mip, std::uint32_t layer)
+            -> vk::ImageMemoryBarrier2
+        {
+            vk::ImageMemoryBarrier2 barrier{};
+            barrier.setImage(image);
+            barrier.setSubresourceRange({ aspectMask, mip, 1, layer, 1 });
+            return barrier;
+        }
+
+        /**
+         * Records the copy of an image into its replacement, which is left in the layouts the old image was in. Returns the
+         * replacement's subresource states.
+         */
+        auto record_image_copy(vk::CommandBuffer cmdBuffer, ImageData& oldRef, vk::Image newImage)
+            -> std::vector<ImageSubresourceState>
+        {
+            const auto oldStates = oldRef.subresourceStates;
+            const bool isUndefined = std::ranges::all_of(oldStates,
+                                                         [](const ImageSubresourceState& state)
+                                                         { return state.layout == vk::ImageLayout::eUndefined; });
+            if (isUndefined)
+            {
+                // Nothing was written to the image, so there is nothing to copy.
+                return {};
+            }
+
+            const auto aspectMask = internal_image_aspect_get(oldRef.format);
+            const ImageSubresourceState copySrcState{ vk::ImageLayout::eTransferSrcOptimal,
+                                                      vk::AccessFlagBits2::eTransferRead,
+                                                      vk::PipelineStageFlagBits2::eCopy };
+            auto transitionsResult = internal_image_require_state(oldRef.image, { aspectMask, 0, 0, 0, 0 }, copySrcState);
+            std::vector<vk::ImageMemoryBarrier2> barriers{};
+            for (const auto& transition : transitionsResult.value_or(std::vector<ImageTransitionInfo>{}))
+            {
+                barriers.push_back(to_vk_barrier(transition));
+            }
+
+            vk::ImageMemoryBarrier2 newBarrier{};
+            newBarrier.setImage(newImage);
+            newBarrier.setOldLayout(vk::ImageLayout::eUndefined);
+            newBarrier.setNewLayout(vk::ImageLayout::eTransferDstOptimal);
+            newBarrier.setDstAccessMask(vk::AccessFlagBits2::eTransferWrite);
+            newBarrier.setDstStageMask(vk::PipelineStageFlagBits2::eCopy);
+            newBarrier.setSubresourceRange({ aspectMask, 0, oldRef.mipLevels, 0, oldRef.arrayLayers });
+            barriers.push_back(newBarrier);
+
+            vk::DependencyInfo depInfo{};
+            depInfo.setImageMemoryBarriers(barriers);
+            cmdBuffer.pipelineBarrier2(depInfo);
+
+            const auto& info = oldRef.info;
+            std::vector<vk::ImageCopy2> regions{};
+            for (std::uint32_t mip = 0; mip < oldRef.mipLevels; ++mip)
+            {
+                const vk::ImageSubresourceLayers subresource{ aspectMask, mip, 0, oldRef.arrayLayers };
+                const vk::Extent3D extent{ std::max(info.width >> mip, 1u),
+                                           std::max(info.height >> mip, 1u),
+                                           std::max(info.depth >> mip, 1u) };
+                regions.push_back(vk::ImageCopy2(subresource, {}, subresource, {}, extent));
+            }
+            vk::CopyImageInfo2 copyInfo{};
+            copyInfo.setSrcImage(oldRef.image);
+            copyInfo.setSrcImageLayout(vk::ImageLayout::eTransferSrcOptimal);
+            copyInfo.setDstImage(newImage);
+            copyInfo.setDstImageLayout(vk::ImageLayout::eTransferDstOptimal);
+            copyInfo.setRegions(regions);
+            cmdBuffer.copyImage2(copyInfo);
+
+            // Put every subresource back into the layout it had, so layouts assumed by the caller stay valid.
+            barriers.clear();
+            std::vector<ImageSubresourceState> newStates(std::size_t(oldRef.mipLevels) * oldRef.arrayLayers);
+            for (std::uint32_t layer = 0; layer < oldRef.arrayLayers; ++layer)
+            {
+                for (std::uint32_t mip = 0; mip < oldRef.mipLevels; ++mip)
+                {
+                    const auto index = std::size_t(layer) * oldRef.mipLevels + mip;
+                    const auto oldLayout = index < oldStates.size() ? oldStates.at(index).layout : vk::ImageLayout::eUndefined;
+                    if (oldLayout == vk::ImageLayout::eUndefined)
+                    {
+                        newStates.at(index) = { vk::ImageLayout::eTransferDstOptimal,
+                                                vk::AccessFlagBits2::eTransferWrite,
+                                                vk::PipelineStageFlagBits2::eCopy };
+                        continue;
+                    }
+
+                    auto barrier = make_subresource_barrier(newImage, aspectMask, mip, layer);
+                    barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal);
+                    barrier.setNewLayout(oldLayout);
+                    barrier.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
+                    barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eCopy);
+                    barrier.setDstAccessMask(vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite);
+                    barrier.setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+                    barriers.push_back(barrier);
+                    newStates.at(index) = { oldLayout, {}, {} };
+                }
+            }
+            if (!barriers.empty())
+            {
+                depInfo.setImageMemoryBarriers(barriers);
+                cmdBuffer.pipelineBarrier2(depInfo);
+            }
+            return newStates;
+        }
+
+        /**
+         * Runs one VMA defragmentation pass: creates the replacement resources in the new memory, copies them on the GPU and waits,
+         * then destroys the old resources. Returns true when VMA has nothing left to move.
+         */
+        auto run_pass(DeviceData& deviceRef) -> std::expected<bool, ResultCode>
+        {
+            auto& defragRef = deviceRef.defragmentation;
+
+            VmaDefragmentationPassMoveInfo passInfo{};
+            auto beginResult = vmaBeginDefragmentationPass(deviceRef.allocator, defragRef.context, &passInfo);
+            if (beginResult == VK_SUCCESS)
+            {
+                return true;
+            }
+            if (beginResult != VK_INCOMPLETE)
+            {
+                log_error("Failed to begin defragmentation pass!");
+                return std::unexpected(ResultCode::eFailed);
+            }
+
+            std::unordered_map<VmaAllocation, vk::Buffer> allocationBuffers{};
+            for (const auto& [buffer, data] : deviceRef.bufferMap)
+            {
+                // Moving a shared buffer would invalidate the sub-allocated buffers referring to it.
+                if (data.allocation && (data.info.usage & BUFFER_COPY_USAGE) == BUFFER_COPY_USAGE &&
+                    !deviceRef.subAllocationBlockMap.contains(buffer))
+                {
+                    allocationBuffers[data.allocation] = buffer;
+                }
+            }
+            std::unordered_map<VmaAllocation, vk::Image> allocationImages{};
+            for (const auto& [image, data] : deviceRef.imageMap)
+            {
+                if (data.allocation && (data.info.usage & IMAGE_COPY_USAGE) == IMAGE_COPY_USAGE)
+                {
+                    allocationImages[data.allocation] = image;
+                }
+            }
+
+            // Replacements are bound to the destination memory, which the original allocation refers to once the pass ends.
+            std::vector<PendingMove> pendingMoves{};
+            for (std::uint32_t i = 0; i < passInfo.moveCount; ++i)
+            {
+                auto& move = passInfo.pMoves[i];
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+
+                if (const auto it = allocationBuffers.find(move.srcAllocation); it != allocationBuffers.end())
+                {
+                    const auto& info = deviceRef.bufferMap.at(it->second).info;
+                    auto newResult = internal_buffer_create_aliased(info, move.dstTmpAllocation, 0);
+                    if (newResult)
+                    {
+                        move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_COPY;
+                        pendingMoves.push_back({ .allocation = move.srcAllocation, .oldBuffer = it->second, .newBuffer = *newResult });
+                    }
+                }
+                else if (const auto imageIt = allocationImages.find(move.srcAllocation); imageIt != allocationImages.end())
+                {
+                    const auto& info = deviceRef.imageMap.at(imageIt->second).info;
+                    auto newResult = internal_image_create_aliased(info, move.dstTmpAllocation, 0);
+                    if (newResult)
+                    {
+                        move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_COPY;
+                        pendingMoves.push_back({ .allocation = move.srcAllocation, .oldImage = imageIt->second, .newImage = *newResult });
+                    }
+                }
+            }
+
+            if (!pendingMoves.empty())
+            {
+                auto cmdBuffer = defragRef.cmdBuffer;
+                deviceRef.device.resetCommandPool(defragRef.cmdPool);
+                cmdBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+                // Previous work has completed (see `defragment()`), but its writes may not be available yet.
+                const vk::MemoryBarrier2 availableBarrier{ vk::PipelineStageFlagBits2::eAllCommands,
+                                                           vk::AccessFlagBits2::eMemoryWrite,
+                                                           vk::PipelineStageFlagBits2::eCopy,
+                                                           vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite };
+                vk::DependencyInfo depInfo{};
+                depInfo.setMemoryBarriers(availableBarrier);
+                cmdBuffer.pipelineBarrier2(depInfo);
+
+                for (const auto& pendingMove : pendingMoves)
+                {
+                    if (pendingMove.oldBuffer)
+                    {
+                        auto& oldRef = deviceRef.bufferMap.at(pendingMove.oldBuffer);
+                        cmdBuffer.copyBuffer(oldRef.buffer, pendingMove.newBuffer, vk::BufferCopy(0, 0, oldRef.info.size));
+                    }
+                    else
+                    {
+                        auto& oldRef = deviceRef.imageMap.at(pendingMove.oldImage);
+                        deviceRef.imageMap.at(pendingMove.newImage).subresourceStates =
+                            record_image_copy(cmdBuffer, oldRef, pendingMove.newImage);
+                    }
+                }
+
+                const vk::MemoryBarrier2 visibleBarrier{ vk::PipelineStageFlagBits2::eCopy,
+                                                         vk::AccessFlagBits2::eTransferWrite,
+                                                         vk::PipelineStageFlagBits2::eAllCommands,
+                                                         vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite };
+                depInfo.setMemoryBarriers(visibleBarrier);
+                cmdBuffer.pipelineBarrier2(depInfo);
+                cmdBuffer.end();
+
+                vk::SubmitInfo submitInfo{};
+                submitInfo.setCommandBuffers(cmdBuffer);
+                auto submitResult = deviceRef.queues.at(defragRef.queueIndex).submit(submitInfo, defragRef.fence);
+                if (submitResult != vk::Result::eSuccess)
+                {
+                    log_error("Failed to submit defragmentation copies!");
+                    return std::unexpected(ResultCode::eFailed);
+                }
+                internal_stats_add(internal_stats_get().submits);
+
+                deviceRef.device.waitForFences(defragRef.fence, true, std::uint64_t(-1));
+                deviceRef.device.resetFences(defragRef.fence);
+            }
+
+            for (const auto& pendingMove : pendingMoves)
+            {
+                if (defragRef.moveCallback)
+                {
+                    defragRef.moveCallback({ pendingMove.oldBuffer, pendingMove.newBuffer, pendingMove.oldImage, pendingMove.newImage });
+                }
+
+                // The old resource no longer owns the allocation, which now belongs to its replacement.
+                if (pendingMove.oldBuffer)
+                {
+                    deviceRef.bufferMap.at(pendingMove.oldBuffer).allocation = nullptr;
+                    internal_buffer_destroy(pendingMove.oldBuffer);
+                    deviceRef.bufferMap.at(pendingMove.newBuffer).allocation = pendingMove.allocation;
+                }
+                else
+                {
+                    deviceRef.imageMap.at(pendingMove.oldImage).allocation = nullptr;
+                    internal_image_destroy(pendingMove.oldImage);
+                    deviceRef.imageMap.at(pendingMove.newImage).allocation = pendingMove.allocation;
+                }
+            }
+            log_debug("Defragmentation pass moved {} of {} allocations.", pendingMoves.size(), passInfo.moveCount);
+
+            return vmaEndDefragmentationPass(deviceRef.allocator, defragRef.context, &passInfo) == VK_SUCCESS;
+        }
+    }
+
+    auto internal_defragmentation_begin(const DefragmentationInfo& defragInfo) -> ResultCode
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return deviceResult.error();
+        }
+        auto& deviceRef = deviceResult.value().get();
+        auto& defragRef = deviceRef.defragmentation;
+
+        if (defragRef.isActive)
+        {
+            log_error("Defragmentation is already running!");
+            return ResultCode::eFailed;
+        }
+        if (defragInfo.queueIndex >= deviceRef.queues.size())
+        {
+            log_error("Invalid defragmentation queue index ({})!", defragInfo.queueIndex);
+            return ResultCode::eInvalidIndex;
+        }
+
+        VmaDefragmentationInfo vmaDefragInfo{};
+        vmaDefragInfo.maxBytesPerPass = defragInfo.maxBytesPerPass;
+        vmaDefragInfo.maxAllocationsPerPass = defragInfo.maxAllocationsPerPass;
+        if (defragInfo.pool)
+        {
+            auto poolResult = internal_memory_pool_get(defragInfo.pool);
+            if (!poolResult)
+            {
+                log_error("Unknown memory pool!");
+                return poolResult.error();
+            }
+            vmaDefragInfo.pool = poolResult.value().get().pool;
+        }
+
+        vk::CommandPoolCreateInfo poolCreateInfo{};
+        poolCreateInfo.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+        poolCreateInfo.setQueueFamilyIndex(std::uint32_t(deviceRef.queueFamilyIndices.at(defragInfo.queueIndex)));
+        auto poolResult = deviceRef.device.createCommandPool(poolCreateInfo);
+        if (poolResult.result != vk::Result::eSuccess)
+        {
+            log_error("Failed to create defragmentation vk::CommandPool!");
+            return ResultCode::eFailedToCreate;
+        }
+        defragRef.cmdPool = poolResult.value;
+
+        vk::CommandBufferAllocateInfo cmdAllocInfo{ defragRef.cmdPool, vk::CommandBufferLevel::ePrimary, 1 };
+        auto cmdResult = deviceRef.device.allocateCommandBuffers(cmdAllocInfo);
+        auto fenceResult = deviceRef.device.createFence({});
+        if (cmdResult.result != vk::Result::eSuccess || fenceResult.result != vk::Result::eSuccess)
+        {
+            log_error("Failed to create defragmentation vk::CommandBuffer and/or vk::Fence!");
+            deviceRef.device.destroy(defragRef.cmdPool);
+            if (fenceResult.result == vk::Result::eSuccess)
+            {
+                deviceRef.device.destroy(fenceResult.value);
+            }
+            defragRef = {};
+            return ResultCode::eFailedToCreate;
+        }
+        defragRef.cmdBuffer = cmdResult.value.front();
+        defragRef.fence = fenceResult.value;
+
+        auto beginResult = vmaBeginDefragmentation(deviceRef.allocator, &vmaDefragInfo, &defragRef.context);
+        if (beginResult != VK_SUCCESS)
+        {
+            log_error("Failed to begin defragmentation!");
+            deviceRef.device.destroy(defragRef.cmdPool);
+            deviceRef.device.destroy(defragRef.fence);
+            defragRef = {};
+            return ResultCode::eFailed;
+        }
+
+        defragRef.isActive = true;
+        defragRef.queueIndex = defragInfo.queueIndex;
+        defragRef.moveCallback = defragInfo.moveCallback;
+        return ResultCode::eSuccess;
+    }
+
+    auto internal_defragmentation_step(double timeBudgetMs) -> std::expected<bool, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+        auto& defragRef = deviceRef.defragmentation;
+
+        if (!defragRef.isActive)
+        {
+            log_error("Defragmentation has not been started!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+
+        const auto startNs = trace_now_ns();
+        while (!defragRef.isComplete)
+        {
+            auto passResult = run_pass(deviceRef);
+            if (!passResult)
+            {
+                return std::unexpected(passResult.error());
+            }
+            defragRef.isComplete = passResult.value();
+
+            if (double(trace_now_ns() - startNs) / 1'000'000.0 >= timeBudgetMs)
+            {
+                break;
+            }
+        }
+        return defragRef.isComplete;
+    }
+
+    auto internal_defragmentation_end() -> DefragmentationStats
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return {};
+        }
+        auto& deviceRef = deviceResult.value().get();
+        auto& defragRef = deviceRef.defragmentation;
+
+        if (!defragRef.isActive)
+        {
+            log_warn("Defragmentation has not been started.");
+            return {};
+        }
+
+        VmaDefragmentationStats vmaStats{};
+        vmaEndDefragmentation(deviceRef.allocator, defragRef.context, &vmaStats);
+        deviceRef.device.destroy(defragRef.cmdPool);
+        deviceRef.device.destroy(defragRef.fence);
+        defragRef = {};
+
+        log_debug("Defragmentation moved {} allocations ({} bytes), freeing {} bytes.",
+                  vmaStats.allocationsMoved,
+                  vmaStats.bytesMoved,
+                  vmaStats.bytesFreed);
+        return {
+            .bytesMoved = vmaStats.bytesMoved,
+            .bytesFreed = vmaStats.bytesFreed,
+            .allocationsMoved = vmaStats.allocationsMoved,
+            .deviceMemoryBlocksFreed = vmaStats.deviceMemoryBlocksFreed,
+        };
+    }
+}
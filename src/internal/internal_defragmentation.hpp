@@ -0,0 +1,26 @@
+#pragma once
+
+#include "vgw/vgw.hpp"
+#include "internal_core.hpp"
+
+namespace vgw::internal
+{
+    struct DefragmentationData
+    {
+        bool isActive{ false };
+        // Set once VMA has nothing left to move.
+        bool isComplete{ false };
+        VmaDefragmentationContext context{};
+        std::uint32_t queueIndex{};
+        DefragmentationCallbackFn moveCallback{};
+
+        // Used to record and wait on the copies of each pass.
+        vk::CommandPool cmdPool{};
+        vk::CommandBuffer cmdBuffer{};
+        vk::Fence fence{};
+    };
+
+    auto internal_defragmentation_begin(const DefragmentationInfo& defragInfo) -> ResultCode;
+    auto internal_defragmentation_step(double timeBudgetMs) -> std::expected<bool, ResultCode>;
+    auto internal_defragmentation_end() -> DefragmentationStats;
+}
@@ -6,6 +6,10 @@
 #define VMA_IMPLEMENTATION
 #include <vma/vk_mem_alloc.h>
 
+#include <bit>
+#include <limits>
+#include <optional>
+
 namespace vgw::internal
 {
     namespace
@@ -30,11 +34,34 @@ namespace vgw::internal
         }
 
         /**
-         * #
+         * Lower is better. Families that cannot serve the wanted flags return std::nullopt.
+         * Graphics and compute families implicitly support transfer, so a transfer-only request will prefer a dedicated transfer family
+         * and a compute request will prefer an async-compute family over the graphics family.
+         */
+        auto score_queue_family(vk::QueueFlags familyFlags, vk::QueueFlags wantedQueue) -> std::optional<std::uint32_t>
+        {
+            if (familyFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))
+            {
+                familyFlags |= vk::QueueFlagBits::eTransfer;
+            }
+            if ((familyFlags & wantedQueue) != wantedQueue)
+            {
+                return std::nullopt;
+            }
+
+            constexpr vk::QueueFlags ScoredFlags =
+                vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute | vk::QueueFlagBits::eTransfer;
+            const auto extraFlags = familyFlags & ~wantedQueue;
+            const auto extraScored = std::popcount(static_cast<VkQueueFlags>(extraFlags & ScoredFlags));
+            const auto extraOther = std::popcount(static_cast<VkQueueFlags>(extraFlags & ~ScoredFlags));
+            return std::uint32_t(extraScored * 8 + extraOther);
+        }
+
+        /**
          * @param physicalDevice
          * @param wantedQueues
-         * @return Tuple of 2 vectors. 1st vector contains family indices of wanted queues. 2nd vector contains tuples of queue family
-         * counts.
+         * @return Tuple of 2 vectors. 1st vector contains family indices of wanted queues (-1 if none could be found). 2nd vector contains
+         * tuples of queue family counts.
          */
         auto select_queue_families(vk::PhysicalDevice physicalDevice, const std::vector<vk::QueueFlags>& wantedQueues)
             -> std::tuple<std::vector<std::int32_t>, std::vector<std::tuple<std::uint32_t, std::uint32_t>>>
@@ -42,33 +69,61 @@ namespace vgw::internal
             auto queueFamilies = physicalDevice.getQueueFamilyProperties();
 
             std::unordered_map<std::uint32_t, std::uint32_t> queueFamilyCountMap;
+            auto has_free_queue = [&](std::uint32_t familyIndex)
+            {
+                const auto it = queueFamilyCountMap.find(familyIndex);
+                return it == queueFamilyCountMap.end() || it->second < queueFamilies.at(familyIndex).queueCount;
+            };
+
             std::vector<std::int32_t> wantedQueueFamiliesIndices;
             for (auto i = 0; i < wantedQueues.size(); ++i)
             {
-                auto wantedQueue = wantedQueues.at(i);
-                bool foundFamily = false;
-                for (auto familyIndex = 0; familyIndex < queueFamilies.size(); ++familyIndex)
+                const auto wantedQueue = wantedQueues.at(i);
+
+                std::int32_t selectedFamily = -1;
+                std::uint32_t selectedScore = std::numeric_limits<std::uint32_t>::max();
+                for (std::uint32_t familyIndex = 0; familyIndex < queueFamilies.size(); ++familyIndex)
                 {
-                    const auto& family = queueFamilies.at(familyIndex);
+                    if (!has_free_queue(familyIndex))
+                    {
+                        continue;
+                    }
 
-                    if (family.queueFlags & wantedQueue)
+                    const auto score = score_queue_family(queueFamilies.at(familyIndex).queueFlags, wantedQueue);
+                    if (score && score.value() < selectedScore)
                     {
-                        if (queueFamilyCountMap.contains(familyIndex) && queueFamilyCountMap.at(familyIndex) >= family.queueCount)
-                        {
-                            continue;
-                        }
-
-                        queueFamilyCountMap[familyIndex]++;
-                        wantedQueueFamiliesIndices.emplace_back(familyIndex);
-                        foundFamily = true;
-                        break;
+                        selectedFamily = std::int32_t(familyIndex);
+                        selectedScore = score.value();
                     }
                 }
-                if (!foundFamily)
+
+                // Fallback: any family that supports at least some of the wanted flags.
+                for (std::uint32_t familyIndex = 0; selectedFamily == -1 && familyIndex < queueFamilies.size(); ++familyIndex)
+                {
+                    if (has_free_queue(familyIndex) && (queueFamilies.at(familyIndex).queueFlags & wantedQueue))
+                    {
+                        log_warn("No queue family fully supports queue at index {} ({}). Falling back to family {}.",
+                                 i,
+                                 vk::to_string(wantedQueue),
+                                 familyIndex);
+                        selectedFamily = std::int32_t(familyIndex);
+                    }
+                }
+
+                if (selectedFamily == -1)
                 {
                     wantedQueueFamiliesIndices.push_back(-1);
                     log_error("Unable to create queue at index {}!", i);
+                    continue;
                 }
+
+                queueFamilyCountMap[selectedFamily]++;
+                wantedQueueFamiliesIndices.push_back(selectedFamily);
+                log_debug("Queue {} ({}) assigned to family {} ({}).",
+                          i,
+                          vk::to_string(wantedQueue),
+                          selectedFamily,
+                          vk::to_string(queueFamilies.at(selectedFamily).queueFlags));
             }
 
             std::vector<std::tuple<std::uint32_t, std::uint32_t>> queueFamilyCountPairs;
@@ -137,12 +192,51 @@ namespace vgw::internal
         }
         semaphores.clear();
 
+        for (const auto& [event, _] : eventMap)
+        {
+            device.destroy(event);
+        }
+        eventMap.clear();
+        for (const auto& event : freeEvents)
+        {
+            device.destroy(event);
+        }
+        freeEvents.clear();
+        for (const auto& event : retiredEvents)
+        {
+            device.destroy(event);
+        }
+        retiredEvents.clear();
+        eventUseCounts.clear();
+
         for (const auto& fence : fences)
         {
             device.destroy(fence);
         }
         fences.clear();
 
+        for (const auto& frame : gpuProfiler.frames)
+        {
+            device.destroy(frame.queryPool);
+        }
+        gpuProfiler.frames.clear();
+        gpuProfiler.isInitialised = false;
+
+        if (defragmentation.isActive)
+        {
+            vmaEndDefragmentation(allocator, defragmentation.context, nullptr);
+            device.destroy(defragmentation.cmdPool);
+            device.destroy(defragmentation.fence);
+            defragmentation = {};
+        }
+
+        for (const auto& pool : queryPools)
+        {
+            device.destroy(pool.pool);
+        }
+        queryPools.clear();
+        queryMap.clear();
+
         renderPassMap.clear();
 
         // Destroy swapchains before images, so only non-swapchain images remain in imageMap
@@ -184,12 +278,35 @@ namespace vgw::internal
         }
         imageMap.clear();
 
+        // The shared buffers are destroyed with the other buffers.
+        for (const auto& [_, data] : subAllocationBlockMap)
+        {
+            vmaClearVirtualBlock(data.block);
+            vmaDestroyVirtualBlock(data.block);
+        }
+        subAllocationBlockMap.clear();
+
         for (const auto& [_, data] : bufferMap)
         {
             vmaDestroyBuffer(allocator, data.buffer, data.allocation);
         }
         bufferMap.clear();
 
+        // Shared allocations that images/buffers were bound into. Resources are destroyed first.
+        for (const auto& allocation : memoryAllocations)
+        {
+            vmaFreeMemory(allocator, allocation);
+        }
+        memoryAllocations.clear();
+        aliasingHeapMap.clear();
+
+        // Pools can only be destroyed once every allocation made from them is freed.
+        for (const auto& [_, data] : memoryPoolMap)
+        {
+            vmaDestroyPool(allocator, data->pool);
+        }
+        memoryPoolMap.clear();
+
         for (const auto& [_, pool] : cmdPoolMap)
         {
             device.destroy(pool);
@@ -218,6 +335,9 @@ namespace vgw::internal
         device.destroy(descriptorPool);
         descriptorPool = nullptr;
 
+        device.destroy(pipelineCache);
+        pipelineCache = nullptr;
+
         vmaDestroyAllocator(allocator);
         allocator = nullptr;
 
@@ -277,10 +397,31 @@ namespace vgw::internal
             }
         }
 
-        log_info("Enabled extensions:");
-        for (const auto& extension : enabledExtensions)
+        // Optional extensions, enabled silently when available.
+        const bool isMemoryBudgetSupported = is_device_extension_supported(physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        if (isMemoryBudgetSupported)
+        {
+            enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+        const bool isMemoryPriorityExtSupported = is_device_extension_supported(physicalDevice, VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME);
+        if (isMemoryPriorityExtSupported)
+        {
+            enabledExtensions.push_back(VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME);
+        }
+        const bool isHostImageCopyExtSupported = is_device_extension_supported(physicalDevice, VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME);
+        if (isHostImageCopyExtSupported)
+        {
+            enabledExtensions.push_back(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME);
+        }
+
+        if (is_log_enabled(MessageType::eDebug))
         {
-            log_info("  {}", extension);
+            std::string extensionList{};
+            for (const auto& extension : enabledExtensions)
+            {
+                extensionList += std::format("\n  {}", extension);
+            }
+            log_debug("Enabled device extensions:{}", extensionList);
         }
 
 #pragma endregion
@@ -307,6 +448,60 @@ namespace vgw::internal
         vk::PhysicalDeviceSynchronization2Features synchronization2Features{ true };
         nextFeature = &synchronization2Features;
 
+        vk::PhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{ true };
+        timelineSemaphoreFeatures.setPNext(nextFeature);
+        nextFeature = &timelineSemaphoreFeatures;
+
+        // Lets query pools be reset from the host, so profiler frames don't need a reset command recorded before use.
+        vk::PhysicalDeviceHostQueryResetFeatures hostQueryResetFeatures{ true };
+        hostQueryResetFeatures.setPNext(nextFeature);
+        nextFeature = &hostQueryResetFeatures;
+
+        // Optional. Buffers created with `eShaderDeviceAddress` report an error when it is not supported.
+        const auto supportedFeatureChain = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                                                       vk::PhysicalDeviceBufferDeviceAddressFeatures,
+                                                                       vk::PhysicalDeviceHostImageCopyFeaturesEXT,
+                                                                       vk::PhysicalDeviceMemoryPriorityFeaturesEXT>();
+        const bool isBufferDeviceAddressSupported =
+            supportedFeatureChain.get<vk::PhysicalDeviceBufferDeviceAddressFeatures>().bufferDeviceAddress == VK_TRUE;
+        vk::PhysicalDeviceBufferDeviceAddressFeatures bufferDeviceAddressFeatures{ true };
+        if (isBufferDeviceAddressSupported)
+        {
+            bufferDeviceAddressFeatures.setPNext(nextFeature);
+            nextFeature = &bufferDeviceAddressFeatures;
+        }
+
+        // Optional. Lets `MemoryHints::priority` influence which allocations are demoted under memory pressure.
+        const auto& memoryPrioritySupport = supportedFeatureChain.get<vk::PhysicalDeviceMemoryPriorityFeaturesEXT>();
+        const bool isMemoryPrioritySupported = isMemoryPriorityExtSupported && memoryPrioritySupport.memoryPriority == VK_TRUE;
+        vk::PhysicalDeviceMemoryPriorityFeaturesEXT memoryPriorityFeatures{ true };
+        if (isMemoryPrioritySupported)
+        {
+            memoryPriorityFeatures.setPNext(nextFeature);
+            nextFeature = &memoryPriorityFeatures;
+        }
+
+        // Optional. Lets `upload_image_host()` write straight into images instead of going through a staging buffer.
+        const bool isHostImageCopySupported =
+            isHostImageCopyExtSupported && supportedFeatureChain.get<vk::PhysicalDeviceHostImageCopyFeaturesEXT>().hostImageCopy == VK_TRUE;
+        vk::PhysicalDeviceHostImageCopyFeaturesEXT hostImageCopyFeatures{ true };
+        std::vector<vk::ImageLayout> hostImageCopyDstLayouts{};
+        if (isHostImageCopySupported)
+        {
+            hostImageCopyFeatures.setPNext(nextFeature);
+            nextFeature = &hostImageCopyFeatures;
+
+            // Queried twice: first for the layout count, then for the layouts.
+            auto propertiesChain =
+                physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceHostImageCopyPropertiesEXT>();
+            auto& hostImageCopyProperties = propertiesChain.get<vk::PhysicalDeviceHostImageCopyPropertiesEXT>();
+            hostImageCopyDstLayouts.resize(hostImageCopyProperties.copyDstLayoutCount);
+            hostImageCopyProperties.setPCopySrcLayouts(nullptr);
+            hostImageCopyProperties.setCopySrcLayoutCount(0);
+            hostImageCopyProperties.setPCopyDstLayouts(hostImageCopyDstLayouts.data());
+            physicalDevice.getProperties2(&propertiesChain.get<vk::PhysicalDeviceProperties2>());
+        }
+
         vk::PhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures{ true };
         if (isDynamicRenderingSupported)
         {
@@ -320,6 +515,10 @@ namespace vgw::internal
         vk::PhysicalDeviceFeatures enabledFeatures{};
         enabledFeatures.setFillModeNonSolid(true);
         enabledFeatures.setWideLines(true);
+        // Optional. Queries that need them report an error when they are created.
+        const auto supportedFeatures = physicalDevice.getFeatures();
+        enabledFeatures.setPipelineStatisticsQuery(supportedFeatures.pipelineStatisticsQuery);
+        enabledFeatures.setOcclusionQueryPrecise(supportedFeatures.occlusionQueryPrecise);
 
         vk::DeviceCreateInfo deviceCreateInfo{};
         deviceCreateInfo.setQueueCreateInfos(queueCreateInfoVec);
@@ -344,6 +543,18 @@ namespace vgw::internal
         allocatorInfo.physicalDevice = physicalDevice;
         allocatorInfo.device = device;
         allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_3;
+        if (isMemoryBudgetSupported)
+        {
+            allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
+        if (isBufferDeviceAddressSupported)
+        {
+            allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+        }
+        if (isMemoryPrioritySupported)
+        {
+            allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT;
+        }
         auto allocatorResult = vmaCreateAllocator(&allocatorInfo, &allocator);
         if (allocatorResult != VK_SUCCESS)
         {
@@ -366,13 +577,30 @@ namespace vgw::internal
         }
         auto descriptorPool = setPoolResult.value;
 
+        // Without a cache, pipelines are still created (and never report cache hits).
+        vk::PipelineCacheCreateInfo pipelineCacheCreateInfo{};
+        pipelineCacheCreateInfo.setInitialDataSize(deviceInfo.pipelineCacheData.size());
+        pipelineCacheCreateInfo.setPInitialData(deviceInfo.pipelineCacheData.data());
+        auto pipelineCacheResult = device.createPipelineCache(pipelineCacheCreateInfo);
+        if (pipelineCacheResult.result != vk::Result::eSuccess)
+        {
+            log_warn("Failed to create vk::PipelineCache!");
+        }
+        const auto pipelineCache = pipelineCacheResult.result == vk::Result::eSuccess ? pipelineCacheResult.value : vk::PipelineCache{};
+
         contextRef.device = std::make_unique<DeviceData>();
         contextRef.device->context = &contextRef;
         contextRef.device->physicalDevice = physicalDevice;
         contextRef.device->device = device;
         contextRef.device->allocator = allocator;
         contextRef.device->descriptorPool = descriptorPool;
+        contextRef.device->pipelineCache = pipelineCache;
         contextRef.device->queues = queues;
+        contextRef.device->queueFamilyIndices = wantedQueueFamilyIndices;
+        contextRef.device->isBufferDeviceAddressEnabled = isBufferDeviceAddressSupported;
+        contextRef.device->isHostImageCopyEnabled = isHostImageCopySupported;
+        contextRef.device->isMemoryPriorityEnabled = isMemoryPrioritySupported;
+        contextRef.device->hostImageCopyDstLayouts = std::move(hostImageCopyDstLayouts);
         contextRef.device->setWrites.reserve(MAX_SET_WRITES_COUNT);
         contextRef.device->setWriteObjects.reserve(MAX_SET_WRITES_COUNT);
 
@@ -419,6 +647,23 @@ namespace vgw::internal
         return *devicePtr;
     }
 
+    auto internal_queue_family_get(std::uint32_t queueIndex) -> std::expected<std::uint32_t, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        if (queueIndex >= deviceRef.queueFamilyIndices.size() || deviceRef.queueFamilyIndices.at(queueIndex) < 0)
+        {
+            return std::unexpected(ResultCode::eInvalidIndex);
+        }
+
+        return std::uint32_t(deviceRef.queueFamilyIndices.at(queueIndex));
+    }
+
     bool internal_device_is_valid() noexcept
     {
         auto getResult = internal_device_get();
@@ -9,6 +9,10 @@
 #include "internal_render_pass.hpp"
 #include "internal_sets.hpp"
 #include "internal_command_buffers.hpp"
+#include "internal_synchronisation.hpp"
+#include "internal_queries.hpp"
+#include "internal_memory.hpp"
+#include "internal_defragmentation.hpp"
 
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan_hash.hpp>
@@ -30,27 +34,50 @@ namespace vgw::internal
         vk::PhysicalDevice physicalDevice;
         vk::Device device;
         std::vector<vk::Queue> queues;
+        std::vector<std::int32_t> queueFamilyIndices;
 
         VmaAllocator allocator;
         vk::DescriptorPool descriptorPool;
+        vk::PipelineCache pipelineCache;
+        bool isBufferDeviceAddressEnabled{ false };
+        bool isHostImageCopyEnabled{ false };
+        bool isMemoryPriorityEnabled{ false };
+        // Layouts host image copies can write to (VK_EXT_host_image_copy).
+        std::vector<vk::ImageLayout> hostImageCopyDstLayouts;
 
         std::unordered_map<vk::SwapchainKHR, SwapchainData> swapchainMap;
         std::unordered_map<std::size_t, vk::DescriptorSetLayout> setLayoutMap;
         std::unordered_map<std::size_t, vk::PipelineLayout> pipelineLayoutMap;
         std::unordered_map<vk::Pipeline, PipelineData> pipelineMap;
         std::unordered_map<vk::Buffer, BufferData> bufferMap;
+        std::unordered_map<vk::Buffer, SubAllocationBlockData> subAllocationBlockMap;
+        std::unordered_set<VmaAllocation> memoryAllocations;
+        std::unordered_map<AliasingHeapData*, std::unique_ptr<AliasingHeapData>> aliasingHeapMap;
+        std::unordered_map<MemoryPoolData*, std::unique_ptr<MemoryPoolData>> memoryPoolMap;
+        DefragmentationData defragmentation;
         std::unordered_map<vk::Image, ImageData> imageMap;
         std::unordered_set<vk::ImageView> imageViewMap;
         std::unordered_map<std::size_t, vk::Sampler> samplerMap;
         std::unordered_map<RenderPassData*, std::unique_ptr<RenderPassData>> renderPassMap;
-        std::unordered_map<vk::CommandPoolCreateFlags, vk::CommandPool> cmdPoolMap;
+        std::unordered_map<CmdPoolKey, vk::CommandPool, CmdPoolKeyHash> cmdPoolMap;
         std::unordered_map<vk::CommandBuffer, CmdBufferData> cmdBufferMap;
 
         std::vector<vk::WriteDescriptorSet> setWrites;
         std::vector<SetWriteObject> setWriteObjects;
+        std::unordered_map<vk::DescriptorSet, std::vector<SetStorageBinding>> setStorageBufferMap;
 
         std::unordered_set<vk::Fence> fences;
         std::unordered_set<vk::Semaphore> semaphores;
+        std::unordered_map<vk::Event, EventData> eventMap;
+        std::vector<vk::Event> freeEvents;
+        // Command buffers that recorded each event and have not completed since (see `CmdBufferData::usedEvents`).
+        std::unordered_map<vk::Event, std::uint32_t> eventUseCounts;
+        // Destroyed events still used by a command buffer, moved to `freeEvents` once unused.
+        std::unordered_set<vk::Event> retiredEvents;
+
+        GpuProfilerData gpuProfiler;
+        std::vector<QueryPoolData> queryPools;
+        std::unordered_map<QueryData*, std::unique_ptr<QueryData>> queryMap;
 
         ~DeviceData();
 
@@ -63,6 +90,8 @@ namespace vgw::internal
 
     auto internal_device_get() -> std::expected<std::reference_wrapper<DeviceData>, ResultCode>;
 
+    auto internal_queue_family_get(std::uint32_t queueIndex) -> std::expected<std::uint32_t, ResultCode>;
+
     bool internal_device_is_valid() noexcept;
 
 }
\ No newline at end of file
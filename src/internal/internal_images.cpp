@@ -1,9 +1,285 @@
 #include "internal_images.hpp"
 
 #include "internal_device.hpp"
+#include "internal_memory.hpp"
+#include "internal_stats.hpp"
+#include "internal_synchronisation.hpp"
+#include "internal_command_buffers.hpp"
+
+#include <map>
+#include <cstring>
+#include <optional>
+#include <algorithm>
 
 namespace vgw::internal
 {
+    namespace
+    {
+        auto resolve_range(const ImageData& imageRef, vk::ImageSubresourceRange range) -> vk::ImageSubresourceRange
+        {
+            if (!range.aspectMask)
+            {
+                range.aspectMask = internal_image_aspect_get(imageRef.format);
+            }
+            if (range.levelCount == VK_REMAINING_MIP_LEVELS || range.levelCount == 0)
+            {
+                range.levelCount = imageRef.mipLevels - range.baseMipLevel;
+            }
+            if (range.layerCount == VK_REMAINING_ARRAY_LAYERS || range.layerCount == 0)
+            {
+                range.layerCount = imageRef.arrayLayers - range.baseArrayLayer;
+            }
+            return range;
+        }
+
+        auto get_subresource_state(ImageData& imageRef, std::uint32_t mip, std::uint32_t layer) -> ImageSubresourceState&
+        {
+            if (imageRef.subresourceStates.empty())
+            {
+                imageRef.subresourceStates.resize(std::size_t(imageRef.mipLevels) * imageRef.arrayLayers);
+            }
+            return imageRef.subresourceStates.at(std::size_t(layer) * imageRef.mipLevels + mip);
+        }
+
+        auto is_host_transfer_format(const DeviceData& deviceRef, vk::Format format) -> bool
+        {
+            if (!deviceRef.isHostImageCopyEnabled)
+            {
+                return false;
+            }
+            const auto propertiesChain =
+                deviceRef.physicalDevice.getFormatProperties2<vk::FormatProperties2, vk::FormatProperties3>(format);
+            const auto& formatProperties = propertiesChain.get<vk::FormatProperties3>();
+            return bool(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits2::eHostImageTransferEXT);
+        }
+
+        // Applies the options that depend on device support.
+        auto resolve_image_info(const DeviceData& deviceRef, ImageInfo imageInfo) -> ImageInfo
+        {
+            if (imageInfo.hostTransfer && is_host_transfer_format(deviceRef, imageInfo.format))
+            {
+                imageInfo.usage |= vk::ImageUsageFlagBits::eHostTransferEXT;
+            }
+            return imageInfo;
+        }
+
+        auto get_region_range(const vk::BufferImageCopy2& region) -> vk::ImageSubresourceRange
+        {
+            const auto& subresource = region.imageSubresource;
+            return { subresource.aspectMask, subresource.mipLevel, 1, subresource.baseArrayLayer, subresource.layerCount };
+        }
+
+        // Offset just past the last byte a region reads, to validate it against the source data. Compressed formats are addressed in
+        // whole blocks, and the last row of the last slice only reads its own width rather than the full `bufferRowLength`.
+        auto get_region_end(const vk::BufferImageCopy2& region, vk::Format format) -> vk::DeviceSize
+        {
+            const auto& extent = region.imageExtent;
+            if (extent.width == 0 || extent.height == 0 || extent.depth == 0 || region.imageSubresource.layerCount == 0)
+            {
+                return region.bufferOffset;
+            }
+
+            const auto blockExtent = vk::blockExtent(format);
+            const auto to_blocks = [](std::uint32_t texels, std::uint32_t blockTexels) -> vk::DeviceSize
+            { return (texels + blockTexels - 1) / blockTexels; };
+            const auto rowLength = region.bufferRowLength != 0 ? region.bufferRowLength : extent.width;
+            const auto imageHeight = region.bufferImageHeight != 0 ? region.bufferImageHeight : extent.height;
+
+            const vk::DeviceSize blockSize = vk::blockSize(format);
+            const auto rowPitch = to_blocks(rowLength, blockExtent[0]) * blockSize;
+            const auto slicePitch = to_blocks(imageHeight, blockExtent[1]) * rowPitch;
+            const auto sliceCount = to_blocks(extent.depth, blockExtent[2]) * region.imageSubresource.layerCount;
+            const auto lastRowSize = to_blocks(extent.width, blockExtent[0]) * blockSize;
+            return region.bufferOffset + (sliceCount - 1) * slicePitch + (to_blocks(extent.height, blockExtent[1]) - 1) * rowPitch +
+                   lastRowSize;
+        }
+
+        auto upload_image_with_host_copy(DeviceData& deviceRef, ImageData& imageRef, const ImageUploadInfo& uploadInfo) -> ResultCode
+        {
+            // Write straight into the final layout when the implementation allows it, saving a transition.
+            const auto& dstLayouts = deviceRef.hostImageCopyDstLayouts;
+            auto copyLayout = uploadInfo.finalLayout;
+            if (std::ranges::find(dstLayouts, copyLayout) == dstLayouts.end())
+            {
+                copyLayout = std::ranges::find(dstLayouts, vk::ImageLayout::eGeneral) != dstLayouts.end() ? vk::ImageLayout::eGeneral
+                                                                                                           : dstLayouts.front();
+            }
+
+            // Regions may share subresources, which must each be transitioned exactly once before and after the copy.
+            std::map<std::pair<std::uint32_t, std::uint32_t>, vk::ImageAspectFlags> subresources{};
+            std::vector<vk::MemoryToImageCopyEXT> copies{};
+            for (const auto& region : uploadInfo.regions)
+            {
+                const auto range = resolve_range(imageRef, get_region_range(region));
+                for (auto layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; ++layer)
+                {
+                    subresources[{ range.baseMipLevel, layer }] |= range.aspectMask;
+                }
+
+                auto& copy = copies.emplace_back();
+                copy.setPHostPointer(uploadInfo.pixels.data() + region.bufferOffset);
+                copy.setMemoryRowLength(region.bufferRowLength);
+                copy.setMemoryImageHeight(region.bufferImageHeight);
+                copy.setImageSubresource(region.imageSubresource);
+                copy.setImageOffset(region.imageOffset);
+                copy.setImageExtent(region.imageExtent);
+            }
+
+            std::vector<vk::HostImageLayoutTransitionInfoEXT> transitions{};
+            for (const auto& [subresource, aspectMask] : subresources)
+            {
+                const auto [mip, layer] = subresource;
+                const auto oldLayout = get_subresource_state(imageRef, mip, layer).layout;
+                if (oldLayout != copyLayout)
+                {
+                    const vk::ImageSubresourceRange layerRange{ aspectMask, mip, 1, layer, 1 };
+                    transitions.push_back(vk::HostImageLayoutTransitionInfoEXT(imageRef.image, oldLayout, copyLayout, layerRange));
+                }
+            }
+            if (!transitions.empty() && deviceRef.device.transitionImageLayoutEXT(transitions) != vk::Result::eSuccess)
+            {
+                log_error("Failed to transition image layout on the host!");
+                return ResultCode::eFailed;
+            }
+
+            vk::CopyMemoryToImageInfoEXT copyInfo{};
+            copyInfo.setDstImage(imageRef.image);
+            copyInfo.setDstImageLayout(copyLayout);
+            copyInfo.setRegions(copies);
+            if (deviceRef.device.copyMemoryToImageEXT(copyInfo) != vk::Result::eSuccess)
+            {
+                log_error("Failed to copy memory to image on the host!");
+                return ResultCode::eFailed;
+            }
+
+            transitions.clear();
+            for (const auto& [subresource, aspectMask] : subresources)
+            {
+                const auto [mip, layer] = subresource;
+                if (copyLayout != uploadInfo.finalLayout)
+                {
+                    const vk::ImageSubresourceRange layerRange{ aspectMask, mip, 1, layer, 1 };
+                    transitions.push_back(
+                        vk::HostImageLayoutTransitionInfoEXT(imageRef.image, copyLayout, uploadInfo.finalLayout, layerRange));
+                }
+                // Host writes are visible to work submitted afterwards, so no barrier is needed before the image is used.
+                get_subresource_state(imageRef, mip, layer) = { uploadInfo.finalLayout, {}, {} };
+            }
+            if (!transitions.empty() && deviceRef.device.transitionImageLayoutEXT(transitions) != vk::Result::eSuccess)
+            {
+                log_error("Failed to transition image layout on the host!");
+                return ResultCode::eFailed;
+            }
+            return ResultCode::eSuccess;
+        }
+
+        auto upload_image_with_staging(const ImageUploadInfo& uploadInfo) -> ResultCode
+        {
+            const BufferInfo stagingInfo{
+                .size = uploadInfo.pixels.size(),
+                .usage = vk::BufferUsageFlagBits::eTransferSrc,
+                .memUsage = VMA_MEMORY_USAGE_AUTO,
+                .allocFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+            };
+            auto stagingResult = internal_buffer_create(stagingInfo);
+            if (!stagingResult)
+            {
+                return stagingResult.error();
+            }
+            const auto stagingBuffer = stagingResult.value();
+
+            auto mapResult = internal_buffer_map(stagingBuffer);
+            if (!mapResult)
+            {
+                internal_buffer_destroy(stagingBuffer);
+                return mapResult.error();
+            }
+            std::memcpy(mapResult.value(), uploadInfo.pixels.data(), uploadInfo.pixels.size());
+            internal_buffer_unmap(stagingBuffer);
+
+            const CmdBufferAllocInfo cmdAllocInfo{
+                .count = 1,
+                .level = vk::CommandBufferLevel::ePrimary,
+                .poolFlags = vk::CommandPoolCreateFlagBits::eTransient,
+                .queueIndex = uploadInfo.queueIndex,
+            };
+            auto cmdResult = internal_cmd_buffers_allocate(cmdAllocInfo);
+            if (!cmdResult)
+            {
+                internal_buffer_destroy(stagingBuffer);
+                return cmdResult.error();
+            }
+            auto fenceResult = internal_fence_create({});
+            if (!fenceResult)
+            {
+                internal_cmd_buffers_free(cmdResult.value());
+                internal_buffer_destroy(stagingBuffer);
+                return fenceResult.error();
+            }
+            auto cmd = cmdResult.value().front();
+            const auto fence = fenceResult.value();
+
+            cmd->begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+            for (const auto& region : uploadInfo.regions)
+            {
+                cmd->require_image_state(uploadInfo.image,
+                                         vk::ImageLayout::eTransferDstOptimal,
+                                         vk::AccessFlagBits2::eTransferWrite,
+                                         vk::PipelineStageFlagBits2::eCopy,
+                                         get_region_range(region));
+            }
+            const CopyBufferToImageInfo copyInfo{
+                .srcBuffer = stagingBuffer,
+                .dstImage = uploadInfo.image,
+                .dstImageLayout = vk::ImageLayout::eTransferDstOptimal,
+                .regions = uploadInfo.regions,
+            };
+            cmd->copy_buffer_to_image(copyInfo);
+            // The next use is unknown, so everything after the copy waits for it.
+            for (const auto& region : uploadInfo.regions)
+            {
+                cmd->require_image_state(uploadInfo.image,
+                                         uploadInfo.finalLayout,
+                                         vk::AccessFlagBits2::eMemoryRead,
+                                         vk::PipelineStageFlagBits2::eAllCommands,
+                                         get_region_range(region));
+            }
+            cmd->end();
+
+            const SubmitInfo submitInfo{
+                .queueIndex = uploadInfo.queueIndex,
+                .cmdBuffers = { *cmd },
+                .signalFence = fence,
+            };
+            internal_submit(submitInfo);
+            internal_fence_wait(fence);
+
+            internal_fence_destroy(fence);
+            internal_cmd_buffers_free(cmdResult.value());
+            internal_buffer_destroy(stagingBuffer);
+            return ResultCode::eSuccess;
+        }
+
+        auto make_image_create_info(const ImageInfo& imageInfo) -> vk::ImageCreateInfo
+        {
+            vk::ImageCreateInfo imageCreateInfo{};
+            imageCreateInfo.setImageType(imageInfo.type);
+            imageCreateInfo.setFormat(imageInfo.format);
+            imageCreateInfo.setExtent({ imageInfo.width, imageInfo.height, imageInfo.depth });
+            imageCreateInfo.setMipLevels(imageInfo.mipLevels);
+            imageCreateInfo.setArrayLayers(1);
+            imageCreateInfo.setSamples(vk::SampleCountFlagBits::e1);
+            imageCreateInfo.setUsage(imageInfo.usage);
+            return imageCreateInfo;
+        }
+
+        bool is_same_barrier(const ImageTransitionInfo& lhs, const ImageTransitionInfo& rhs)
+        {
+            return lhs.oldLayout == rhs.oldLayout && lhs.newLayout == rhs.newLayout && lhs.srcAccess == rhs.srcAccess &&
+                   lhs.dstAccess == rhs.dstAccess && lhs.srcStage == rhs.srcStage && lhs.dstStage == rhs.dstStage;
+        }
+    }
+
     auto internal_image_create(const ImageInfo& imageInfo) -> std::expected<vk::Image, ResultCode>
     {
         auto deviceResult = internal_device_get();
@@ -14,20 +290,44 @@ namespace vgw::internal
         }
         auto& deviceRef = deviceResult.value().get();
 
+        if (imageInfo.aliasing.heap)
+        {
+            auto requirementsResult = internal_image_memory_requirements_get(imageInfo);
+            if (!requirementsResult)
+            {
+                return std::unexpected(requirementsResult.error());
+            }
+            auto allocationResult = internal_aliasing_heap_allocation_get(imageInfo.aliasing, requirementsResult.value());
+            if (!allocationResult)
+            {
+                return std::unexpected(allocationResult.error());
+            }
+            return internal_image_create_aliased(imageInfo, allocationResult.value(), imageInfo.aliasing.offset);
+        }
+
         VkImage vkImage{};
         VmaAllocation allocation{};
 
-        vk::ImageCreateInfo imageCreateInfo{};
-        imageCreateInfo.setImageType(imageInfo.type);
-        imageCreateInfo.setFormat(imageInfo.format);
-        imageCreateInfo.setExtent({ imageInfo.width, imageInfo.height, imageInfo.depth });
-        imageCreateInfo.setMipLevels(imageInfo.mipLevels);
-        imageCreateInfo.setArrayLayers(1);
-        imageCreateInfo.setSamples(vk::SampleCountFlagBits::e1);
-        imageCreateInfo.setUsage(imageInfo.usage);
+        const auto resolvedInfo = resolve_image_info(deviceRef, imageInfo);
+        const auto imageCreateInfo = make_image_create_info(resolvedInfo);
 
         VmaAllocationCreateInfo allocCreateInfo{};
         allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        if (imageInfo.pool)
+        {
+            auto poolResult = internal_memory_pool_get(imageInfo.pool);
+            if (!poolResult)
+            {
+                log_error("Unknown memory pool!");
+                return std::unexpected(poolResult.error());
+            }
+            allocCreateInfo.pool = poolResult.value().get().pool;
+        }
+        const auto hintsResult = internal_memory_hints_apply(imageInfo.memoryHints, allocCreateInfo);
+        if (hintsResult != ResultCode::eSuccess)
+        {
+            return std::unexpected(hintsResult);
+        }
 
         VkImageCreateInfo vkImageCreateInfo = imageCreateInfo;
         auto createResult = vmaCreateImage(deviceRef.allocator, &vkImageCreateInfo, &allocCreateInfo, &vkImage, &allocation, nullptr);
@@ -38,10 +338,63 @@ namespace vgw::internal
         }
 
         const vk::Image image = vkImage;
-        deviceRef.imageMap[image] = { image, allocation, imageInfo.format };
+        deviceRef.imageMap[image] = { image, allocation, imageInfo.format, imageInfo.mipLevels, 1, {}, resolvedInfo };
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
+        return image;
+    }
+
+    auto internal_image_create_aliased(const ImageInfo& imageInfo, VmaAllocation allocation, vk::DeviceSize offset)
+        -> std::expected<vk::Image, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto resolvedInfo = resolve_image_info(deviceRef, imageInfo);
+        const auto imageCreateInfo = make_image_create_info(resolvedInfo);
+        auto createResult = deviceRef.device.createImage(imageCreateInfo);
+        if (createResult.result != vk::Result::eSuccess)
+        {
+            log_error("Failed to create vk::Image!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        const auto image = createResult.value;
+
+        auto bindResult = vmaBindImageMemory2(deviceRef.allocator, allocation, offset, image, nullptr);
+        if (bindResult != VK_SUCCESS)
+        {
+            deviceRef.device.destroy(image);
+            log_error("Failed to bind vk::Image to VmaAllocation at offset {}!", offset);
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        // No allocation is stored, so destroying the image leaves the shared allocation alive.
+        deviceRef.imageMap[image] = { image, nullptr, imageInfo.format, imageInfo.mipLevels, 1, {}, resolvedInfo };
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
         return image;
     }
 
+    auto internal_image_memory_requirements_get(const ImageInfo& imageInfo) -> std::expected<vk::MemoryRequirements, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto imageCreateInfo = make_image_create_info(resolve_image_info(deviceRef, imageInfo));
+        const vk::DeviceImageMemoryRequirements requirementsInfo{ &imageCreateInfo };
+        return deviceRef.device.getImageMemoryRequirements(requirementsInfo).memoryRequirements;
+    }
+
     void internal_image_destroy(vk::Image image)
     {
         auto deviceResult = internal_device_get();
@@ -62,6 +415,7 @@ namespace vgw::internal
 
         vmaDestroyImage(deviceRef.allocator, image, imageRef.allocation);
         deviceRef.imageMap.erase(image);
+        internal_stats_add(internal_stats_get().resourcesDestroyed);
     }
 
     auto internal_image_get(vk::Image image) -> std::expected<std::reference_wrapper<ImageData>, ResultCode>
@@ -82,6 +436,180 @@ namespace vgw::internal
         return it->second;
     }
 
+    auto internal_image_aspect_get(vk::Format format) -> vk::ImageAspectFlags
+    {
+        switch (format)
+        {
+            case vk::Format::eD16Unorm:
+            case vk::Format::eX8D24UnormPack32:
+            case vk::Format::eD32Sfloat: return vk::ImageAspectFlagBits::eDepth;
+            case vk::Format::eS8Uint: return vk::ImageAspectFlagBits::eStencil;
+            case vk::Format::eD16UnormS8Uint:
+            case vk::Format::eD24UnormS8Uint:
+            case vk::Format::eD32SfloatS8Uint: return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+            default: return vk::ImageAspectFlagBits::eColor;
+        }
+    }
+
+    auto internal_image_upload_host(const ImageUploadInfo& uploadInfo) -> ResultCode
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return deviceResult.error();
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        auto imageResult = internal_image_get(uploadInfo.image);
+        if (!imageResult)
+        {
+            log_error("Cannot upload to unknown image!");
+            return ResultCode::eInvalidHandle;
+        }
+        auto& imageRef = imageResult.value().get();
+
+        for (const auto& region : uploadInfo.regions)
+        {
+            if (get_region_end(region, imageRef.format) > uploadInfo.pixels.size())
+            {
+                log_error("Image upload region reads past the end of the pixels ({} bytes)!", uploadInfo.pixels.size());
+                return ResultCode::eFailed;
+            }
+        }
+
+        if (imageRef.info.usage & vk::ImageUsageFlagBits::eHostTransferEXT)
+        {
+            return upload_image_with_host_copy(deviceRef, imageRef, uploadInfo);
+        }
+        return upload_image_with_staging(uploadInfo);
+    }
+
+    auto internal_host_image_copy_supported(vk::Format format) -> bool
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            return false;
+        }
+        return is_host_transfer_format(deviceResult.value().get(), format);
+    }
+
+    auto internal_image_require_state(vk::Image image, vk::ImageSubresourceRange range, const ImageSubresourceState& wantedState)
+        -> std::expected<std::vector<ImageTransitionInfo>, ResultCode>
+    {
+        auto imageResult = internal_image_get(image);
+        if (!imageResult)
+        {
+            return std::unexpected(imageResult.error());
+        }
+        auto& imageRef = imageResult.value().get();
+
+        range = resolve_range(imageRef, range);
+
+        std::vector<ImageTransitionInfo> transitions{};
+        auto push_transition = [&](const ImageTransitionInfo& transition)
+        {
+            // Merge with the previous layer if it needed the exact same barrier over the same mips.
+            if (!transitions.empty())
+            {
+                auto& last = transitions.back();
+                const auto& lastRange = last.subresourceRange;
+                const auto& newRange = transition.subresourceRange;
+                const bool sameMips = lastRange.baseMipLevel == newRange.baseMipLevel && lastRange.levelCount == newRange.levelCount;
+                const bool nextLayer = lastRange.baseArrayLayer + lastRange.layerCount == newRange.baseArrayLayer;
+                if (is_same_barrier(last, transition) && sameMips && nextLayer)
+                {
+                    last.subresourceRange.layerCount += newRange.layerCount;
+                    return;
+                }
+            }
+            transitions.push_back(transition);
+        };
+
+        for (auto layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; ++layer)
+        {
+            std::optional<ImageTransitionInfo> run{};
+            for (auto mip = range.baseMipLevel; mip < range.baseMipLevel + range.levelCount; ++mip)
+            {
+                auto& state = get_subresource_state(imageRef, mip, layer);
+
+                const bool layoutChange = state.layout != wantedState.layout;
+                const bool writeHazard = is_write_access(state.access) || is_write_access(wantedState.access);
+                const bool alreadyVisible = (state.access & wantedState.access) == wantedState.access &&
+                                            (state.stage & wantedState.stage) == wantedState.stage;
+                if (!layoutChange && !writeHazard && alreadyVisible)
+                {
+                    if (run)
+                    {
+                        push_transition(run.value());
+                        run.reset();
+                    }
+                    continue;
+                }
+
+                ImageTransitionInfo transition{
+                    .image = image,
+                    .oldLayout = state.layout,
+                    .newLayout = wantedState.layout,
+                    .srcAccess = get_write_access(state.access),
+                    .dstAccess = wantedState.access,
+                    .srcStage = state.stage,
+                    .dstStage = wantedState.stage,
+                    .subresourceRange = { range.aspectMask, mip, 1, layer, 1 },
+                };
+
+                if (!layoutChange && !writeHazard)
+                {
+                    // Read after read: widen the visible scope instead of replacing it.
+                    state.access |= wantedState.access;
+                    state.stage |= wantedState.stage;
+                }
+                else
+                {
+                    state = wantedState;
+                }
+
+                if (run && is_same_barrier(run.value(), transition) &&
+                    run->subresourceRange.baseMipLevel + run->subresourceRange.levelCount == mip)
+                {
+                    run->subresourceRange.levelCount++;
+                    continue;
+                }
+                if (run)
+                {
+                    push_transition(run.value());
+                }
+                run = transition;
+            }
+            if (run)
+            {
+                push_transition(run.value());
+            }
+        }
+
+        return transitions;
+    }
+
+    void internal_image_state_set(vk::Image image, vk::ImageSubresourceRange range, const ImageSubresourceState& state)
+    {
+        auto imageResult = internal_image_get(image);
+        if (!imageResult)
+        {
+            return;
+        }
+        auto& imageRef = imageResult.value().get();
+
+        range = resolve_range(imageRef, range);
+        for (auto layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; ++layer)
+        {
+            for (auto mip = range.baseMipLevel; mip < range.baseMipLevel + range.levelCount; ++mip)
+            {
+                get_subresource_state(imageRef, mip, layer) = state;
+            }
+        }
+    }
+
     auto internal_image_view_create(const ImageViewInfo& imageViewInfo) -> std::expected<vk::ImageView, ResultCode>
     {
         auto deviceResult = internal_device_get();
@@ -121,6 +649,8 @@ namespace vgw::internal
         auto imageView = createResult.value;
 
         deviceRef.imageViewMap.insert(imageView);
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
         return imageView;
     }
 
@@ -136,6 +666,7 @@ namespace vgw::internal
 
         deviceRef.device.destroy(imageView);
         deviceRef.imageViewMap.erase(imageView);
+        internal_stats_add(internal_stats_get().resourcesDestroyed);
     }
 
     auto internal_sampler_get(const SamplerInfo& samplerInfo) -> std::expected<vk::Sampler, ResultCode>
@@ -3,19 +3,53 @@
 #include "vgw/vgw.hpp"
 #include "internal_core.hpp"
 
+#include <vector>
+
 namespace vgw::internal
 {
+    struct ImageSubresourceState
+    {
+        vk::ImageLayout layout{ vk::ImageLayout::eUndefined };
+        vk::AccessFlags2 access{};
+        vk::PipelineStageFlags2 stage{};
+
+        auto operator==(const ImageSubresourceState&) const -> bool = default;
+    };
+
     struct ImageData
     {
         vk::Image image{};
         VmaAllocation allocation{};
         vk::Format format{};
+        std::uint32_t mipLevels{ 1 };
+        std::uint32_t arrayLayers{ 1 };
+        // Last known state of each subresource, indexed by `layer * mipLevels + mip`. Updated at record time.
+        std::vector<ImageSubresourceState> subresourceStates{};
+        // What the image was created with, so it can be recreated. Not set for swapchain images.
+        ImageInfo info{};
     };
     auto internal_image_create(const ImageInfo& imageInfo) -> std::expected<vk::Image, ResultCode>;
+    // Creates an image bound to `allocation` at `offset`. The allocation is not owned by the image.
+    auto internal_image_create_aliased(const ImageInfo& imageInfo, VmaAllocation allocation, vk::DeviceSize offset)
+        -> std::expected<vk::Image, ResultCode>;
+    auto internal_image_memory_requirements_get(const ImageInfo& imageInfo) -> std::expected<vk::MemoryRequirements, ResultCode>;
     void internal_image_destroy(vk::Image image);
 
     auto internal_image_get(vk::Image image) -> std::expected<std::reference_wrapper<ImageData>, ResultCode>;
 
+    auto internal_image_upload_host(const ImageUploadInfo& uploadInfo) -> ResultCode;
+    auto internal_host_image_copy_supported(vk::Format format) -> bool;
+
+    auto internal_image_aspect_get(vk::Format format) -> vk::ImageAspectFlags;
+
+    /**
+     * Computes the minimal set of transitions to bring the subresources into `wantedState` and records the new state.
+     * Returns an empty vector if every subresource is already in a compatible state.
+     */
+    auto internal_image_require_state(vk::Image image, vk::ImageSubresourceRange range, const ImageSubresourceState& wantedState)
+        -> std::expected<std::vector<ImageTransitionInfo>, ResultCode>;
+    void internal_image_state_set(vk::Image image, vk::ImageSubresourceRange range, const ImageSubresourceState& state);
+
     auto internal_image_view_create(const ImageViewInfo& imageViewInfo) -> std::expected<vk::ImageView, ResultCode>;
     void internal_image_view_destroy(vk::ImageView imageView);
 
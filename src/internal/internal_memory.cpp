@@ -0,0 +1,599 @@
+#include "internal_memory.hpp"
+
+#include "internal_device.hpp"
+#include "internal_stats.hpp"
+
+#include <numeric>
+#include <algorithm>
+
+namespace vgw::internal
+{
+    namespace
+    {
+        auto align_up(vk::DeviceSize value, vk::DeviceSize alignment) -> vk::DeviceSize
+        {
+            return alignment == 0 ? value : (value + alignment - 1) / alignment * alignment;
+        }
+
+        auto align_down(vk::DeviceSize value, vk::DeviceSize alignment) -> vk::DeviceSize
+        {
+            return alignment == 0 ? value : value / alignment * alignment;
+        }
+
+        auto make_memory_stats(const VmaDetailedStatistics& vmaStats) -> MemoryStats
+        {
+            MemoryStats stats{
+                .blockCount = vmaStats.statistics.blockCount,
+                .allocationCount = vmaStats.statistics.allocationCount,
+                .unusedRangeCount = vmaStats.unusedRangeCount,
+                .blockBytes = vmaStats.statistics.blockBytes,
+                .allocationBytes = vmaStats.statistics.allocationBytes,
+                .largestAllocation = vmaStats.allocationCount > 0 ? vmaStats.allocationSizeMax : 0,
+                .largestUnusedRange = vmaStats.unusedRangeCount > 0 ? vmaStats.unusedRangeSizeMax : 0,
+            };
+            const auto unusedBytes = stats.blockBytes - stats.allocationBytes;
+            if (unusedBytes > 0)
+            {
+                stats.fragmentation = 1.0f - float(double(stats.largestUnusedRange) / double(unusedBytes));
+            }
+            return stats;
+        }
+    }
+
+    auto internal_memory_pack_intervals(std::vector<MemoryInterval>& intervals, vk::DeviceSize bufferImageGranularity) -> vk::DeviceSize
+    {
+        std::vector<std::size_t> order(intervals.size());
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        std::ranges::stable_sort(order, std::greater<>{}, [&](std::size_t i) { return intervals.at(i).size; });
+
+        auto lifetimes_overlap = [](const MemoryInterval& lhs, const MemoryInterval& rhs)
+        { return lhs.firstUse <= rhs.lastUse && rhs.firstUse <= lhs.lastUse; };
+        // Linear and non-linear resources on the same granularity page count as aliasing, so their extents are widened to whole pages.
+        auto needs_granularity = [&](const MemoryInterval& lhs, const MemoryInterval& rhs)
+        {
+            return bufferImageGranularity > 1 &&
+                   (lhs.linearity == ResourceLinearity::eUnknown || rhs.linearity == ResourceLinearity::eUnknown ||
+                    lhs.linearity != rhs.linearity);
+        };
+        auto memory_overlaps = [&](const MemoryInterval& lhs, const MemoryInterval& rhs, vk::DeviceSize offset)
+        {
+            if (!needs_granularity(lhs, rhs))
+            {
+                return lhs.offset < offset + rhs.size && offset < lhs.offset + lhs.size;
+            }
+            const auto lhsBegin = align_down(lhs.offset, bufferImageGranularity);
+            const auto lhsEnd = align_up(lhs.offset + lhs.size, bufferImageGranularity);
+            return lhsBegin < align_up(offset + rhs.size, bufferImageGranularity) && align_down(offset, bufferImageGranularity) < lhsEnd;
+        };
+
+        vk::DeviceSize totalSize{};
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            auto& interval = intervals.at(order.at(i));
+            const auto placedBegin = order.begin();
+            const auto placedEnd = order.begin() + std::ptrdiff_t(i);
+
+            // The end of every placed interval that is alive at the same time. The highest always fits.
+            std::vector<vk::DeviceSize> candidates{ 0 };
+            for (auto it = placedBegin; it != placedEnd; ++it)
+            {
+                const auto& placed = intervals.at(*it);
+                if (lifetimes_overlap(placed, interval))
+                {
+                    auto placedEnd = placed.offset + placed.size;
+                    if (needs_granularity(placed, interval))
+                    {
+                        placedEnd = align_up(placedEnd, bufferImageGranularity);
+                    }
+                    candidates.push_back(align_up(placedEnd, interval.alignment));
+                }
+            }
+            std::ranges::sort(candidates);
+
+            for (auto candidate : candidates)
+            {
+                const bool fits = std::none_of(placedBegin,
+                                               placedEnd,
+                                               [&](std::size_t placedIndex)
+                                               {
+                                                   const auto& placed = intervals.at(placedIndex);
+                                                   return lifetimes_overlap(placed, interval) &&
+                                                          memory_overlaps(placed, interval, candidate);
+                                               });
+                if (fits)
+                {
+                    interval.offset = candidate;
+                    break;
+                }
+            }
+
+            totalSize = std::max(totalSize, interval.offset + interval.size);
+        }
+        return totalSize;
+    }
+
+    auto internal_memory_allocate(const vk::MemoryRequirements& requirements) -> std::expected<VmaAllocation, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        VkMemoryRequirements vkRequirements = requirements;
+
+        VmaAllocationCreateInfo allocCreateInfo{};
+        allocCreateInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+        VmaAllocation allocation{};
+        auto allocResult = vmaAllocateMemory(deviceRef.allocator, &vkRequirements, &allocCreateInfo, &allocation, nullptr);
+        if (allocResult != VK_SUCCESS)
+        {
+            log_error("Failed to allocate VmaAllocation ({} bytes)!", requirements.size);
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        deviceRef.memoryAllocations.insert(allocation);
+        return allocation;
+    }
+
+    void internal_memory_free(VmaAllocation allocation)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        if (deviceRef.memoryAllocations.erase(allocation) == 0)
+        {
+            log_warn("Tried to free unknown memory allocation.");
+            return;
+        }
+        vmaFreeMemory(deviceRef.allocator, allocation);
+    }
+
+    auto internal_memory_hints_apply(const MemoryHints& hints, VmaAllocationCreateInfo& allocCreateInfo) -> ResultCode
+    {
+        if (hints.dedicated)
+        {
+            // Pools allocate fixed size blocks, so VMA cannot give a pool allocation its own memory.
+            if (allocCreateInfo.pool != VK_NULL_HANDLE)
+            {
+                log_error("Dedicated memory cannot be allocated from a memory pool!");
+                return ResultCode::eFailedToCreate;
+            }
+            allocCreateInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        }
+        allocCreateInfo.priority = std::clamp(hints.priority, 0.0f, 1.0f);
+
+        if (hints.hostVisibleDeviceLocal)
+        {
+            constexpr VmaAllocationCreateFlags HostAccessFlags =
+                VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+            if (!(allocCreateInfo.flags & HostAccessFlags))
+            {
+                allocCreateInfo.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+            }
+            // The host access flag makes host visible memory required; device local is then preferred over plain host memory.
+            allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+            allocCreateInfo.preferredFlags |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        }
+        return ResultCode::eSuccess;
+    }
+
+    auto internal_memory_budget_get() -> std::expected<std::vector<MemoryHeapBudget>, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const VkPhysicalDeviceMemoryProperties* memoryProperties{ nullptr };
+        vmaGetMemoryProperties(deviceRef.allocator, &memoryProperties);
+
+        std::vector<VmaBudget> vmaBudgets(memoryProperties->memoryHeapCount);
+        vmaGetHeapBudgets(deviceRef.allocator, vmaBudgets.data());
+
+        std::vector<MemoryHeapBudget> budgets{};
+        for (std::uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i)
+        {
+            const auto& vmaBudget = vmaBudgets.at(i);
+            budgets.push_back({
+                .heapIndex = i,
+                .flags = vk::MemoryHeapFlags(memoryProperties->memoryHeaps[i].flags),
+                .heapSize = memoryProperties->memoryHeaps[i].size,
+                .budget = vmaBudget.budget,
+                .usage = vmaBudget.usage,
+                .blockBytes = vmaBudget.statistics.blockBytes,
+                .allocationBytes = vmaBudget.statistics.allocationBytes,
+                .blockCount = vmaBudget.statistics.blockCount,
+                .allocationCount = vmaBudget.statistics.allocationCount,
+            });
+        }
+        return budgets;
+    }
+
+    auto internal_memory_capabilities_get() -> std::expected<MemoryCapabilities, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const VkPhysicalDeviceMemoryProperties* memoryProperties{ nullptr };
+        vmaGetMemoryProperties(deviceRef.allocator, &memoryProperties);
+
+        MemoryCapabilities capabilities{};
+        capabilities.isMemoryPrioritySupported = deviceRef.isMemoryPriorityEnabled;
+
+        constexpr VkMemoryPropertyFlags HostVisibleDeviceLocal = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        std::vector<bool> isHeapCounted(memoryProperties->memoryHeapCount, false);
+        for (std::uint32_t i = 0; i < memoryProperties->memoryTypeCount; ++i)
+        {
+            const auto& memoryType = memoryProperties->memoryTypes[i];
+            if ((memoryType.propertyFlags & HostVisibleDeviceLocal) != HostVisibleDeviceLocal)
+            {
+                continue;
+            }
+            capabilities.hasHostVisibleDeviceLocal = true;
+            if (!isHeapCounted.at(memoryType.heapIndex))
+            {
+                isHeapCounted.at(memoryType.heapIndex) = true;
+                capabilities.hostVisibleDeviceLocalBytes += memoryProperties->memoryHeaps[memoryType.heapIndex].size;
+            }
+        }
+
+        capabilities.isUnifiedMemory = true;
+        for (std::uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i)
+        {
+            if (!(memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+            {
+                capabilities.isUnifiedMemory = false;
+            }
+        }
+        return capabilities;
+    }
+
+    auto internal_memory_stats_get() -> std::expected<MemoryStats, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        VmaTotalStatistics vmaStats{};
+        vmaCalculateStatistics(deviceRef.allocator, &vmaStats);
+        return make_memory_stats(vmaStats.total);
+    }
+
+    auto internal_memory_pool_create(const PoolInfo& poolInfo) -> std::expected<MemoryPool, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        VmaAllocationCreateInfo allocCreateInfo{};
+        allocCreateInfo.usage = poolInfo.memUsage;
+        allocCreateInfo.flags = poolInfo.allocFlags;
+
+        // VMA picks the memory type from an example resource, which is never created.
+        std::uint32_t memoryTypeIndex{};
+        VkResult findResult{};
+        if (poolInfo.bufferUsage)
+        {
+            vk::BufferCreateInfo bufferCreateInfo{};
+            bufferCreateInfo.setSize(0x10000);
+            bufferCreateInfo.setUsage(poolInfo.bufferUsage);
+            VkBufferCreateInfo vkBufferCreateInfo = bufferCreateInfo;
+            findResult = vmaFindMemoryTypeIndexForBufferInfo(deviceRef.allocator, &vkBufferCreateInfo, &allocCreateInfo, &memoryTypeIndex);
+        }
+        else if (poolInfo.imageUsage)
+        {
+            vk::ImageCreateInfo imageCreateInfo{};
+            imageCreateInfo.setImageType(vk::ImageType::e2D);
+            imageCreateInfo.setFormat(poolInfo.imageFormat);
+            imageCreateInfo.setExtent({ 256, 256, 1 });
+            imageCreateInfo.setMipLevels(1);
+            imageCreateInfo.setArrayLayers(1);
+            imageCreateInfo.setSamples(vk::SampleCountFlagBits::e1);
+            imageCreateInfo.setUsage(poolInfo.imageUsage);
+            VkImageCreateInfo vkImageCreateInfo = imageCreateInfo;
+            findResult = vmaFindMemoryTypeIndexForImageInfo(deviceRef.allocator, &vkImageCreateInfo, &allocCreateInfo, &memoryTypeIndex);
+        }
+        else
+        {
+            log_error("Memory pool needs a buffer usage or an image usage to pick its memory type!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        if (findResult != VK_SUCCESS)
+        {
+            log_error("Failed to find a memory type for the memory pool!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        VmaPoolCreateInfo poolCreateInfo{};
+        poolCreateInfo.memoryTypeIndex = memoryTypeIndex;
+        poolCreateInfo.blockSize = poolInfo.blockSize;
+        poolCreateInfo.minBlockCount = poolInfo.minBlockCount;
+        poolCreateInfo.maxBlockCount = poolInfo.maxBlockCount;
+        switch (poolInfo.algorithm)
+        {
+            case PoolAlgorithm::eDefault: break;
+            case PoolAlgorithm::eLinear: poolCreateInfo.flags |= VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT; break;
+            case PoolAlgorithm::eRing:
+                // The linear algorithm only wraps around when the pool has exactly one block.
+                poolCreateInfo.flags |= VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT;
+                poolCreateInfo.minBlockCount = 1;
+                poolCreateInfo.maxBlockCount = 1;
+                break;
+        }
+
+        VmaPool vmaPool{};
+        auto createResult = vmaCreatePool(deviceRef.allocator, &poolCreateInfo, &vmaPool);
+        if (createResult != VK_SUCCESS)
+        {
+            log_error("Failed to create VmaPool (memory type {}, block size {})!", memoryTypeIndex, poolInfo.blockSize);
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        auto poolData = std::make_unique<MemoryPoolData>();
+        poolData->pool = vmaPool;
+        poolData->algorithm = poolInfo.algorithm;
+
+        MemoryPool pool = poolData.get();
+        deviceRef.memoryPoolMap[pool] = std::move(poolData);
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
+        return pool;
+    }
+
+    void internal_memory_pool_destroy(MemoryPool pool)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.memoryPoolMap.find(pool);
+        if (it == deviceRef.memoryPoolMap.end())
+        {
+            log_warn("Tried to destroy unknown memory pool.");
+            return;
+        }
+
+        VmaStatistics vmaStats{};
+        vmaGetPoolStatistics(deviceRef.allocator, it->second->pool, &vmaStats);
+        if (vmaStats.allocationCount > 0)
+        {
+            log_error("Cannot destroy memory pool with {} allocations still in use!", vmaStats.allocationCount);
+            return;
+        }
+
+        vmaDestroyPool(deviceRef.allocator, it->second->pool);
+        deviceRef.memoryPoolMap.erase(it);
+        internal_stats_add(internal_stats_get().resourcesDestroyed);
+    }
+
+    auto internal_memory_pool_get(MemoryPool pool) -> std::expected<std::reference_wrapper<MemoryPoolData>, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.memoryPoolMap.find(pool);
+        if (it == deviceRef.memoryPoolMap.end())
+        {
+            return std::unexpected(ResultCode::eInvalidHandle);
+        }
+
+        return *it->second;
+    }
+
+    auto internal_memory_pool_stats_get(MemoryPool pool) -> std::expected<MemoryStats, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        auto poolResult = internal_memory_pool_get(pool);
+        if (!poolResult)
+        {
+            log_error("Unknown memory pool!");
+            return std::unexpected(poolResult.error());
+        }
+
+        VmaDetailedStatistics vmaStats{};
+        vmaCalculatePoolStatistics(deviceRef.allocator, poolResult.value().get().pool, &vmaStats);
+        return make_memory_stats(vmaStats);
+    }
+
+    auto internal_memory_json_get(bool detailed) -> std::expected<std::string, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        char* statsString{ nullptr };
+        vmaBuildStatsString(deviceRef.allocator, &statsString, detailed ? VK_TRUE : VK_FALSE);
+        std::string json = statsString;
+        vmaFreeStatsString(deviceRef.allocator, statsString);
+        return json;
+    }
+
+    auto internal_aliasing_heap_create(const AliasingHeapInfo& heapInfo) -> std::expected<AliasingHeapLayout, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        if (heapInfo.resources.empty())
+        {
+            log_error("Cannot create an aliasing heap without resources!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        std::vector<MemoryInterval> intervals{};
+        intervals.reserve(heapInfo.resources.size());
+        std::uint32_t memoryTypeBits = ~0u;
+        vk::DeviceSize heapAlignment{ 1 };
+        vk::DeviceSize unaliasedSize{};
+        for (const auto& resource : heapInfo.resources)
+        {
+            if (resource.firstUse > resource.lastUse)
+            {
+                log_error("Transient resource is first used ({}) after it is last used ({})!", resource.firstUse, resource.lastUse);
+                return std::unexpected(ResultCode::eFailedToCreate);
+            }
+
+            const auto& requirements = resource.requirements;
+            memoryTypeBits &= requirements.memoryTypeBits;
+            heapAlignment = std::max(heapAlignment, requirements.alignment);
+            unaliasedSize += align_up(requirements.size, requirements.alignment);
+            intervals.push_back({ requirements.size, requirements.alignment, resource.firstUse, resource.lastUse, resource.linearity });
+        }
+        if (memoryTypeBits == 0)
+        {
+            log_error("Aliasing heap resources have no memory type in common!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        const auto bufferImageGranularity = deviceRef.physicalDevice.getProperties().limits.bufferImageGranularity;
+        const auto heapSize = internal_memory_pack_intervals(intervals, bufferImageGranularity);
+        auto memoryResult = internal_memory_allocate({ heapSize, heapAlignment, memoryTypeBits });
+        if (!memoryResult)
+        {
+            return std::unexpected(memoryResult.error());
+        }
+
+        VmaAllocationInfo allocInfo{};
+        vmaGetAllocationInfo(deviceRef.allocator, memoryResult.value(), &allocInfo);
+
+        auto heapData = std::make_unique<AliasingHeapData>();
+        heapData->allocation = memoryResult.value();
+        heapData->size = heapSize;
+        heapData->memoryTypeIndex = allocInfo.memoryType;
+
+        AliasingHeapLayout layout{
+            .heap = heapData.get(),
+            .size = heapSize,
+            .unaliasedSize = unaliasedSize,
+        };
+        for (const auto& interval : intervals)
+        {
+            layout.offsets.push_back(interval.offset);
+        }
+        deviceRef.aliasingHeapMap[layout.heap] = std::move(heapData);
+
+        log_debug("Aliasing heap: {} bytes for {} resources ({} bytes without aliasing).", heapSize, intervals.size(), unaliasedSize);
+        internal_stats_add(internal_stats_get().resourcesCreated);
+        return layout;
+    }
+
+    void internal_aliasing_heap_destroy(AliasingHeap heap)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.aliasingHeapMap.find(heap);
+        if (it == deviceRef.aliasingHeapMap.end())
+        {
+            log_warn("Tried to destroy unknown aliasing heap.");
+            return;
+        }
+
+        internal_memory_free(it->second->allocation);
+        deviceRef.aliasingHeapMap.erase(it);
+        internal_stats_add(internal_stats_get().resourcesDestroyed);
+    }
+
+    auto internal_aliasing_heap_get(AliasingHeap heap) -> std::expected<std::reference_wrapper<AliasingHeapData>, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.aliasingHeapMap.find(heap);
+        if (it == deviceRef.aliasingHeapMap.end())
+        {
+            return std::unexpected(ResultCode::eInvalidHandle);
+        }
+
+        return *it->second;
+    }
+
+    auto internal_aliasing_heap_allocation_get(const AliasingPlacement& placement, const vk::MemoryRequirements& requirements)
+        -> std::expected<VmaAllocation, ResultCode>
+    {
+        auto heapResult = internal_aliasing_heap_get(placement.heap);
+        if (!heapResult)
+        {
+            log_error("Unknown aliasing heap!");
+            return std::unexpected(heapResult.error());
+        }
+        const auto& heapRef = heapResult.value().get();
+
+        if ((requirements.memoryTypeBits & (1u << heapRef.memoryTypeIndex)) == 0)
+        {
+            log_error("Resource does not support the memory type of the aliasing heap!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        if (requirements.alignment != 0 && placement.offset % requirements.alignment != 0)
+        {
+            log_error("Aliasing heap offset {} is not aligned to {}!", placement.offset, requirements.alignment);
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        if (placement.offset + requirements.size > heapRef.size)
+        {
+            log_error("Resource ({} bytes at offset {}) does not fit in the aliasing heap ({} bytes)!",
+                      requirements.size,
+                      placement.offset,
+                      heapRef.size);
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        return heapRef.allocation;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "vgw/vgw.hpp"
+#include "internal_core.hpp"
+
+#include <vector>
+
+namespace vgw::internal
+{
+    struct AliasingHeapData
+    {
+        VmaAllocation allocation{};
+        vk::DeviceSize size{};
+        std::uint32_t memoryTypeIndex{};
+    };
+
+    struct MemoryPoolData
+    {
+        VmaPool pool{};
+        PoolAlgorithm algorithm{};
+    };
+
+    struct MemoryInterval
+    {
+        vk::DeviceSize size{};
+        vk::DeviceSize alignment{};
+        // Inclusive range of the positions the memory is used in.
+        std::uint32_t firstUse{};
+        std::uint32_t lastUse{};
+        ResourceLinearity linearity{};
+        // Assigned by `internal_memory_pack_intervals`.
+        vk::DeviceSize offset{};
+    };
+    /**
+     * Assigns an offset to each interval so intervals that are alive at the same time never overlap in memory, and linear and
+     * non-linear intervals alive at the same time never share a `bufferImageGranularity` page.
+     * Greedy: largest first, each at the lowest offset that does not overlap an already placed interval with an overlapping lifetime.
+     * Returns the memory size needed.
+     */
+    auto internal_memory_pack_intervals(std::vector<MemoryInterval>& intervals, vk::DeviceSize bufferImageGranularity) -> vk::DeviceSize;
+
+    auto internal_memory_allocate(const vk::MemoryRequirements& requirements) -> std::expected<VmaAllocation, ResultCode>;
+    void internal_memory_free(VmaAllocation allocation);
+
+    // Adds the hints to an allocation's create info, on top of the usage/flags/pool already set. Fails for hints the pool cannot honour.
+    auto internal_memory_hints_apply(const MemoryHints& hints, VmaAllocationCreateInfo& allocCreateInfo) -> ResultCode;
+
+    auto internal_memory_budget_get() -> std::expected<std::vector<MemoryHeapBudget>, ResultCode>;
+    auto internal_memory_capabilities_get() -> std::expected<MemoryCapabilities, ResultCode>;
+    auto internal_memory_stats_get() -> std::expected<MemoryStats, ResultCode>;
+
+    auto internal_memory_pool_create(const PoolInfo& poolInfo) -> std::expected<MemoryPool, ResultCode>;
+    void internal_memory_pool_destroy(MemoryPool pool);
+
+    auto internal_memory_pool_get(MemoryPool pool) -> std::expected<std::reference_wrapper<MemoryPoolData>, ResultCode>;
+    auto internal_memory_pool_stats_get(MemoryPool pool) -> std::expected<MemoryStats, ResultCode>;
+    auto internal_memory_json_get(bool detailed) -> std::expected<std::string, ResultCode>;
+
+    auto internal_aliasing_heap_create(const AliasingHeapInfo& heapInfo) -> std::expected<AliasingHeapLayout, ResultCode>;
+    void internal_aliasing_heap_destroy(AliasingHeap heap);
+
+    auto internal_aliasing_heap_get(AliasingHeap heap) -> std::expected<std::reference_wrapper<AliasingHeapData>, ResultCode>;
+    // Returns the heap's allocation if a resource with `requirements` can be bound at the placement's offset.
+    auto internal_aliasing_heap_allocation_get(const AliasingPlacement& placement, const vk::MemoryRequirements& requirements)
+        -> std::expected<VmaAllocation, ResultCode>;
+}
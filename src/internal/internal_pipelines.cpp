@@ -1,9 +1,72 @@
 #include "internal_pipelines.hpp"
 
 #include "internal_device.hpp"
+#include "internal_stats.hpp"
+#include "internal_trace.hpp"
+
+#include <span>
+#include <array>
+#include <algorithm>
 
 namespace vgw::internal
 {
+    namespace
+    {
+        auto make_pipeline_feedback(const vk::PipelineCreationFeedback& pipelineFeedback,
+                                    std::span<const vk::PipelineCreationFeedback> stageFeedbacks,
+                                    std::span<const vk::PipelineShaderStageCreateInfo> stages) -> PipelineFeedback
+        {
+            constexpr double NsPerMs = 1'000'000.0;
+
+            PipelineFeedback feedback{};
+            feedback.isValid = bool(pipelineFeedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid);
+            feedback.isCacheHit = bool(pipelineFeedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit);
+            feedback.usedBasePipelineAcceleration =
+                bool(pipelineFeedback.flags & vk::PipelineCreationFeedbackFlagBits::eBasePipelineAcceleration);
+            feedback.durationMs = double(pipelineFeedback.duration) / NsPerMs;
+            for (std::size_t i = 0; i < stages.size(); ++i)
+            {
+                const auto& stageFeedback = stageFeedbacks[i];
+                feedback.stages.push_back({
+                    .stage = stages[i].stage,
+                    .isValid = bool(stageFeedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid),
+                    .isCacheHit = bool(stageFeedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit),
+                    .durationMs = double(stageFeedback.duration) / NsPerMs,
+                });
+            }
+            return feedback;
+        }
+
+        void report_pipeline_feedback(const PipelineFeedback& feedback)
+        {
+            if (!feedback.isValid)
+            {
+                log_debug("Pipeline '{}' created. No creation feedback available.", feedback.name);
+                return;
+            }
+            log_debug("Pipeline '{}' created in {:.3f} ms (cache hit: {}).", feedback.name, feedback.durationMs, feedback.isCacheHit);
+
+#ifdef VGW_ENABLE_TRACING
+            // The driver only reports a duration, so the event is placed to end now.
+            std::string argsJson = std::format("{{\"cacheHit\":{},\"stages\":[", feedback.isCacheHit);
+            for (std::size_t i = 0; i < feedback.stages.size(); ++i)
+            {
+                const auto& stage = feedback.stages.at(i);
+                argsJson += std::format("{}{{\"stage\":\"{}\",\"cacheHit\":{},\"durationMs\":{:.3f}}}",
+                                        i > 0 ? "," : "",
+                                        vk::to_string(stage.stage),
+                                        stage.isCacheHit,
+                                        stage.durationMs);
+            }
+            argsJson += "]}";
+
+            const auto endNs = trace_now_ns();
+            const auto startNs = endNs - std::uint64_t(feedback.durationMs * 1'000'000.0);
+            internal_trace_detail_event_add("pipeline", feedback.name, startNs, endNs, std::move(argsJson));
+#endif
+        }
+    }
+
     auto internal_pipeline_compute_create(const ComputePipelineInfo& pipelineInfo) -> std::expected<vk::Pipeline, ResultCode>
     {
         auto deviceResult = internal_device_get();
@@ -28,10 +91,17 @@ namespace vgw::internal
         shaderStageCreateInfo.setPName("main");
         shaderStageCreateInfo.setModule(shaderModule.get());
 
+        vk::PipelineCreationFeedback pipelineFeedback{};
+        std::array<vk::PipelineCreationFeedback, 1> stageFeedbacks{};
+        vk::PipelineCreationFeedbackCreateInfo feedbackCreateInfo{};
+        feedbackCreateInfo.setPPipelineCreationFeedback(&pipelineFeedback);
+        feedbackCreateInfo.setPipelineStageCreationFeedbacks(stageFeedbacks);
+
         vk::ComputePipelineCreateInfo pipelineCreateInfo{};
         pipelineCreateInfo.setLayout(pipelineInfo.layout);
         pipelineCreateInfo.setStage(shaderStageCreateInfo);
-        auto createResult = deviceRef.device.createComputePipeline({}, pipelineCreateInfo);
+        pipelineCreateInfo.setPNext(&feedbackCreateInfo);
+        auto createResult = deviceRef.device.createComputePipeline(deviceRef.pipelineCache, pipelineCreateInfo);
         if (createResult.result != vk::Result::eSuccess)
         {
             log_error("Failed to create vk::Pipeline (Compute)!");
@@ -43,6 +113,15 @@ namespace vgw::internal
             createResult.value,
             vk::PipelineBindPoint::eCompute,
         };
+
+        auto& feedback = deviceRef.pipelineMap[createResult.value].feedback;
+        feedback = make_pipeline_feedback(pipelineFeedback, stageFeedbacks, { &shaderStageCreateInfo, 1 });
+        feedback.pipeline = createResult.value;
+        feedback.name = pipelineInfo.name;
+        feedback.bindPoint = vk::PipelineBindPoint::eCompute;
+        report_pipeline_feedback(feedback);
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
         return createResult.value;
     }
 
@@ -147,8 +226,16 @@ namespace vgw::internal
         pipelineCreateInfo.setPDepthStencilState(&depth_stencil_state);
         pipelineCreateInfo.setPColorBlendState(&color_blend_state);
         pipelineCreateInfo.setPDynamicState(&dynamic_state);
-        pipelineCreateInfo.setPNext(&rendering_info);
-        auto createResult = deviceRef.device.createGraphicsPipeline({}, pipelineCreateInfo);
+
+        vk::PipelineCreationFeedback pipelineFeedback{};
+        std::array<vk::PipelineCreationFeedback, 2> stageFeedbacks{};
+        vk::PipelineCreationFeedbackCreateInfo feedbackCreateInfo{};
+        feedbackCreateInfo.setPPipelineCreationFeedback(&pipelineFeedback);
+        feedbackCreateInfo.setPipelineStageCreationFeedbacks(stageFeedbacks);
+        feedbackCreateInfo.setPNext(&rendering_info);
+
+        pipelineCreateInfo.setPNext(&feedbackCreateInfo);
+        auto createResult = deviceRef.device.createGraphicsPipeline(deviceRef.pipelineCache, pipelineCreateInfo);
         if (createResult.result != vk::Result::eSuccess)
         {
             log_error("Failed to create vk::Pipeline (Graphics)!");
@@ -160,6 +247,15 @@ namespace vgw::internal
             createResult.value,
             vk::PipelineBindPoint::eGraphics,
         };
+
+        auto& feedback = deviceRef.pipelineMap[createResult.value].feedback;
+        feedback = make_pipeline_feedback(pipelineFeedback, stageFeedbacks, stages);
+        feedback.pipeline = createResult.value;
+        feedback.name = pipelineInfo.name;
+        feedback.bindPoint = vk::PipelineBindPoint::eGraphics;
+        report_pipeline_feedback(feedback);
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
         return createResult.value;
     }
 
@@ -182,6 +278,26 @@ namespace vgw::internal
         return std::unexpected(ResultCode::eInvalidHandle);
     }
 
+    auto internal_pipeline_feedback_report_get() -> std::vector<PipelineFeedback>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return {};
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        std::vector<PipelineFeedback> report{};
+        report.reserve(deviceRef.pipelineMap.size());
+        for (const auto& [_, data] : deviceRef.pipelineMap)
+        {
+            report.push_back(data.feedback);
+        }
+        std::ranges::sort(report, std::greater<>{}, &PipelineFeedback::durationMs);
+        return report;
+    }
+
     void internal_pipeline_bind(vk::CommandBuffer cmdBuffer, vk::Pipeline pipeline)
     {
         auto getResult = internal_pipeline_get(pipeline);
@@ -194,4 +310,28 @@ namespace vgw::internal
 
         cmdBuffer.bindPipeline(pipelineRef.bindPoint, pipelineRef.pipeline);
     }
-}
\ No newline at end of file
+
+    auto internal_pipeline_cache_data_get() -> std::expected<std::vector<std::uint8_t>, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        if (!deviceRef.pipelineCache)
+        {
+            log_error("Device has no pipeline cache!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+        auto dataResult = deviceRef.device.getPipelineCacheData(deviceRef.pipelineCache);
+        if (dataResult.result != vk::Result::eSuccess)
+        {
+            log_error("Failed to get pipeline cache data!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+        return dataResult.value;
+    }
+}
@@ -10,12 +10,15 @@ namespace vgw::internal
         vk::PipelineLayout layout{};
         vk::Pipeline pipeline{};
         vk::PipelineBindPoint bindPoint{};
+        PipelineFeedback feedback{};
     };
 
     auto internal_pipeline_compute_create(const ComputePipelineInfo& pipelineInfo) -> std::expected<vk::Pipeline, ResultCode>;
     auto internal_pipeline_graphics_create(const GraphicsPipelineInfo& pipelineInfo) -> std::expected<vk::Pipeline, ResultCode>;
 
     auto internal_pipeline_get(vk::Pipeline pipeline) -> std::expected<std::reference_wrapper<PipelineData>, ResultCode>;
+    auto internal_pipeline_feedback_report_get() -> std::vector<PipelineFeedback>;
+    auto internal_pipeline_cache_data_get() -> std::expected<std::vector<std::uint8_t>, ResultCode>;
 
     void internal_pipeline_bind(vk::CommandBuffer cmdBuffer, vk::Pipeline pipeline);
 }
\ No newline at end of file
@@ -0,0 +1,642 @@
+#include "internal_queries.hpp"
+
+#include "internal_device.hpp"
+#include "internal_stats.hpp"
+#include "internal_trace.hpp"
+
+#include <bit>
+#include <algorithm>
+
+namespace vgw::internal
+{
+    namespace
+    {
+        // Reads the timestamps of `frameRef` without waiting. Returns false if any closed scope is not available yet.
+        bool resolve_frame(GpuProfilerData& profilerRef, vk::Device device, GpuProfilerFrame& frameRef)
+        {
+            if (frameRef.queryCount == 0)
+            {
+                frameRef.isPending = false;
+                return true;
+            }
+
+            // Pairs of { timestamp, availability }
+            std::vector<std::uint64_t> queryData(std::size_t(frameRef.queryCount) * 2);
+            auto result = device.getQueryPoolResults(frameRef.queryPool,
+                                                     0,
+                                                     frameRef.queryCount,
+                                                     queryData.size() * sizeof(std::uint64_t),
+                                                     queryData.data(),
+                                                     sizeof(std::uint64_t) * 2,
+                                                     vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+            if (result != vk::Result::eSuccess && result != vk::Result::eNotReady)
+            {
+                log_error("Failed to get GPU profiler query results!");
+                frameRef.isPending = false;
+                return true;
+            }
+
+            auto is_available = [&](std::uint32_t query) { return queryData.at(std::size_t(query) * 2 + 1) != 0; };
+            auto get_timestamp = [&](std::uint32_t query) { return queryData.at(std::size_t(query) * 2) & profilerRef.timestampMask; };
+            for (const auto& scope : frameRef.scopes)
+            {
+                if (scope.isClosed && (!is_available(scope.beginQuery) || !is_available(scope.endQuery)))
+                {
+                    return false;
+                }
+            }
+
+            std::uint64_t frameStart{ std::uint64_t(-1) };
+            std::uint64_t frameEnd{};
+            for (const auto& scope : frameRef.scopes)
+            {
+                if (scope.isClosed)
+                {
+                    frameStart = std::min(frameStart, get_timestamp(scope.beginQuery));
+                    frameEnd = std::max(frameEnd, get_timestamp(scope.endQuery));
+                }
+            }
+
+            const auto to_ms = [&](std::uint64_t ticks) { return double(ticks) * profilerRef.timestampPeriod / 1'000'000.0; };
+
+            GpuFrameReport report{ .frameNumber = frameRef.frameNumber };
+            report.frameMs = frameEnd > frameStart ? to_ms(frameEnd - frameStart) : 0.0;
+
+            std::vector<std::string> scopePaths{};
+            std::map<std::string, double> frameTotals{};
+            for (const auto& scope : frameRef.scopes)
+            {
+                auto& timing = report.scopes.emplace_back();
+                timing.name = scope.name;
+                timing.parent = scope.parent;
+                timing.depth = scope.depth;
+                if (!scope.isClosed)
+                {
+                    log_warn("GPU scope '{}' was never ended.", scope.name);
+                }
+                else
+                {
+                    const auto begin = get_timestamp(scope.beginQuery);
+                    const auto end = get_timestamp(scope.endQuery);
+                    timing.startMs = to_ms(begin - frameStart);
+                    timing.durationMs = end > begin ? to_ms(end - begin) : 0.0;
+                }
+
+#ifdef VGW_ENABLE_TRACING
+                if (scope.isClosed)
+                {
+                    const auto startNs = frameRef.cpuBeginNs + std::uint64_t(timing.startMs * 1'000'000.0);
+                    const auto endNs = startNs + std::uint64_t(timing.durationMs * 1'000'000.0);
+                    internal_trace_gpu_event_add(scope.name, scope.depth, startNs, endNs);
+                }
+#endif
+
+                const auto& path = scopePaths.emplace_back(scope.parent < 0 ? scope.name : scopePaths.at(scope.parent) + "/" + scope.name);
+                frameTotals[path] += timing.durationMs;
+            }
+
+            for (const auto& [path, durationMs] : frameTotals)
+            {
+                auto& history = profilerRef.scopeHistory[path];
+                history.push_back(durationMs);
+                while (history.size() > profilerRef.historyLength)
+                {
+                    history.pop_front();
+                }
+            }
+
+            if (!profilerRef.lastReport || profilerRef.lastReport->frameNumber < report.frameNumber)
+            {
+                profilerRef.lastReport = std::move(report);
+            }
+            frameRef.isPending = false;
+            return true;
+        }
+
+        // Takes a free query from a pool of the matching type and statistics, creating a pool if they are all in use.
+        bool allocate_query_slot(DeviceData& deviceRef, QueryData& queryRef)
+        {
+            auto poolIt = std::ranges::find_if(deviceRef.queryPools,
+                                               [&](const QueryPoolData& pool)
+                                               {
+                                                   return pool.type == queryRef.type && pool.statistics == queryRef.statistics &&
+                                                          !pool.freeQueries.empty();
+                                               });
+            if (poolIt == deviceRef.queryPools.end())
+            {
+                vk::QueryPoolCreateInfo poolCreateInfo{};
+                poolCreateInfo.setQueryType(queryRef.type);
+                poolCreateInfo.setQueryCount(QUERY_POOL_SIZE);
+                poolCreateInfo.setPipelineStatistics(queryRef.statistics);
+                auto poolResult = deviceRef.device.createQueryPool(poolCreateInfo);
+                if (poolResult.result != vk::Result::eSuccess)
+                {
+                    log_error("Failed to create vk::QueryPool!");
+                    return false;
+                }
+
+                auto& poolRef = deviceRef.queryPools.emplace_back();
+                poolRef.type = queryRef.type;
+                poolRef.statistics = queryRef.statistics;
+                poolRef.pool = poolResult.value;
+                for (auto i = QUERY_POOL_SIZE; i-- > 0;)
+                {
+                    poolRef.freeQueries.push_back(i);
+                }
+                poolIt = std::prev(deviceRef.queryPools.end());
+            }
+
+            queryRef.pool = poolIt->pool;
+            queryRef.index = poolIt->freeQueries.back();
+            poolIt->freeQueries.pop_back();
+
+            deviceRef.device.resetQueryPool(queryRef.pool, queryRef.index, 1);
+            queryRef.isReset = true;
+            return true;
+        }
+
+        void free_query_slot(DeviceData& deviceRef, const QueryData& queryRef)
+        {
+            auto poolIt = std::ranges::find(deviceRef.queryPools, queryRef.pool, &QueryPoolData::pool);
+            if (poolIt != deviceRef.queryPools.end())
+            {
+                poolIt->freeQueries.push_back(queryRef.index);
+            }
+        }
+    }
+
+    auto internal_gpu_profiler_create(const GpuProfilerInfo& profilerInfo) -> ResultCode
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return deviceResult.error();
+        }
+        auto& deviceRef = deviceResult.value().get();
+        auto& profilerRef = deviceRef.gpuProfiler;
+
+        if (profilerRef.isInitialised)
+        {
+            log_warn("GPU profiler is already initialised!");
+            return ResultCode::eSuccess;
+        }
+
+        // Timestamps are masked to the smallest number of valid bits of the queue families in use.
+        const auto familyProperties = deviceRef.physicalDevice.getQueueFamilyProperties();
+        std::uint32_t timestampValidBits{ 64 };
+        for (auto family : deviceRef.queueFamilyIndices)
+        {
+            timestampValidBits = std::min(timestampValidBits, familyProperties.at(family).timestampValidBits);
+        }
+        if (timestampValidBits == 0)
+        {
+            log_error("Timestamp queries are not supported by the device queues!");
+            return ResultCode::eFailed;
+        }
+
+        profilerRef.maxQueries = profilerInfo.maxScopesPerFrame * 2;
+        profilerRef.historyLength = std::max(profilerInfo.historyLength, 1u);
+        profilerRef.timestampPeriod = deviceRef.physicalDevice.getProperties().limits.timestampPeriod;
+        profilerRef.timestampMask = timestampValidBits == 64 ? std::uint64_t(-1) : (std::uint64_t(1) << timestampValidBits) - 1;
+
+        vk::QueryPoolCreateInfo poolCreateInfo{};
+        poolCreateInfo.setQueryType(vk::QueryType::eTimestamp);
+        poolCreateInfo.setQueryCount(profilerRef.maxQueries);
+        for (std::uint32_t i = 0; i < std::max(profilerInfo.frameCount, 1u); ++i)
+        {
+            auto poolResult = deviceRef.device.createQueryPool(poolCreateInfo);
+            if (poolResult.result != vk::Result::eSuccess)
+            {
+                for (const auto& frame : profilerRef.frames)
+                {
+                    deviceRef.device.destroy(frame.queryPool);
+                }
+                profilerRef.frames.clear();
+
+                log_error("Failed to create vk::QueryPool!");
+                return ResultCode::eFailedToCreate;
+            }
+
+            auto& frameRef = profilerRef.frames.emplace_back();
+            frameRef.queryPool = poolResult.value;
+            deviceRef.device.resetQueryPool(frameRef.queryPool, 0, profilerRef.maxQueries);
+        }
+
+        profilerRef.isInitialised = true;
+        return ResultCode::eSuccess;
+    }
+
+    void internal_gpu_profiler_destroy()
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+        auto& profilerRef = deviceRef.gpuProfiler;
+
+        std::lock_guard lock(profilerRef.mutex);
+        for (const auto& frame : profilerRef.frames)
+        {
+            deviceRef.device.destroy(frame.queryPool);
+        }
+        profilerRef.frames.clear();
+        profilerRef.lastReport.reset();
+        profilerRef.scopeHistory.clear();
+        profilerRef.frameNumber = 0;
+        profilerRef.isInitialised = false;
+    }
+
+    void internal_gpu_profiler_frame_begin()
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+        auto& profilerRef = deviceRef.gpuProfiler;
+
+        std::lock_guard lock(profilerRef.mutex);
+        if (!profilerRef.isInitialised)
+        {
+            return;
+        }
+
+        // Resolve whatever has finished, oldest first, so the rolling stats stay in frame order.
+        std::vector<GpuProfilerFrame*> pendingFrames{};
+        for (auto& frame : profilerRef.frames)
+        {
+            if (frame.isPending)
+            {
+                pendingFrames.push_back(&frame);
+            }
+        }
+        std::ranges::sort(pendingFrames, {}, &GpuProfilerFrame::frameNumber);
+        for (auto* frame : pendingFrames)
+        {
+            if (!resolve_frame(profilerRef, deviceRef.device, *frame))
+            {
+                break;
+            }
+        }
+
+        if (profilerRef.frameNumber > 0)
+        {
+            profilerRef.currentFrame = (profilerRef.currentFrame + 1) % std::uint32_t(profilerRef.frames.size());
+        }
+        auto& frameRef = profilerRef.frames.at(profilerRef.currentFrame);
+        if (frameRef.isPending)
+        {
+            log_warn("GPU profiler results of frame {} were not ready in time and have been dropped.", frameRef.frameNumber);
+        }
+
+        deviceRef.device.resetQueryPool(frameRef.queryPool, 0, profilerRef.maxQueries);
+        frameRef.queryCount = 0;
+        frameRef.scopes.clear();
+        frameRef.frameNumber = ++profilerRef.frameNumber;
+        frameRef.cpuBeginNs = trace_now_ns();
+        frameRef.isPending = true;
+    }
+
+    auto internal_gpu_scope_begin(vk::CommandBuffer cmdBuffer, std::string_view name, std::int32_t parent) -> std::int32_t
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return -1;
+        }
+        auto& deviceRef = deviceResult.value().get();
+        auto& profilerRef = deviceRef.gpuProfiler;
+
+        std::lock_guard lock(profilerRef.mutex);
+        if (!profilerRef.isInitialised || profilerRef.frameNumber == 0)
+        {
+            return -1;
+        }
+
+        auto& frameRef = profilerRef.frames.at(profilerRef.currentFrame);
+        if (frameRef.queryCount + 2 > profilerRef.maxQueries)
+        {
+            log_warn("GPU profiler is out of queries for this frame. Scope '{}' will not be timed.", name);
+            return -1;
+        }
+
+        // The end query is reserved up front, so ending a scope can never fail.
+        auto& scope = frameRef.scopes.emplace_back();
+        scope.name = name;
+        scope.parent = parent;
+        scope.depth = parent < 0 ? 0 : frameRef.scopes.at(parent).depth + 1;
+        scope.beginQuery = frameRef.queryCount++;
+        scope.endQuery = frameRef.queryCount++;
+
+        cmdBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, frameRef.queryPool, scope.beginQuery);
+        return std::int32_t(frameRef.scopes.size() - 1);
+    }
+
+    void internal_gpu_scope_end(vk::CommandBuffer cmdBuffer, std::int32_t scope)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+        auto& profilerRef = deviceRef.gpuProfiler;
+
+        std::lock_guard lock(profilerRef.mutex);
+        if (!profilerRef.isInitialised || scope < 0)
+        {
+            return;
+        }
+
+        auto& frameRef = profilerRef.frames.at(profilerRef.currentFrame);
+        if (scope >= std::int32_t(frameRef.scopes.size()))
+        {
+            log_error("GPU scope was begun in a different profiler frame!");
+            return;
+        }
+
+        auto& scopeRef = frameRef.scopes.at(scope);
+        cmdBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eBottomOfPipe, frameRef.queryPool, scopeRef.endQuery);
+        scopeRef.isClosed = true;
+    }
+
+    auto internal_gpu_frame_report_get() -> std::optional<GpuFrameReport>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::nullopt;
+        }
+        auto& profilerRef = deviceResult.value().get().gpuProfiler;
+
+        std::lock_guard lock(profilerRef.mutex);
+        return profilerRef.lastReport;
+    }
+
+    auto internal_gpu_scope_stats_get() -> std::vector<GpuScopeStats>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return {};
+        }
+        auto& profilerRef = deviceResult.value().get().gpuProfiler;
+
+        std::lock_guard lock(profilerRef.mutex);
+        std::vector<GpuScopeStats> stats{};
+        for (const auto& [path, history] : profilerRef.scopeHistory)
+        {
+            if (history.empty())
+            {
+                continue;
+            }
+
+            auto& scopeStats = stats.emplace_back();
+            scopeStats.path = path;
+            scopeStats.minMs = *std::ranges::min_element(history);
+            scopeStats.maxMs = *std::ranges::max_element(history);
+            for (auto durationMs : history)
+            {
+                scopeStats.avgMs += durationMs;
+            }
+            scopeStats.avgMs /= double(history.size());
+            scopeStats.sampleCount = std::uint32_t(history.size());
+        }
+        return stats;
+    }
+
+    auto internal_query_create(QueryType type) -> std::expected<Query, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto supportedFeatures = deviceRef.physicalDevice.getFeatures();
+        const auto queryType = type == QueryType::eOcclusion ? vk::QueryType::eOcclusion : vk::QueryType::ePipelineStatistics;
+        if (queryType == vk::QueryType::ePipelineStatistics && !supportedFeatures.pipelineStatisticsQuery)
+        {
+            log_error("Pipeline statistics queries are not supported by the device!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        auto queryData = std::make_unique<QueryData>();
+        queryData->type = queryType;
+        if (queryType == vk::QueryType::ePipelineStatistics)
+        {
+            queryData->statistics = PIPELINE_STATISTIC_FLAGS;
+        }
+        if (queryType == vk::QueryType::eOcclusion && supportedFeatures.occlusionQueryPrecise)
+        {
+            queryData->controlFlags = vk::QueryControlFlagBits::ePrecise;
+        }
+        if (!allocate_query_slot(deviceRef, *queryData))
+        {
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        Query query = queryData.get();
+        deviceRef.queryMap[query] = std::move(queryData);
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
+        return query;
+    }
+
+    void internal_query_destroy(Query query)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.queryMap.find(query);
+        if (it == deviceRef.queryMap.end())
+        {
+            log_error("Failed to get query!");
+            return;
+        }
+
+        free_query_slot(deviceRef, *it->second);
+        deviceRef.queryMap.erase(it);
+        internal_stats_add(internal_stats_get().resourcesDestroyed);
+    }
+
+    auto internal_query_get(Query query) -> std::expected<std::reference_wrapper<QueryData>, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.queryMap.find(query);
+        if (it == deviceRef.queryMap.end())
+        {
+            return std::unexpected(ResultCode::eInvalidHandle);
+        }
+
+        return *it->second;
+    }
+
+    void internal_query_begin(vk::CommandBuffer cmdBuffer, Query query)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        auto queryResult = internal_query_get(query);
+        if (!queryResult)
+        {
+            log_error("Failed to get query!");
+            return;
+        }
+        auto& queryRef = queryResult.value().get();
+
+        if (queryRef.isActive)
+        {
+            log_error("Query is already active!");
+            return;
+        }
+        if (!queryRef.isReset)
+        {
+            log_error("Query must be read back before it can be recorded again!");
+            return;
+        }
+
+        const auto cmdIt = deviceRef.cmdBufferMap.find(cmdBuffer);
+        const bool hasGraphics = cmdIt == deviceRef.cmdBufferMap.end() || (cmdIt->second.queueFlags & vk::QueueFlagBits::eGraphics);
+        if (queryRef.type == vk::QueryType::eOcclusion && !hasGraphics)
+        {
+            log_error("Occlusion queries can only be recorded on a graphics queue!");
+            return;
+        }
+        const auto wantedStatistics = hasGraphics ? PIPELINE_STATISTIC_FLAGS : COMPUTE_PIPELINE_STATISTIC_FLAGS;
+        if (queryRef.type == vk::QueryType::ePipelineStatistics && queryRef.statistics != wantedStatistics)
+        {
+            // Move the query to a pool whose statistics the queue can count. The old slot is kept if that fails.
+            auto movedQuery = queryRef;
+            movedQuery.statistics = wantedStatistics;
+            if (!allocate_query_slot(deviceRef, movedQuery))
+            {
+                log_error("Failed to move query to a pool the queue supports!");
+                return;
+            }
+            free_query_slot(deviceRef, queryRef);
+            queryRef = movedQuery;
+        }
+
+        cmdBuffer.beginQuery(queryRef.pool, queryRef.index, queryRef.controlFlags);
+        queryRef.isReset = false;
+        queryRef.isActive = true;
+    }
+
+    void internal_query_end(vk::CommandBuffer cmdBuffer, Query query)
+    {
+        auto queryResult = internal_query_get(query);
+        if (!queryResult)
+        {
+            log_error("Failed to get query!");
+            return;
+        }
+        auto& queryRef = queryResult.value().get();
+
+        if (!queryRef.isActive)
+        {
+            log_error("Query was not begun (or failed to begin), so it cannot be ended!");
+            return;
+        }
+        cmdBuffer.endQuery(queryRef.pool, queryRef.index);
+        queryRef.isActive = false;
+    }
+
+    auto internal_query_results_get(Query query) -> std::optional<std::vector<std::uint64_t>>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::nullopt;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        auto queryResult = internal_query_get(query);
+        if (!queryResult)
+        {
+            log_error("Failed to get query!");
+            return std::nullopt;
+        }
+        auto& queryRef = queryResult.value().get();
+
+        if (queryRef.isReset)
+        {
+            // Never recorded since the last readback.
+            return std::nullopt;
+        }
+
+        const std::size_t valueCount =
+            queryRef.type == vk::QueryType::ePipelineStatistics ? std::popcount(std::uint32_t(queryRef.statistics)) : 1;
+
+        // The values, followed by availability
+        std::vector<std::uint64_t> queryData(valueCount + 1);
+        auto result = deviceRef.device.getQueryPoolResults(queryRef.pool,
+                                                           queryRef.index,
+                                                           1,
+                                                           queryData.size() * sizeof(std::uint64_t),
+                                                           queryData.data(),
+                                                           queryData.size() * sizeof(std::uint64_t),
+                                                           vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+        if (result != vk::Result::eSuccess && result != vk::Result::eNotReady)
+        {
+            log_error("Failed to get query results!");
+            return std::nullopt;
+        }
+        if (queryData.back() == 0)
+        {
+            return std::nullopt;
+        }
+
+        deviceRef.device.resetQueryPool(queryRef.pool, queryRef.index, 1);
+        queryRef.isReset = true;
+
+        queryData.pop_back();
+        if (queryRef.type != vk::QueryType::ePipelineStatistics || queryRef.statistics == PIPELINE_STATISTIC_FLAGS)
+        {
+            return queryData;
+        }
+
+        // Values are written in order of the statistic bits, so spread them out to the full set of statistics.
+        std::vector<std::uint64_t> statistics{};
+        auto valueIt = queryData.begin();
+        for (std::uint32_t bit = 1; bit <= std::uint32_t(PIPELINE_STATISTIC_FLAGS); bit <<= 1)
+        {
+            if (!(std::uint32_t(PIPELINE_STATISTIC_FLAGS) & bit))
+            {
+                continue;
+            }
+            statistics.push_back((std::uint32_t(queryRef.statistics) & bit) ? *valueIt++ : 0);
+        }
+        return statistics;
+    }
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "vgw/vgw.hpp"
+#include "internal_core.hpp"
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace vgw::internal
+{
+    constexpr std::uint32_t INVALID_QUERY = std::uint32_t(-1);
+
+    struct GpuScopeRecord
+    {
+        std::string name{};
+        std::int32_t parent{ -1 };
+        std::uint32_t depth{};
+        std::uint32_t beginQuery{ INVALID_QUERY };
+        std::uint32_t endQuery{ INVALID_QUERY };
+        bool isClosed{ false };
+    };
+    struct GpuProfilerFrame
+    {
+        vk::QueryPool queryPool{};
+        std::uint32_t queryCount{};
+        std::vector<GpuScopeRecord> scopes{};
+        std::uint64_t frameNumber{};
+        // CPU time the frame began, used to place GPU scopes in the CPU trace.
+        std::uint64_t cpuBeginNs{};
+        bool isPending{ false };
+    };
+    struct GpuProfilerData
+    {
+        bool isInitialised{ false };
+        std::uint32_t maxQueries{};
+        std::uint32_t historyLength{};
+        double timestampPeriod{};
+        std::uint64_t timestampMask{};
+
+        std::vector<GpuProfilerFrame> frames{};
+        std::uint32_t currentFrame{};
+        std::uint64_t frameNumber{};
+
+        std::optional<GpuFrameReport> lastReport{};
+        // Per-frame total duration (ms) of each scope path, oldest first.
+        std::map<std::string, std::deque<double>> scopeHistory{};
+
+        // Scopes may be recorded from several threads.
+        std::mutex mutex{};
+    };
+
+    auto internal_gpu_profiler_create(const GpuProfilerInfo& profilerInfo) -> ResultCode;
+    void internal_gpu_profiler_destroy();
+
+    void internal_gpu_profiler_frame_begin();
+
+    auto internal_gpu_scope_begin(vk::CommandBuffer cmdBuffer, std::string_view name, std::int32_t parent) -> std::int32_t;
+    void internal_gpu_scope_end(vk::CommandBuffer cmdBuffer, std::int32_t scope);
+
+    auto internal_gpu_frame_report_get() -> std::optional<GpuFrameReport>;
+    auto internal_gpu_scope_stats_get() -> std::vector<GpuScopeStats>;
+
+    constexpr std::uint32_t QUERY_POOL_SIZE = 64;
+    constexpr vk::QueryPipelineStatisticFlags PIPELINE_STATISTIC_FLAGS =
+        vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices | vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+        vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations | vk::QueryPipelineStatisticFlagBits::eClippingInvocations |
+        vk::QueryPipelineStatisticFlagBits::eClippingPrimitives | vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+        vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+    // Graphics statistics cannot be counted on a queue without graphics support.
+    constexpr vk::QueryPipelineStatisticFlags COMPUTE_PIPELINE_STATISTIC_FLAGS =
+        vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+
+    struct QueryPoolData
+    {
+        vk::QueryType type{};
+        vk::QueryPipelineStatisticFlags statistics{};
+        vk::QueryPool pool{};
+        std::vector<std::uint32_t> freeQueries{};
+    };
+    struct QueryData
+    {
+        vk::QueryType type{};
+        // Statistics counted by the pool the query currently lives in. Moved to a matching pool when begun on another kind of queue.
+        vk::QueryPipelineStatisticFlags statistics{};
+        vk::QueryPool pool{};
+        std::uint32_t index{};
+        vk::QueryControlFlags controlFlags{};
+        // Queries are reset from the host, once at creation and again after each successful readback.
+        bool isReset{ true };
+        // Between a successful begin and its end. Ends without a successful begin are not recorded.
+        bool isActive{ false };
+    };
+    auto internal_query_create(QueryType type) -> std::expected<Query, ResultCode>;
+    void internal_query_destroy(Query query);
+
+    auto internal_query_get(Query query) -> std::expected<std::reference_wrapper<QueryData>, ResultCode>;
+
+    void internal_query_begin(vk::CommandBuffer cmdBuffer, Query query);
+    void internal_query_end(vk::CommandBuffer cmdBuffer, Query query);
+
+    /**
+     * Returns the result values (1 for occlusion, one per bit of `PIPELINE_STATISTIC_FLAGS` otherwise, 0 for statistics the query's
+     * pool does not count), or nothing if they are not available yet.
+     */
+    auto internal_query_results_get(Query query) -> std::optional<std::vector<std::uint64_t>>;
+
+}
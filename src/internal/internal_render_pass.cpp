@@ -1,6 +1,7 @@
 #include "internal_render_pass.hpp"
 
 #include "internal_device.hpp"
+#include "internal_stats.hpp"
 
 namespace vgw::internal
 {
@@ -44,6 +45,7 @@ namespace vgw::internal
         RenderPass renderPass = passData.get();
         deviceRef.renderPassMap[renderPass] = std::move(passData);
 
+        internal_stats_add(internal_stats_get().resourcesCreated);
         return renderPass;
     }
 
@@ -58,6 +60,7 @@ namespace vgw::internal
         auto& deviceRef = deviceResult.value().get();
 
         deviceRef.renderPassMap.erase(renderPass);
+        internal_stats_add(internal_stats_get().resourcesDestroyed);
     }
 
     auto internal_render_pass_get(RenderPass renderPass) -> std::expected<std::reference_wrapper<RenderPassData>, ResultCode>
@@ -1,6 +1,7 @@
 #include "internal_sets.hpp"
 
 #include "internal_device.hpp"
+#include "internal_stats.hpp"
 
 namespace vgw::internal
 {
@@ -38,6 +39,10 @@ namespace vgw::internal
         auto& deviceRef = deviceResult.value().get();
 
         deviceRef.device.free(deviceRef.descriptorPool, sets);
+        for (auto set : sets)
+        {
+            deviceRef.setStorageBufferMap.erase(set);
+        }
     }
 
     void internal_sets_bind_buffer(const SetBufferBindInfo& bindInfo)
@@ -69,6 +74,15 @@ namespace vgw::internal
         writeRef.setDescriptorCount(1);
         writeRef.setDescriptorType(bindInfo.type);
         writeRef.setPBufferInfo(&bufferInfoRef);
+        internal_stats_add(internal_stats_get().descriptorWrites);
+
+        if (bindInfo.type == vk::DescriptorType::eStorageBuffer || bindInfo.type == vk::DescriptorType::eStorageBufferDynamic)
+        {
+            auto& storageBindings = deviceRef.setStorageBufferMap[bindInfo.set];
+            std::erase_if(storageBindings,
+                          [&](const SetStorageBinding& storageBinding) { return storageBinding.binding == bindInfo.binding; });
+            storageBindings.push_back({ bindInfo.binding, bindInfo.buffer, bindInfo.readOnly });
+        }
     }
 
     void internal_sets_bind_image(const SetImageBindInfo& bindInfo)
@@ -100,6 +114,7 @@ namespace vgw::internal
         writeRef.setDescriptorCount(1);
         writeRef.setDescriptorType(bindInfo.type);
         writeRef.setPImageInfo(&imageInfoRef);
+        internal_stats_add(internal_stats_get().descriptorWrites);
     }
 
     void internal_sets_flush_writes()
@@ -118,10 +133,30 @@ namespace vgw::internal
         }
 
         deviceRef.device.updateDescriptorSets(deviceRef.setWrites, {});
+        internal_stats_add(internal_stats_get().descriptorUpdateCalls);
         deviceRef.setWrites.clear();
         deviceRef.setWriteObjects.clear();
     }
 
+    auto internal_sets_storage_buffers_get(vk::DescriptorSet set)
+        -> std::expected<std::reference_wrapper<std::vector<SetStorageBinding>>, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.setStorageBufferMap.find(set);
+        if (it == deviceRef.setStorageBufferMap.end())
+        {
+            return std::unexpected(ResultCode::eInvalidHandle);
+        }
+
+        return it->second;
+    }
+
     void internal_sets_bind(vk::CommandBuffer cmdBuffer,
                             vk::Pipeline pipeline,
                             std::uint32_t firstSet,
@@ -11,6 +11,13 @@ namespace vgw::internal
 
     using SetWriteObject = std::variant<vk::DescriptorBufferInfo, vk::DescriptorImageInfo>;
 
+    struct SetStorageBinding
+    {
+        std::uint32_t binding{};
+        vk::Buffer buffer{};
+        bool readOnly{ false };
+    };
+
     auto internal_sets_allocate(const SetAllocInfo& allocInfo) -> std::expected<std::vector<vk::DescriptorSet>, ResultCode>;
     void internal_sets_free(const std::vector<vk::DescriptorSet>& sets);
 
@@ -19,6 +26,9 @@ namespace vgw::internal
 
     void internal_sets_flush_writes();
 
+    auto internal_sets_storage_buffers_get(vk::DescriptorSet set)
+        -> std::expected<std::reference_wrapper<std::vector<SetStorageBinding>>, ResultCode>;
+
     void internal_sets_bind(vk::CommandBuffer cmdBuffer,
                             vk::Pipeline pipeline,
                             std::uint32_t firstSet,
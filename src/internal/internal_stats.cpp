@@ -0,0 +1,70 @@
+#include "internal_stats.hpp"
+
+namespace vgw::internal
+{
+    static StatsCounters s_stats{};  // NOLINT(*-avoid-non-const-global-variables)
+
+    auto internal_stats_get() -> StatsCounters&
+    {
+        return s_stats;
+    }
+
+    void internal_stats_barriers_add(std::size_t imageBarrierCount, std::size_t bufferBarrierCount, std::size_t memoryBarrierCount)
+    {
+        internal_stats_add(s_stats.barrierFlushes);
+        internal_stats_add(s_stats.imageBarriers, imageBarrierCount);
+        internal_stats_add(s_stats.bufferBarriers, bufferBarrierCount);
+        internal_stats_add(s_stats.memoryBarriers, memoryBarrierCount);
+
+        auto maxImageBarriers = s_stats.maxImageBarriersPerFlush.load(std::memory_order_relaxed);
+        while (maxImageBarriers < imageBarrierCount &&
+               !s_stats.maxImageBarriersPerFlush.compare_exchange_weak(maxImageBarriers, imageBarrierCount, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    auto internal_frame_stats_get() -> FrameStats
+    {
+        return FrameStats{
+            .draws = s_stats.draws.load(std::memory_order_relaxed),
+            .dispatches = s_stats.dispatches.load(std::memory_order_relaxed),
+            .pipelineBinds = s_stats.pipelineBinds.load(std::memory_order_relaxed),
+            .setBinds = s_stats.setBinds.load(std::memory_order_relaxed),
+            .pushConstantUpdates = s_stats.pushConstantUpdates.load(std::memory_order_relaxed),
+            .barrierFlushes = s_stats.barrierFlushes.load(std::memory_order_relaxed),
+            .imageBarriers = s_stats.imageBarriers.load(std::memory_order_relaxed),
+            .bufferBarriers = s_stats.bufferBarriers.load(std::memory_order_relaxed),
+            .memoryBarriers = s_stats.memoryBarriers.load(std::memory_order_relaxed),
+            .maxImageBarriersPerFlush = s_stats.maxImageBarriersPerFlush.load(std::memory_order_relaxed),
+            .descriptorWrites = s_stats.descriptorWrites.load(std::memory_order_relaxed),
+            .descriptorUpdateCalls = s_stats.descriptorUpdateCalls.load(std::memory_order_relaxed),
+            .bufferMaps = s_stats.bufferMaps.load(std::memory_order_relaxed),
+            .bufferUnmaps = s_stats.bufferUnmaps.load(std::memory_order_relaxed),
+            .submits = s_stats.submits.load(std::memory_order_relaxed),
+            .resourcesCreated = s_stats.resourcesCreated.load(std::memory_order_relaxed),
+            .resourcesDestroyed = s_stats.resourcesDestroyed.load(std::memory_order_relaxed),
+        };
+    }
+
+    void internal_frame_stats_reset()
+    {
+        s_stats.draws.store(0, std::memory_order_relaxed);
+        s_stats.dispatches.store(0, std::memory_order_relaxed);
+        s_stats.pipelineBinds.store(0, std::memory_order_relaxed);
+        s_stats.setBinds.store(0, std::memory_order_relaxed);
+        s_stats.pushConstantUpdates.store(0, std::memory_order_relaxed);
+        s_stats.barrierFlushes.store(0, std::memory_order_relaxed);
+        s_stats.imageBarriers.store(0, std::memory_order_relaxed);
+        s_stats.bufferBarriers.store(0, std::memory_order_relaxed);
+        s_stats.memoryBarriers.store(0, std::memory_order_relaxed);
+        s_stats.maxImageBarriersPerFlush.store(0, std::memory_order_relaxed);
+        s_stats.descriptorWrites.store(0, std::memory_order_relaxed);
+        s_stats.descriptorUpdateCalls.store(0, std::memory_order_relaxed);
+        s_stats.bufferMaps.store(0, std::memory_order_relaxed);
+        s_stats.bufferUnmaps.store(0, std::memory_order_relaxed);
+        s_stats.submits.store(0, std::memory_order_relaxed);
+        s_stats.resourcesCreated.store(0, std::memory_order_relaxed);
+        s_stats.resourcesDestroyed.store(0, std::memory_order_relaxed);
+    }
+
+}
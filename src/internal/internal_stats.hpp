@@ -0,0 +1,42 @@
+#pragma once
+
+#include "vgw/vgw.hpp"
+
+#include <atomic>
+
+namespace vgw::internal
+{
+    // Relaxed atomics, so command buffers can be recorded on several threads.
+    struct StatsCounters
+    {
+        std::atomic<std::uint64_t> draws{};
+        std::atomic<std::uint64_t> dispatches{};
+        std::atomic<std::uint64_t> pipelineBinds{};
+        std::atomic<std::uint64_t> setBinds{};
+        std::atomic<std::uint64_t> pushConstantUpdates{};
+        std::atomic<std::uint64_t> barrierFlushes{};
+        std::atomic<std::uint64_t> imageBarriers{};
+        std::atomic<std::uint64_t> bufferBarriers{};
+        std::atomic<std::uint64_t> memoryBarriers{};
+        std::atomic<std::uint64_t> maxImageBarriersPerFlush{};
+        std::atomic<std::uint64_t> descriptorWrites{};
+        std::atomic<std::uint64_t> descriptorUpdateCalls{};
+        std::atomic<std::uint64_t> bufferMaps{};
+        std::atomic<std::uint64_t> bufferUnmaps{};
+        std::atomic<std::uint64_t> submits{};
+        std::atomic<std::uint64_t> resourcesCreated{};
+        std::atomic<std::uint64_t> resourcesDestroyed{};
+    };
+    auto internal_stats_get() -> StatsCounters&;
+
+    inline void internal_stats_add(std::atomic<std::uint64_t>& counter, std::uint64_t value = 1)
+    {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void internal_stats_barriers_add(std::size_t imageBarrierCount, std::size_t bufferBarrierCount, std::size_t memoryBarrierCount);
+
+    auto internal_frame_stats_get() -> FrameStats;
+    void internal_frame_stats_reset();
+
+}
@@ -118,7 +118,7 @@ namespace vgw::internal
 
         for (auto& image : images)
         {
-            deviceRef.imageMap[image] = { .image = image, .format = surfaceFormat.format };
+            deviceRef.imageMap[image] = { .image = image, .format = surfaceFormat.format, .mipLevels = 1, .arrayLayers = 1 };
         }
 
         return swapchain;
@@ -1,6 +1,7 @@
 #include "internal_synchronisation.hpp"
 
 #include "internal_device.hpp"
+#include "internal_stats.hpp"
 
 namespace vgw::internal
 {
@@ -24,6 +25,8 @@ namespace vgw::internal
         auto fence = fenceResult.value;
 
         deviceRef.fences.insert(fence);
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
         return fence;
     }
 
@@ -39,6 +42,7 @@ namespace vgw::internal
 
         deviceRef.device.destroy(fence);
         deviceRef.fences.erase(fence);
+        internal_stats_add(internal_stats_get().resourcesDestroyed);
     }
 
     void internal_fence_wait(vk::Fence fence)
@@ -87,6 +91,8 @@ namespace vgw::internal
         auto semaphore = semaphoreResult.value;
 
         deviceRef.semaphores.insert(semaphore);
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
         return semaphore;
     }
 
@@ -102,6 +108,148 @@ namespace vgw::internal
 
         deviceRef.device.destroy(semaphore);
         deviceRef.semaphores.erase(semaphore);
+        internal_stats_add(internal_stats_get().resourcesDestroyed);
+    }
+
+    auto internal_event_create() -> std::expected<vk::Event, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        if (!deviceRef.freeEvents.empty())
+        {
+            const auto event = deviceRef.freeEvents.back();
+            deviceRef.freeEvents.pop_back();
+            deviceRef.eventMap[event] = {};
+            internal_stats_add(internal_stats_get().resourcesCreated);
+            return event;
+        }
+
+        vk::EventCreateInfo eventCreateInfo{ vk::EventCreateFlagBits::eDeviceOnly };
+        auto eventResult = deviceRef.device.createEvent(eventCreateInfo);
+        if (eventResult.result != vk::Result::eSuccess)
+        {
+            log_error("Failed to create vk::Event!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        auto event = eventResult.value;
+
+        deviceRef.eventMap[event] = {};
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
+        return event;
+    }
+
+    void internal_event_destroy(vk::Event event)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        if (deviceRef.eventMap.erase(event) == 0)
+        {
+            log_warn("Tried to destroy unknown event.");
+            return;
+        }
+        // Submitted work may still signal or wait on it, so it is reused only once those command buffers have completed.
+        if (deviceRef.eventUseCounts.contains(event))
+        {
+            deviceRef.retiredEvents.insert(event);
+        }
+        else
+        {
+            deviceRef.freeEvents.push_back(event);
+        }
+        internal_stats_add(internal_stats_get().resourcesDestroyed);
+    }
+
+    auto internal_event_get(vk::Event event) -> std::expected<std::reference_wrapper<EventData>, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        const auto it = deviceRef.eventMap.find(event);
+        if (it == deviceRef.eventMap.end())
+        {
+            return std::unexpected(ResultCode::eInvalidHandle);
+        }
+
+        return it->second;
+    }
+
+    auto internal_timeline_semaphore_create(std::uint64_t initialValue) -> std::expected<vk::Semaphore, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        vk::SemaphoreTypeCreateInfo semaphoreTypeCreateInfo{ vk::SemaphoreType::eTimeline, initialValue };
+        vk::SemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.setPNext(&semaphoreTypeCreateInfo);
+        auto semaphoreResult = deviceRef.device.createSemaphore(semaphoreCreateInfo);
+        if (semaphoreResult.result != vk::Result::eSuccess)
+        {
+            log_error("Failed to create vk::Semaphore (Timeline)!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        auto semaphore = semaphoreResult.value;
+
+        deviceRef.semaphores.insert(semaphore);
+
+        internal_stats_add(internal_stats_get().resourcesCreated);
+        return semaphore;
+    }
+
+    auto internal_semaphore_value_get(vk::Semaphore semaphore) -> std::expected<std::uint64_t, ResultCode>
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return std::unexpected(deviceResult.error());
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        auto valueResult = deviceRef.device.getSemaphoreCounterValue(semaphore);
+        if (valueResult.result != vk::Result::eSuccess)
+        {
+            log_error("Failed to get vk::Semaphore counter value!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+        return valueResult.value;
+    }
+
+    void internal_semaphore_wait(vk::Semaphore semaphore, std::uint64_t value)
+    {
+        auto deviceResult = internal_device_get();
+        if (!deviceResult)
+        {
+            log_error("Failed to get device!");
+            return;
+        }
+        auto& deviceRef = deviceResult.value().get();
+
+        vk::SemaphoreWaitInfo waitInfo{};
+        waitInfo.setSemaphores(semaphore);
+        waitInfo.setValues(value);
+        deviceRef.device.waitSemaphores(waitInfo, std::uint64_t(-1));
     }
 
 }
\ No newline at end of file
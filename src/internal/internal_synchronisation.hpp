@@ -5,6 +5,21 @@
 
 namespace vgw::internal
 {
+    constexpr vk::AccessFlags2 WRITE_ACCESS_MASK =
+        vk::AccessFlagBits2::eShaderWrite | vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eColorAttachmentWrite |
+        vk::AccessFlagBits2::eDepthStencilAttachmentWrite | vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eHostWrite |
+        vk::AccessFlagBits2::eMemoryWrite;
+
+    constexpr auto get_write_access(vk::AccessFlags2 access) -> vk::AccessFlags2
+    {
+        return access & WRITE_ACCESS_MASK;
+    }
+
+    constexpr bool is_write_access(vk::AccessFlags2 access)
+    {
+        return bool(get_write_access(access));
+    }
+
     auto internal_fence_create(const FenceInfo& fenceInfo) -> std::expected<vk::Fence, ResultCode>;
     void internal_fence_destroy(vk::Fence fence);
 
@@ -14,4 +29,19 @@ namespace vgw::internal
     auto internal_semaphore_create() -> std::expected<vk::Semaphore, ResultCode>;
     void internal_semaphore_destroy(vk::Semaphore semaphore);
 
+    struct EventData
+    {
+        std::vector<vk::MemoryBarrier2> memoryBarriers{};
+        std::vector<vk::BufferMemoryBarrier2> bufferBarriers{};
+        std::vector<vk::ImageMemoryBarrier2> imageBarriers{};
+    };
+    auto internal_event_create() -> std::expected<vk::Event, ResultCode>;
+    void internal_event_destroy(vk::Event event);
+
+    auto internal_event_get(vk::Event event) -> std::expected<std::reference_wrapper<EventData>, ResultCode>;
+
+    auto internal_timeline_semaphore_create(std::uint64_t initialValue) -> std::expected<vk::Semaphore, ResultCode>;
+    auto internal_semaphore_value_get(vk::Semaphore semaphore) -> std::expected<std::uint64_t, ResultCode>;
+    void internal_semaphore_wait(vk::Semaphore semaphore, std::uint64_t value);
+
 }
\ No newline at end of file
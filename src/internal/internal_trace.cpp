@@ -0,0 +1,242 @@
+#include "internal_trace.hpp"
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <format>
+
+namespace vgw::internal
+{
+    namespace
+    {
+        /**
+         * Holds event `n` once `sequence` is `2n + 2`, and is odd while being written. The exporting thread reads a slot between two
+         * sequence checks and skips it if it was overwritten in the meantime.
+         */
+        struct TraceSlot
+        {
+            std::atomic<std::uint64_t> sequence{ 0 };
+            std::atomic<const char*> name{};
+            std::atomic<std::uint64_t> startNs{};
+            std::atomic<std::uint64_t> endNs{};
+        };
+
+        // Written only by its own thread. `writeCount` is published after each event.
+        struct ThreadTraceBuffer
+        {
+            std::uint32_t threadIndex{};
+            std::vector<TraceSlot> slots = std::vector<TraceSlot>(TRACE_EVENTS_PER_THREAD);
+            std::atomic<std::uint64_t> writeCount{ 0 };
+            std::atomic<std::uint64_t> clearedCount{ 0 };
+        };
+
+        struct GpuTraceEvent
+        {
+            std::string name{};
+            std::uint32_t depth{};
+            std::uint64_t startNs{};
+            std::uint64_t endNs{};
+        };
+
+        struct DetailTraceEvent
+        {
+            std::string category{};
+            std::string name{};
+            std::uint32_t threadIndex{};
+            std::uint64_t startNs{};
+            std::uint64_t endNs{};
+            std::string argsJson{};
+        };
+
+        struct TraceRegistry
+        {
+            std::mutex mutex{};
+            // Buffers are kept after their thread exits, so its events can still be exported.
+            std::vector<std::shared_ptr<ThreadTraceBuffer>> threadBuffers{};
+            std::deque<GpuTraceEvent> gpuEvents{};
+            std::deque<DetailTraceEvent> detailEvents{};
+        };
+
+        auto get_registry() -> TraceRegistry&
+        {
+            static TraceRegistry registry{};
+            return registry;
+        }
+
+        auto get_thread_buffer() -> ThreadTraceBuffer&
+        {
+            thread_local auto buffer = []
+            {
+                auto& registry = get_registry();
+                std::lock_guard lock(registry.mutex);
+                auto threadBuffer = std::make_shared<ThreadTraceBuffer>();
+                threadBuffer->threadIndex = std::uint32_t(registry.threadBuffers.size());
+                registry.threadBuffers.push_back(threadBuffer);
+                return threadBuffer;
+            }();
+            return *buffer;
+        }
+
+        // Chrome trace timestamps are in microseconds.
+        auto to_us(std::uint64_t ns) -> double
+        {
+            return double(ns) / 1000.0;
+        }
+    }
+
+    void internal_trace_event_add(const TraceEvent& event) noexcept
+    {
+        auto& buffer = get_thread_buffer();
+        const auto writeCount = buffer.writeCount.load(std::memory_order_relaxed);
+        auto& slot = buffer.slots[writeCount % TRACE_EVENTS_PER_THREAD];
+        slot.sequence.store(writeCount * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(event.name, std::memory_order_relaxed);
+        slot.startNs.store(event.startNs, std::memory_order_relaxed);
+        slot.endNs.store(event.endNs, std::memory_order_relaxed);
+        slot.sequence.store(writeCount * 2 + 2, std::memory_order_release);
+        buffer.writeCount.store(writeCount + 1, std::memory_order_release);
+    }
+
+    void internal_trace_gpu_event_add(std::string_view name, std::uint32_t depth, std::uint64_t startNs, std::uint64_t endNs)
+    {
+        auto& registry = get_registry();
+        std::lock_guard lock(registry.mutex);
+        registry.gpuEvents.push_back({ std::string(name), depth, startNs, endNs });
+        while (registry.gpuEvents.size() > MAX_GPU_TRACE_EVENTS)
+        {
+            registry.gpuEvents.pop_front();
+        }
+    }
+
+    void internal_trace_detail_event_add(std::string_view category,
+                                         std::string_view name,
+                                         std::uint64_t startNs,
+                                         std::uint64_t endNs,
+                                         std::string argsJson)
+    {
+        const auto threadIndex = get_thread_buffer().threadIndex;
+
+        auto& registry = get_registry();
+        std::lock_guard lock(registry.mutex);
+        registry.detailEvents.push_back({ std::string(category), std::string(name), threadIndex, startNs, endNs, std::move(argsJson) });
+        while (registry.detailEvents.size() > MAX_DETAIL_TRACE_EVENTS)
+        {
+            registry.detailEvents.pop_front();
+        }
+    }
+
+    auto internal_trace_escape_json(std::string_view str) -> std::string
+    {
+        std::string escaped{};
+        escaped.reserve(str.size());
+        for (const char c : str)
+        {
+            switch (c)
+            {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\t': escaped += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        escaped += std::format("\\u{:04x}", int(c));
+                    }
+                    else
+                    {
+                        escaped += c;
+                    }
+                    break;
+            }
+        }
+        return escaped;
+    }
+
+    auto internal_trace_json_get() -> std::string
+    {
+        auto& registry = get_registry();
+        std::lock_guard lock(registry.mutex);
+
+        std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        json += R"({"name":"process_name","ph":"M","pid":0,"args":{"name":"CPU"}})";
+        json += ",\n";
+        json += R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"GPU"}})";
+
+        for (const auto& buffer : registry.threadBuffers)
+        {
+            json += std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{0},\"args\":{{\"name\":\"Thread {0}\"}}}}",
+                                buffer->threadIndex);
+
+            const auto writeCount = buffer->writeCount.load(std::memory_order_acquire);
+            const auto firstEvent = std::max(buffer->clearedCount.load(std::memory_order_relaxed),
+                                             writeCount > TRACE_EVENTS_PER_THREAD ? writeCount - TRACE_EVENTS_PER_THREAD : 0);
+            for (auto i = firstEvent; i < writeCount; ++i)
+            {
+                const auto& slot = buffer->slots[i % TRACE_EVENTS_PER_THREAD];
+                const auto sequence = i * 2 + 2;
+                if (slot.sequence.load(std::memory_order_acquire) != sequence)
+                {
+                    continue;
+                }
+                const TraceEvent event{
+                    slot.name.load(std::memory_order_relaxed),
+                    slot.startNs.load(std::memory_order_relaxed),
+                    slot.endNs.load(std::memory_order_relaxed),
+                };
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+                {
+                    // Overwritten by a newer event while it was being read.
+                    continue;
+                }
+
+                json += std::format(",\n{{\"name\":\"{}\",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,\"tid\":{}}}",
+                                    internal_trace_escape_json(event.name),
+                                    to_us(event.startNs),
+                                    to_us(event.endNs - event.startNs),
+                                    buffer->threadIndex);
+            }
+        }
+
+        for (const auto& event : registry.detailEvents)
+        {
+            json += std::format(",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,\"tid\":{},"
+                                "\"args\":{}}}",
+                                internal_trace_escape_json(event.name),
+                                internal_trace_escape_json(event.category),
+                                to_us(event.startNs),
+                                to_us(event.endNs - event.startNs),
+                                event.threadIndex,
+                                event.argsJson.empty() ? "{}" : event.argsJson);
+        }
+
+        for (const auto& event : registry.gpuEvents)
+        {
+            json += std::format(",\n{{\"name\":\"{}\",\"cat\":\"gpu\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":0,"
+                                "\"args\":{{\"depth\":{}}}}}",
+                                internal_trace_escape_json(event.name),
+                                to_us(event.startNs),
+                                to_us(event.endNs - event.startNs),
+                                event.depth);
+        }
+
+        json += "\n]}\n";
+        return json;
+    }
+
+    void internal_trace_clear()
+    {
+        auto& registry = get_registry();
+        std::lock_guard lock(registry.mutex);
+        for (auto& buffer : registry.threadBuffers)
+        {
+            buffer->clearedCount.store(buffer->writeCount.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+        registry.gpuEvents.clear();
+        registry.detailEvents.clear();
+    }
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <string_view>
+
+#ifdef VGW_ENABLE_TRACING
+    #define VGW_TRACE_CONCAT_IMPL(_a, _b) _a##_b
+    #define VGW_TRACE_CONCAT(_a, _b) VGW_TRACE_CONCAT_IMPL(_a, _b)
+    #define VGW_TRACE_SCOPE(_name) const ::vgw::internal::TraceScope VGW_TRACE_CONCAT(traceScope, __LINE__)(_name)
+#else
+    #define VGW_TRACE_SCOPE(_name)
+#endif
+
+namespace vgw::internal
+{
+    // Per thread. When full, the oldest events are overwritten.
+    constexpr std::size_t TRACE_EVENTS_PER_THREAD = 16384;
+    constexpr std::size_t MAX_GPU_TRACE_EVENTS = 16384;
+    constexpr std::size_t MAX_DETAIL_TRACE_EVENTS = 4096;
+
+    struct TraceEvent
+    {
+        // Must be a string literal (or otherwise outlive the trace).
+        const char* name{};
+        std::uint64_t startNs{};
+        std::uint64_t endNs{};
+    };
+
+    inline auto trace_now_ns() noexcept -> std::uint64_t
+    {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    }
+
+    void internal_trace_event_add(const TraceEvent& event) noexcept;
+
+    class TraceScope
+    {
+    public:
+        explicit TraceScope(const char* name) noexcept : m_name(name), m_startNs(trace_now_ns()) {}
+        ~TraceScope() { internal_trace_event_add({ m_name, m_startNs, trace_now_ns() }); }
+
+        TraceScope(const TraceScope&) = delete;
+        auto operator=(const TraceScope&) -> TraceScope& = delete;
+
+    private:
+        const char* m_name;
+        std::uint64_t m_startNs;
+    };
+
+    // GPU scopes are placed on their own track. Times are in the CPU clock domain (see `internal_gpu_profiler_frame_begin`).
+    void internal_trace_gpu_event_add(std::string_view name, std::uint32_t depth, std::uint64_t startNs, std::uint64_t endNs);
+    /**
+     * For rare events with runtime names, placed on the calling thread's track. `argsJson` must be a JSON object (or empty).
+     * Kept in a shared list of the last `MAX_DETAIL_TRACE_EVENTS` events.
+     */
+    void internal_trace_detail_event_add(std::string_view category,
+                                         std::string_view name,
+                                         std::uint64_t startNs,
+                                         std::uint64_t endNs,
+                                         std::string argsJson);
+
+    auto internal_trace_escape_json(std::string_view str) -> std::string;
+
+    auto internal_trace_json_get() -> std::string;
+    void internal_trace_clear();
+
+}
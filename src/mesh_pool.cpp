@@ -0,0 +1,417 @@
+#include "vgw/mesh_pool.hpp"
+
+#include "internal/internal_core.hpp"
+
+#include <cstring>
+
+namespace vgw
+{
+    MeshPool::~MeshPool()
+    {
+        destroy();
+    }
+
+    auto MeshPool::initialise(const MeshPoolInfo& poolInfo) -> ResultCode
+    {
+        if (m_isInitialised)
+        {
+            internal::log_warn("Mesh pool is already initialised!");
+            return ResultCode::eSuccess;
+        }
+        if (poolInfo.vertexStride == 0 || poolInfo.pageVertexCount == 0 || poolInfo.pageIndexCount == 0)
+        {
+            internal::log_error("Mesh pool needs a vertex stride and non-zero page sizes!");
+            return ResultCode::eFailed;
+        }
+        if (poolInfo.indexType != vk::IndexType::eUint16 && poolInfo.indexType != vk::IndexType::eUint32)
+        {
+            internal::log_error("Mesh pool indices must be 16 or 32 bit!");
+            return ResultCode::eFailed;
+        }
+
+        if (!poolInfo.hostVisiblePages)
+        {
+            const CmdBufferAllocInfo cmdAllocInfo{
+                .count = 1,
+                .level = vk::CommandBufferLevel::ePrimary,
+                .poolFlags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                .queueIndex = poolInfo.queueIndex,
+            };
+            auto cmdResult = allocate_command_buffers(cmdAllocInfo);
+            if (!cmdResult)
+            {
+                return cmdResult.error();
+            }
+            auto fenceResult = create_fence({});
+            if (!fenceResult)
+            {
+                free_command_buffers(cmdResult.value());
+                return fenceResult.error();
+            }
+            m_cmd = cmdResult.value().front();
+            m_fence = fenceResult.value();
+        }
+
+        m_info = poolInfo;
+        m_isInitialised = true;
+        return ResultCode::eSuccess;
+    }
+
+    void MeshPool::destroy()
+    {
+        if (!m_isInitialised)
+        {
+            return;
+        }
+
+        for (auto& page : m_pages)
+        {
+            destroy_page(page);
+        }
+        m_pages.clear();
+        if (m_cmd != nullptr)
+        {
+            free_command_buffers({ m_cmd });
+            destroy_fence(m_fence);
+            m_cmd = nullptr;
+            m_fence = nullptr;
+        }
+        m_isInitialised = false;
+    }
+
+    auto MeshPool::allocate_mesh(vk::DeviceSize vertexBytes, std::uint32_t indexCount) -> std::expected<MeshAllocation, ResultCode>
+    {
+        if (!m_isInitialised)
+        {
+            internal::log_error("Mesh pool is not initialised!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+        if (vertexBytes == 0 || vertexBytes % m_info.vertexStride != 0)
+        {
+            internal::log_error("Mesh vertex size ({}) must be a non-zero multiple of the vertex stride ({})!",
+                                vertexBytes,
+                                m_info.vertexStride);
+            return std::unexpected(ResultCode::eFailed);
+        }
+
+        const auto vertexCount = vertexBytes / m_info.vertexStride;
+        if (vertexCount > m_info.pageVertexCount || indexCount > m_info.pageIndexCount)
+        {
+            internal::log_error("Mesh ({} vertices, {} indices) is larger than a mesh pool page!", vertexCount, indexCount);
+            return std::unexpected(ResultCode::eFailed);
+        }
+
+        MeshAllocation mesh{};
+        for (std::uint32_t i = 0; i < m_pages.size(); ++i)
+        {
+            if (allocate_from_page(i, std::uint32_t(vertexCount), indexCount, mesh))
+            {
+                return mesh;
+            }
+        }
+
+        auto pageResult = create_page();
+        if (!pageResult)
+        {
+            return std::unexpected(pageResult.error());
+        }
+        if (!allocate_from_page(pageResult.value(), std::uint32_t(vertexCount), indexCount, mesh))
+        {
+            internal::log_error("Failed to allocate mesh from a new mesh pool page!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+        return mesh;
+    }
+
+    void MeshPool::free_mesh(const MeshAllocation& mesh)
+    {
+        if (mesh.page >= m_pages.size())
+        {
+            internal::log_warn("Tried to free mesh from unknown mesh pool page.");
+            return;
+        }
+
+        const auto& page = m_pages.at(mesh.page);
+        if (mesh.vertexAllocation != VK_NULL_HANDLE)
+        {
+            vmaVirtualFree(page.vertexBlock, mesh.vertexAllocation);
+        }
+        if (mesh.indexAllocation != VK_NULL_HANDLE)
+        {
+            vmaVirtualFree(page.indexBlock, mesh.indexAllocation);
+        }
+    }
+
+    auto MeshPool::write_mesh(const MeshAllocation& mesh, const void* vertexData, const void* indexData) -> ResultCode
+    {
+        if (mesh.page >= m_pages.size())
+        {
+            internal::log_error("Tried to write mesh to unknown mesh pool page!");
+            return ResultCode::eInvalidHandle;
+        }
+
+        const auto& page = m_pages.at(mesh.page);
+        if (!m_info.hostVisiblePages)
+        {
+            return upload_staged(page, mesh, vertexData, indexData);
+        }
+
+        if (vertexData != nullptr && mesh.vertexCount > 0)
+        {
+            const auto offset = vk::DeviceSize(mesh.vertexOffset) * m_info.vertexStride;
+            auto result = write_mapped(page.vertexBuffer, offset, vertexData, vk::DeviceSize(mesh.vertexCount) * m_info.vertexStride);
+            if (result != ResultCode::eSuccess)
+            {
+                return result;
+            }
+        }
+        if (indexData != nullptr && mesh.indexCount > 0)
+        {
+            const auto offset = vk::DeviceSize(mesh.firstIndex) * get_index_size();
+            return write_mapped(page.indexBuffer, offset, indexData, vk::DeviceSize(mesh.indexCount) * get_index_size());
+        }
+        return ResultCode::eSuccess;
+    }
+
+    void MeshPool::bind(CommandBuffer cmd, std::uint32_t page) const
+    {
+        if (page >= m_pages.size())
+        {
+            internal::log_error("Tried to bind unknown mesh pool page!");
+            return;
+        }
+
+        const auto& pageRef = m_pages.at(page);
+        cmd->bind_vertex_buffer(pageRef.vertexBuffer);
+        cmd->bind_index_buffer(pageRef.indexBuffer, m_info.indexType);
+    }
+
+    void MeshPool::draw(CommandBuffer cmd, const MeshAllocation& mesh, std::uint32_t instanceCount, std::uint32_t firstInstance) const
+    {
+        cmd->draw_indexed(mesh.indexCount, instanceCount, mesh.firstIndex, mesh.vertexOffset, firstInstance);
+    }
+
+    auto MeshPool::get_draw_command(const MeshAllocation& mesh, std::uint32_t instanceCount, std::uint32_t firstInstance) const
+        -> vk::DrawIndexedIndirectCommand
+    {
+        return { mesh.indexCount, instanceCount, mesh.firstIndex, mesh.vertexOffset, firstInstance };
+    }
+
+    auto MeshPool::get_page_count() const -> std::uint32_t
+    {
+        return std::uint32_t(m_pages.size());
+    }
+
+    auto MeshPool::get_vertex_buffer(std::uint32_t page) const -> vk::Buffer
+    {
+        return page < m_pages.size() ? m_pages.at(page).vertexBuffer : vk::Buffer{};
+    }
+
+    auto MeshPool::get_index_buffer(std::uint32_t page) const -> vk::Buffer
+    {
+        return page < m_pages.size() ? m_pages.at(page).indexBuffer : vk::Buffer{};
+    }
+
+    auto MeshPool::create_page() -> std::expected<std::uint32_t, ResultCode>
+    {
+        Page page{};
+
+        // Host visible pages are written directly and prefer device local memory (ReBAR/UMA) where available.
+        BufferInfo bufferInfo{
+            .size = vk::DeviceSize(m_info.pageVertexCount) * m_info.vertexStride,
+            .usage = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst | m_info.extraUsage,
+            .memUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+            .memoryHints = { .hostVisibleDeviceLocal = m_info.hostVisiblePages },
+        };
+        auto vertexBufferResult = create_buffer(bufferInfo);
+        if (!vertexBufferResult)
+        {
+            return std::unexpected(vertexBufferResult.error());
+        }
+        page.vertexBuffer = vertexBufferResult.value();
+
+        bufferInfo.size = vk::DeviceSize(m_info.pageIndexCount) * get_index_size();
+        bufferInfo.usage = vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst | m_info.extraUsage;
+        auto indexBufferResult = create_buffer(bufferInfo);
+        if (!indexBufferResult)
+        {
+            destroy_page(page);
+            return std::unexpected(indexBufferResult.error());
+        }
+        page.indexBuffer = indexBufferResult.value();
+
+        VmaVirtualBlockCreateInfo blockCreateInfo{};
+        blockCreateInfo.size = m_info.pageVertexCount;
+        if (vmaCreateVirtualBlock(&blockCreateInfo, &page.vertexBlock) != VK_SUCCESS)
+        {
+            internal::log_error("Failed to create mesh pool vertex block!");
+            destroy_page(page);
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+        blockCreateInfo.size = m_info.pageIndexCount;
+        if (vmaCreateVirtualBlock(&blockCreateInfo, &page.indexBlock) != VK_SUCCESS)
+        {
+            internal::log_error("Failed to create mesh pool index block!");
+            destroy_page(page);
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        m_pages.push_back(page);
+        internal::log_debug("Mesh pool page {} created.", m_pages.size() - 1);
+        return std::uint32_t(m_pages.size() - 1);
+    }
+
+    void MeshPool::destroy_page(Page& page)
+    {
+        if (page.vertexBlock != VK_NULL_HANDLE)
+        {
+            vmaClearVirtualBlock(page.vertexBlock);
+            vmaDestroyVirtualBlock(page.vertexBlock);
+        }
+        if (page.indexBlock != VK_NULL_HANDLE)
+        {
+            vmaClearVirtualBlock(page.indexBlock);
+            vmaDestroyVirtualBlock(page.indexBlock);
+        }
+        if (page.vertexBuffer)
+        {
+            destroy_buffer(page.vertexBuffer);
+        }
+        if (page.indexBuffer)
+        {
+            destroy_buffer(page.indexBuffer);
+        }
+        page = {};
+    }
+
+    auto MeshPool::write_mapped(vk::Buffer buffer, vk::DeviceSize offset, const void* data, vk::DeviceSize size) -> ResultCode
+    {
+        auto mapResult = map_buffer(buffer);
+        if (!mapResult)
+        {
+            return mapResult.error();
+        }
+        std::memcpy(static_cast<std::uint8_t*>(mapResult.value()) + offset, data, size);
+        unmap_buffer(buffer);
+        return ResultCode::eSuccess;
+    }
+
+    auto MeshPool::upload_staged(const Page& page, const MeshAllocation& mesh, const void* vertexData, const void* indexData)
+        -> ResultCode
+    {
+        const auto vertexBytes = vertexData != nullptr ? vk::DeviceSize(mesh.vertexCount) * m_info.vertexStride : 0;
+        const auto indexBytes = indexData != nullptr ? vk::DeviceSize(mesh.indexCount) * get_index_size() : 0;
+        if (vertexBytes + indexBytes == 0)
+        {
+            return ResultCode::eSuccess;
+        }
+
+        // The vertices are staged first, followed by the indices.
+        const BufferInfo stagingInfo{
+            .size = vertexBytes + indexBytes,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc,
+            .memUsage = VMA_MEMORY_USAGE_AUTO,
+            .allocFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+        };
+        auto bufferResult = create_buffer(stagingInfo);
+        if (!bufferResult)
+        {
+            return bufferResult.error();
+        }
+        const auto stagingBuffer = bufferResult.value();
+
+        auto mapResult = map_buffer(stagingBuffer);
+        if (!mapResult)
+        {
+            destroy_buffer(stagingBuffer);
+            return mapResult.error();
+        }
+        auto* mappedData = static_cast<std::uint8_t*>(mapResult.value());
+        if (vertexBytes > 0)
+        {
+            std::memcpy(mappedData, vertexData, vertexBytes);
+        }
+        if (indexBytes > 0)
+        {
+            std::memcpy(mappedData + vertexBytes, indexData, indexBytes);
+        }
+        unmap_buffer(stagingBuffer);
+
+        m_cmd->reset();
+        m_cmd->begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        if (vertexBytes > 0)
+        {
+            const auto dstOffset = vk::DeviceSize(mesh.vertexOffset) * m_info.vertexStride;
+            const vk::BufferCopy2 region(0, dstOffset, vertexBytes);
+            m_cmd->copy_buffer(CopyBufferInfo{ stagingBuffer, page.vertexBuffer, { region } });
+        }
+        if (indexBytes > 0)
+        {
+            const auto dstOffset = vk::DeviceSize(mesh.firstIndex) * get_index_size();
+            const vk::BufferCopy2 region(vertexBytes, dstOffset, indexBytes);
+            m_cmd->copy_buffer(CopyBufferInfo{ stagingBuffer, page.indexBuffer, { region } });
+        }
+        // Waiting on the fence does not make the copies visible to later submissions, so the barrier does.
+        m_cmd->memory_barrier({
+            .srcAccess = vk::AccessFlagBits2::eTransferWrite,
+            .dstAccess = vk::AccessFlagBits2::eMemoryRead,
+            .srcStage = vk::PipelineStageFlagBits2::eCopy,
+            .dstStage = vk::PipelineStageFlagBits2::eAllCommands,
+        });
+        m_cmd->end();
+
+        const SubmitInfo submitInfo{
+            .queueIndex = m_info.queueIndex,
+            .cmdBuffers = { *m_cmd },
+            .signalFence = m_fence,
+        };
+        submit(submitInfo);
+        wait_on_fence(m_fence);
+        reset_fence(m_fence);
+        destroy_buffer(stagingBuffer);
+        return ResultCode::eSuccess;
+    }
+
+    auto MeshPool::allocate_from_page(std::uint32_t pageIndex, std::uint32_t vertexCount, std::uint32_t indexCount, MeshAllocation& outMesh)
+        -> bool
+    {
+        const auto& page = m_pages.at(pageIndex);
+
+        VmaVirtualAllocationCreateInfo allocCreateInfo{};
+        allocCreateInfo.size = vertexCount;
+        VmaVirtualAllocation vertexAllocation{};
+        vk::DeviceSize vertexOffset{};
+        if (vmaVirtualAllocate(page.vertexBlock, &allocCreateInfo, &vertexAllocation, &vertexOffset) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VmaVirtualAllocation indexAllocation{};
+        vk::DeviceSize firstIndex{};
+        if (indexCount > 0)
+        {
+            allocCreateInfo.size = indexCount;
+            if (vmaVirtualAllocate(page.indexBlock, &allocCreateInfo, &indexAllocation, &firstIndex) != VK_SUCCESS)
+            {
+                vmaVirtualFree(page.vertexBlock, vertexAllocation);
+                return false;
+            }
+        }
+
+        outMesh = {
+            .page = pageIndex,
+            .vertexOffset = std::int32_t(vertexOffset),
+            .firstIndex = std::uint32_t(firstIndex),
+            .vertexCount = vertexCount,
+            .indexCount = indexCount,
+            .vertexAllocation = vertexAllocation,
+            .indexAllocation = indexAllocation,
+        };
+        return true;
+    }
+
+    auto MeshPool::get_index_size() const -> std::uint32_t
+    {
+        return m_info.indexType == vk::IndexType::eUint16 ? 2 : 4;
+    }
+}
@@ -0,0 +1,795 @@
+#include "vgw/render_graph.hpp"
+
+#include "internal/internal_core.hpp"
+#include "internal/internal_device.hpp"
+#include "internal/internal_memory.hpp"
+#include "internal/internal_images.hpp"
+#include "internal/internal_buffers.hpp"
+#include "internal/internal_synchronisation.hpp"
+#include "internal/internal_stats.hpp"
+
+#include <queue>
+#include <thread>
+#include <algorithm>
+
+namespace vgw
+{
+    namespace
+    {
+        struct AccessState
+        {
+            vk::ImageLayout layout{};
+            vk::AccessFlags2 access{};
+            vk::PipelineStageFlags2 stage{};
+        };
+
+        auto get_access_state(RenderGraphAccess access, bool isCompute) -> AccessState
+        {
+            const vk::PipelineStageFlags2 shaderStages = isCompute ? vk::PipelineStageFlags2(vk::PipelineStageFlagBits2::eComputeShader)
+                                                                   : vk::PipelineStageFlagBits2::eVertexShader |
+                                                                         vk::PipelineStageFlagBits2::eFragmentShader;
+            switch (access)
+            {
+                case RenderGraphAccess::eSampled:
+                    return { vk::ImageLayout::eShaderReadOnlyOptimal, vk::AccessFlagBits2::eShaderSampledRead, shaderStages };
+                case RenderGraphAccess::eStorageRead:
+                    return { vk::ImageLayout::eGeneral, vk::AccessFlagBits2::eShaderStorageRead, shaderStages };
+                case RenderGraphAccess::eStorageWrite:
+                    return { vk::ImageLayout::eGeneral,
+                             vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite,
+                             shaderStages };
+                case RenderGraphAccess::eUniform:
+                    return { vk::ImageLayout::eUndefined, vk::AccessFlagBits2::eUniformRead, shaderStages };
+                case RenderGraphAccess::eVertexBuffer:
+                    return { vk::ImageLayout::eUndefined,
+                             vk::AccessFlagBits2::eVertexAttributeRead,
+                             vk::PipelineStageFlagBits2::eVertexAttributeInput };
+                case RenderGraphAccess::eIndexBuffer:
+                    return { vk::ImageLayout::eUndefined, vk::AccessFlagBits2::eIndexRead, vk::PipelineStageFlagBits2::eIndexInput };
+                case RenderGraphAccess::eIndirectBuffer:
+                    return { vk::ImageLayout::eUndefined,
+                             vk::AccessFlagBits2::eIndirectCommandRead,
+                             vk::PipelineStageFlagBits2::eDrawIndirect };
+                case RenderGraphAccess::eTransferSrc:
+                    return { vk::ImageLayout::eTransferSrcOptimal,
+                             vk::AccessFlagBits2::eTransferRead,
+                             vk::PipelineStageFlagBits2::eTransfer };
+                case RenderGraphAccess::eTransferDst:
+                    return { vk::ImageLayout::eTransferDstOptimal,
+                             vk::AccessFlagBits2::eTransferWrite,
+                             vk::PipelineStageFlagBits2::eTransfer };
+                case RenderGraphAccess::eColorAttachment:
+                    return { vk::ImageLayout::eColorAttachmentOptimal,
+                             vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite,
+                             vk::PipelineStageFlagBits2::eColorAttachmentOutput };
+                case RenderGraphAccess::eDepthAttachment:
+                    return { vk::ImageLayout::eDepthStencilAttachmentOptimal,
+                             vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                             vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests };
+                case RenderGraphAccess::ePresent:
+                    // The stage the acquire semaphore is usually waited on, so the next transition out of present chains with that wait.
+                    return { vk::ImageLayout::ePresentSrcKHR,
+                             vk::AccessFlagBits2::eNone,
+                             vk::PipelineStageFlagBits2::eColorAttachmentOutput };
+            }
+            return {};
+        }
+
+        auto get_image_usage(RenderGraphAccess access) -> vk::ImageUsageFlags
+        {
+            switch (access)
+            {
+                case RenderGraphAccess::eSampled: return vk::ImageUsageFlagBits::eSampled;
+                case RenderGraphAccess::eStorageRead:
+                case RenderGraphAccess::eStorageWrite: return vk::ImageUsageFlagBits::eStorage;
+                case RenderGraphAccess::eTransferSrc: return vk::ImageUsageFlagBits::eTransferSrc;
+                case RenderGraphAccess::eTransferDst: return vk::ImageUsageFlagBits::eTransferDst;
+                case RenderGraphAccess::eColorAttachment: return vk::ImageUsageFlagBits::eColorAttachment;
+                case RenderGraphAccess::eDepthAttachment: return vk::ImageUsageFlagBits::eDepthStencilAttachment;
+                default: break;
+            }
+            return {};
+        }
+
+        struct ResourceUse
+        {
+            bool isImage{};
+            std::uint32_t index{};
+            RenderGraphAccess access{};
+            bool isWrite{};
+        };
+
+        auto gather_uses(const RenderGraphPassInfo& passInfo) -> std::vector<ResourceUse>
+        {
+            std::vector<ResourceUse> uses{};
+            for (const auto& use : passInfo.imageReads)
+            {
+                uses.push_back({ true, use.image.index, use.access, false });
+            }
+            for (const auto& use : passInfo.imageWrites)
+            {
+                uses.push_back({ true, use.image.index, use.access, true });
+            }
+            for (const auto& use : passInfo.bufferReads)
+            {
+                uses.push_back({ false, use.buffer.index, use.access, false });
+            }
+            for (const auto& use : passInfo.bufferWrites)
+            {
+                uses.push_back({ false, use.buffer.index, use.access, true });
+            }
+            for (const auto& attachment : passInfo.colorAttachments)
+            {
+                if (attachment.loadOp == vk::AttachmentLoadOp::eLoad)
+                {
+                    uses.push_back({ true, attachment.image.index, RenderGraphAccess::eColorAttachment, false });
+                }
+                uses.push_back({ true, attachment.image.index, RenderGraphAccess::eColorAttachment, true });
+            }
+            if (passInfo.depthAttachment)
+            {
+                const auto& attachment = passInfo.depthAttachment.value();
+                if (attachment.loadOp == vk::AttachmentLoadOp::eLoad)
+                {
+                    uses.push_back({ true, attachment.image.index, RenderGraphAccess::eDepthAttachment, false });
+                }
+                uses.push_back({ true, attachment.image.index, RenderGraphAccess::eDepthAttachment, true });
+            }
+            return uses;
+        }
+    }
+
+    RenderGraph::~RenderGraph()
+    {
+        if (internal::internal_device_is_valid())
+        {
+            reset();
+        }
+    }
+
+    auto RenderGraph::import_image(const RenderGraphImportedImageInfo& importInfo) -> RenderGraphImage
+    {
+        vk::Format format{};
+        auto imageResult = internal::internal_image_get(importInfo.image);
+        if (imageResult)
+        {
+            format = imageResult.value().get().format;
+        }
+
+        m_images.push_back({
+            .image = importInfo.image,
+            .view = importInfo.view,
+            .info = { importInfo.width, importInfo.height, format },
+            .isImported = true,
+        });
+        return { std::uint32_t(m_images.size() - 1) };
+    }
+
+    auto RenderGraph::create_image(const RenderGraphImageInfo& imageInfo) -> RenderGraphImage
+    {
+        m_images.push_back({ .info = imageInfo });
+        return { std::uint32_t(m_images.size() - 1) };
+    }
+
+    auto RenderGraph::import_buffer(vk::Buffer buffer) -> RenderGraphBuffer
+    {
+        m_buffers.push_back({ buffer });
+        return { std::uint32_t(m_buffers.size() - 1) };
+    }
+
+    void RenderGraph::add_pass(const RenderGraphPassInfo& passInfo)
+    {
+        m_passes.push_back({ .info = passInfo });
+    }
+
+    auto RenderGraph::compile() -> ResultCode
+    {
+        if (!m_passOrder.empty())
+        {
+            internal::log_error("Render graph has already been compiled!");
+            return ResultCode::eFailed;
+        }
+
+        const auto passCount = std::uint32_t(m_passes.size());
+        std::vector<std::vector<ResourceUse>> passUses(passCount);
+        for (std::uint32_t i = 0; i < passCount; ++i)
+        {
+            passUses.at(i) = gather_uses(m_passes.at(i).info);
+            for (const auto& use : passUses.at(i))
+            {
+                if (use.index >= (use.isImage ? m_images.size() : m_buffers.size()))
+                {
+                    internal::log_error("Render graph pass '{}' uses an unknown resource!", m_passes.at(i).info.name);
+                    return ResultCode::eInvalidHandle;
+                }
+            }
+        }
+
+#pragma region Culling
+
+        std::vector<bool> imageNeeded(m_images.size(), false);
+        std::vector<bool> bufferNeeded(m_buffers.size(), true);
+        std::vector<bool> passKept(passCount, false);
+        for (auto i = passCount; i-- > 0;)
+        {
+            bool keep = m_passes.at(i).info.hasSideEffects;
+            for (const auto& use : passUses.at(i))
+            {
+                if (use.isWrite)
+                {
+                    // Buffers are always imported, so writes to them are always visible outside the graph.
+                    keep |= use.isImage ? (m_images.at(use.index).isImported || imageNeeded.at(use.index)) : bufferNeeded.at(use.index);
+                }
+            }
+            if (!keep)
+            {
+                internal::log_debug("Render graph pass '{}' culled.", m_passes.at(i).info.name);
+                continue;
+            }
+
+            passKept.at(i) = true;
+            for (const auto& use : passUses.at(i))
+            {
+                if (!use.isWrite && use.isImage)
+                {
+                    imageNeeded.at(use.index) = true;
+                }
+            }
+        }
+
+#pragma endregion
+#pragma region Topological Sort
+
+        struct DependencyTracking
+        {
+            std::optional<std::uint32_t> lastWriter{};
+            std::vector<std::uint32_t> readers{};
+        };
+        std::vector<DependencyTracking> imageTracking(m_images.size());
+        std::vector<DependencyTracking> bufferTracking(m_buffers.size());
+        std::vector<std::vector<std::uint32_t>> successors(passCount);
+        std::vector<std::uint32_t> inDegree(passCount, 0);
+        auto add_edge = [&](std::uint32_t from, std::uint32_t to)
+        {
+            if (from != to)
+            {
+                successors.at(from).push_back(to);
+                inDegree.at(to)++;
+            }
+        };
+
+        for (std::uint32_t i = 0; i < passCount; ++i)
+        {
+            if (!passKept.at(i))
+            {
+                continue;
+            }
+
+            for (const auto& use : passUses.at(i))
+            {
+                auto& tracking = use.isImage ? imageTracking.at(use.index) : bufferTracking.at(use.index);
+                if (!use.isWrite)
+                {
+                    if (tracking.lastWriter)
+                    {
+                        add_edge(tracking.lastWriter.value(), i);
+                    }
+                    tracking.readers.push_back(i);
+                }
+            }
+            for (const auto& use : passUses.at(i))
+            {
+                auto& tracking = use.isImage ? imageTracking.at(use.index) : bufferTracking.at(use.index);
+                if (use.isWrite)
+                {
+                    if (tracking.lastWriter)
+                    {
+                        add_edge(tracking.lastWriter.value(), i);
+                    }
+                    for (auto reader : tracking.readers)
+                    {
+                        add_edge(reader, i);
+                    }
+                    tracking.readers.clear();
+                    tracking.lastWriter = i;
+                }
+            }
+        }
+
+        // Ties are broken by declaration order, so independent passes keep the order they were added in.
+        std::priority_queue<std::uint32_t, std::vector<std::uint32_t>, std::greater<>> readyPasses{};
+        for (std::uint32_t i = 0; i < passCount; ++i)
+        {
+            if (passKept.at(i) && inDegree.at(i) == 0)
+            {
+                readyPasses.push(i);
+            }
+        }
+        while (!readyPasses.empty())
+        {
+            const auto passIndex = readyPasses.top();
+            readyPasses.pop();
+            m_passOrder.push_back(passIndex);
+            for (auto successor : successors.at(passIndex))
+            {
+                if (--inDegree.at(successor) == 0)
+                {
+                    readyPasses.push(successor);
+                }
+            }
+        }
+
+#pragma endregion
+#pragma region Transient Images
+
+        constexpr auto NotUsed = std::uint32_t(-1);
+        std::vector<std::uint32_t> firstUse(m_images.size(), NotUsed);
+        std::vector<std::uint32_t> lastUse(m_images.size(), 0);
+        std::vector<vk::ImageUsageFlags> imageUsage(m_images.size());
+        for (std::uint32_t position = 0; position < m_passOrder.size(); ++position)
+        {
+            for (const auto& use : passUses.at(m_passOrder.at(position)))
+            {
+                if (use.isImage)
+                {
+                    firstUse.at(use.index) = std::min(firstUse.at(use.index), position);
+                    lastUse.at(use.index) = std::max(lastUse.at(use.index), position);
+                    imageUsage.at(use.index) |= get_image_usage(use.access);
+                }
+            }
+        }
+
+        struct Placement
+        {
+            std::uint32_t image{};
+            vk::DeviceSize offset{};
+            vk::DeviceSize size{};
+            vk::DeviceSize alignment{};
+        };
+        std::vector<Placement> placements{};
+        std::uint32_t memoryTypeBits = ~0u;
+        for (std::uint32_t i = 0; i < m_images.size(); ++i)
+        {
+            if (m_images.at(i).isImported || firstUse.at(i) == NotUsed)
+            {
+                continue;
+            }
+
+            const auto& info = m_images.at(i).info;
+            const ImageInfo imageInfo{ vk::ImageType::e2D, info.width, info.height, 1, 1, info.format, imageUsage.at(i) };
+            auto requirementsResult = internal::internal_image_memory_requirements_get(imageInfo);
+            if (!requirementsResult)
+            {
+                return requirementsResult.error();
+            }
+            const auto& requirements = requirementsResult.value();
+            memoryTypeBits &= requirements.memoryTypeBits;
+            placements.push_back({ i, 0, requirements.size, requirements.alignment });
+        }
+
+        // Images that are not alive at the same time share memory.
+        std::vector<internal::MemoryInterval> intervals{};
+        for (const auto& placement : placements)
+        {
+            intervals.push_back({ placement.size,
+                                  placement.alignment,
+                                  firstUse.at(placement.image),
+                                  lastUse.at(placement.image),
+                                  ResourceLinearity::eNonLinear });
+        }
+        // Transient images all have optimal tiling, so they never need to be kept a granularity page apart.
+        const auto heapSize = internal::internal_memory_pack_intervals(intervals, 1);
+        vk::DeviceSize heapAlignment{ 1 };
+        for (std::size_t i = 0; i < placements.size(); ++i)
+        {
+            placements.at(i).offset = intervals.at(i).offset;
+            heapAlignment = std::max(heapAlignment, placements.at(i).alignment);
+        }
+        auto memory_overlaps = [](const Placement& lhs, vk::DeviceSize offset, vk::DeviceSize size)
+        { return lhs.offset < offset + size && offset < lhs.offset + lhs.size; };
+
+        // Images that previously occupied the same memory. Their last accesses must complete before the new image is first used.
+        std::vector<std::vector<std::uint32_t>> aliasPredecessors(m_images.size());
+        for (const auto& placement : placements)
+        {
+            for (const auto& other : placements)
+            {
+                if (lastUse.at(other.image) < firstUse.at(placement.image) && memory_overlaps(other, placement.offset, placement.size))
+                {
+                    aliasPredecessors.at(placement.image).push_back(other.image);
+                }
+            }
+        }
+
+        if (!placements.empty())
+        {
+            if (memoryTypeBits == 0)
+            {
+                internal::log_error("Render graph transient images have no memory type in common!");
+                return ResultCode::eFailedToCreate;
+            }
+
+            auto memoryResult = internal::internal_memory_allocate({ heapSize, heapAlignment, memoryTypeBits });
+            if (!memoryResult)
+            {
+                return memoryResult.error();
+            }
+            m_transientMemory = memoryResult.value();
+            m_transientMemorySize = heapSize;
+        }
+
+        for (const auto& placement : placements)
+        {
+            auto& imageRef = m_images.at(placement.image);
+            const ImageInfo imageInfo{
+                vk::ImageType::e2D, imageRef.info.width, imageRef.info.height, 1, 1, imageRef.info.format, imageUsage.at(placement.image)
+            };
+            auto imageResult = internal::internal_image_create_aliased(imageInfo, m_transientMemory, placement.offset);
+            if (!imageResult)
+            {
+                return imageResult.error();
+            }
+            imageRef.image = imageResult.value();
+
+            const ImageViewInfo viewInfo{
+                .image = imageRef.image,
+                .type = vk::ImageViewType::e2D,
+                .aspectMask = internal::internal_image_aspect_get(imageRef.info.format),
+            };
+            auto viewResult = create_image_view(viewInfo);
+            if (!viewResult)
+            {
+                return viewResult.error();
+            }
+            imageRef.view = viewResult.value();
+        }
+
+        internal::log_debug("Render graph transient memory: {} bytes for {} images.", heapSize, placements.size());
+
+#pragma endregion
+#pragma region Barriers
+
+        std::vector<internal::ImageSubresourceState> imageStates(m_images.size());
+        for (std::uint32_t i = 0; i < m_images.size(); ++i)
+        {
+            if (!m_images.at(i).isImported)
+            {
+                continue;
+            }
+            auto imageResult = internal::internal_image_get(m_images.at(i).image);
+            if (imageResult && !imageResult.value().get().subresourceStates.empty())
+            {
+                imageStates.at(i) = imageResult.value().get().subresourceStates.front();
+            }
+        }
+        std::vector<internal::BufferAccessState> bufferStates(m_buffers.size());
+        for (std::uint32_t i = 0; i < m_buffers.size(); ++i)
+        {
+            auto bufferResult = internal::internal_buffer_get(m_buffers.at(i).buffer);
+            if (bufferResult)
+            {
+                bufferStates.at(i) = bufferResult.value().get().accessState;
+            }
+        }
+
+        for (std::uint32_t position = 0; position < m_passOrder.size(); ++position)
+        {
+            auto& pass = m_passes.at(m_passOrder.at(position));
+
+            // Combine every use of a resource within the pass into one wanted state.
+            std::vector<std::pair<ResourceUse, AccessState>> wantedStates{};
+            for (const auto& use : passUses.at(m_passOrder.at(position)))
+            {
+                const auto useState = get_access_state(use.access, pass.info.isCompute);
+                auto it = std::ranges::find_if(wantedStates,
+                                               [&](const auto& wanted)
+                                               { return wanted.first.isImage == use.isImage && wanted.first.index == use.index; });
+                if (it == wantedStates.end())
+                {
+                    wantedStates.emplace_back(use, useState);
+                    continue;
+                }
+                if (it->second.layout != useState.layout)
+                {
+                    it->second.layout = vk::ImageLayout::eGeneral;
+                }
+                it->second.access |= useState.access;
+                it->second.stage |= useState.stage;
+            }
+
+            for (const auto& [use, wanted] : wantedStates)
+            {
+                if (use.isImage)
+                {
+                    auto& state = imageStates.at(use.index);
+                    const auto& imageRef = m_images.at(use.index);
+                    if (!imageRef.isImported && firstUse.at(use.index) == position)
+                    {
+                        state = {};
+                        for (auto predecessor : aliasPredecessors.at(use.index))
+                        {
+                            state.access |= internal::get_write_access(imageStates.at(predecessor).access);
+                            state.stage |= imageStates.at(predecessor).stage;
+                        }
+                    }
+
+                    const bool layoutChange = state.layout != wanted.layout;
+                    const bool writeHazard = internal::is_write_access(state.access) || internal::is_write_access(wanted.access);
+                    const bool alreadyVisible =
+                        (state.access & wanted.access) == wanted.access && (state.stage & wanted.stage) == wanted.stage;
+                    if (!layoutChange && !writeHazard && alreadyVisible)
+                    {
+                        continue;
+                    }
+
+                    auto& barrier = pass.imageBarriers.emplace_back();
+                    barrier.setImage(imageRef.image);
+                    barrier.setOldLayout(state.layout);
+                    barrier.setNewLayout(wanted.layout);
+                    barrier.setSrcAccessMask(internal::get_write_access(state.access));
+                    barrier.setDstAccessMask(wanted.access);
+                    barrier.setSrcStageMask(state.stage);
+                    barrier.setDstStageMask(wanted.stage);
+                    barrier.setSubresourceRange({ internal::internal_image_aspect_get(imageRef.info.format),
+                                                  0,
+                                                  VK_REMAINING_MIP_LEVELS,
+                                                  0,
+                                                  VK_REMAINING_ARRAY_LAYERS });
+
+                    if (!layoutChange && !writeHazard)
+                    {
+                        state.access |= wanted.access;
+                        state.stage |= wanted.stage;
+                    }
+                    else
+                    {
+                        state = { wanted.layout, wanted.access, wanted.stage };
+                    }
+                }
+                else
+                {
+                    auto& state = bufferStates.at(use.index);
+                    const bool writeHazard = internal::is_write_access(state.access) || internal::is_write_access(wanted.access);
+                    const bool alreadyVisible =
+                        (state.access & wanted.access) == wanted.access && (state.stage & wanted.stage) == wanted.stage;
+                    if (!writeHazard && alreadyVisible)
+                    {
+                        continue;
+                    }
+
+                    auto& barrier = pass.bufferBarriers.emplace_back();
+                    barrier.setBuffer(m_buffers.at(use.index).buffer);
+                    barrier.setOffset(0);
+                    barrier.setSize(VK_WHOLE_SIZE);
+                    barrier.setSrcAccessMask(internal::get_write_access(state.access));
+                    barrier.setDstAccessMask(wanted.access);
+                    barrier.setSrcStageMask(state.stage);
+                    barrier.setDstStageMask(wanted.stage);
+
+                    if (!writeHazard)
+                    {
+                        state.access |= wanted.access;
+                        state.stage |= wanted.stage;
+                    }
+                    else
+                    {
+                        state = { wanted.access, wanted.stage };
+                    }
+                }
+            }
+
+#pragma region Render Pass
+
+            if (pass.info.colorAttachments.empty() && !pass.info.depthAttachment)
+            {
+                continue;
+            }
+
+            auto get_store_op = [&](RenderGraphImage image)
+            {
+                const bool isStored = m_images.at(image.index).isImported || lastUse.at(image.index) > position;
+                return isStored ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare;
+            };
+
+            const auto firstAttachment =
+                pass.info.colorAttachments.empty() ? pass.info.depthAttachment->image : pass.info.colorAttachments.front().image;
+            pass.width = m_images.at(firstAttachment.index).info.width;
+            pass.height = m_images.at(firstAttachment.index).info.height;
+
+            RenderPassInfo renderPassInfo{ .width = pass.width, .height = pass.height };
+            for (const auto& attachment : pass.info.colorAttachments)
+            {
+                renderPassInfo.colorAttachments.push_back({
+                    .imageView = m_images.at(attachment.image.index).view,
+                    .loadOp = attachment.loadOp,
+                    .storeOp = get_store_op(attachment.image),
+                    .clearColor = attachment.clearColor,
+                });
+            }
+            if (pass.info.depthAttachment)
+            {
+                const auto& attachment = pass.info.depthAttachment.value();
+                renderPassInfo.depthAttachment = {
+                    .imageView = m_images.at(attachment.image.index).view,
+                    .loadOp = attachment.loadOp,
+                    .storeOp = get_store_op(attachment.image),
+                    .clearDepth = attachment.clearDepth,
+                };
+            }
+
+            auto renderPassResult = create_render_pass(renderPassInfo);
+            if (!renderPassResult)
+            {
+                return renderPassResult.error();
+            }
+            pass.renderPass = renderPassResult.value();
+
+#pragma endregion
+        }
+
+        for (std::uint32_t i = 0; i < m_images.size(); ++i)
+        {
+            if (m_images.at(i).isImported && firstUse.at(i) != NotUsed)
+            {
+                const auto& state = imageStates.at(i);
+                m_finalImageStates.push_back({ m_images.at(i).image, state.layout, state.access, state.stage });
+            }
+        }
+        for (std::uint32_t i = 0; i < m_buffers.size(); ++i)
+        {
+            const auto& state = bufferStates.at(i);
+            m_finalBufferStates.push_back({ m_buffers.at(i).buffer, state.access, state.stage });
+        }
+
+#pragma endregion
+
+        return ResultCode::eSuccess;
+    }
+
+    void RenderGraph::execute(CommandBuffer cmd)
+    {
+        for (auto passIndex : m_passOrder)
+        {
+            record_pass(cmd, m_passes.at(passIndex));
+        }
+        apply_final_states();
+    }
+
+    void RenderGraph::execute_parallel(const std::vector<CommandBuffer>& cmdBuffers)
+    {
+        if (cmdBuffers.empty())
+        {
+            return;
+        }
+
+        // Every state the passes need was resolved by `compile()`. Callbacks must not touch the shared state tracking from the workers.
+        for (const auto& cmd : cmdBuffers)
+        {
+            cmd->set_state_tracking(false);
+        }
+
+        const auto passesPerThread = (m_passOrder.size() + cmdBuffers.size() - 1) / cmdBuffers.size();
+        std::vector<std::thread> threads{};
+        for (std::size_t i = 0; i < cmdBuffers.size(); ++i)
+        {
+            const auto begin = std::min(i * passesPerThread, m_passOrder.size());
+            const auto end = std::min(begin + passesPerThread, m_passOrder.size());
+            threads.emplace_back(
+                [this, cmd = cmdBuffers.at(i), begin, end]
+                {
+                    for (auto position = begin; position < end; ++position)
+                    {
+                        record_pass(cmd, m_passes.at(m_passOrder.at(position)));
+                    }
+                });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        for (const auto& cmd : cmdBuffers)
+        {
+            cmd->set_state_tracking(true);
+        }
+
+        apply_final_states();
+    }
+
+    void RenderGraph::reset()
+    {
+        for (const auto& pass : m_passes)
+        {
+            if (pass.renderPass)
+            {
+                destroy_render_pass(pass.renderPass);
+            }
+        }
+        for (const auto& imageRef : m_images)
+        {
+            if (!imageRef.isImported && imageRef.image)
+            {
+                destroy_image_view(imageRef.view);
+                destroy_image(imageRef.image);
+            }
+        }
+        if (m_transientMemory)
+        {
+            internal::internal_memory_free(m_transientMemory);
+        }
+
+        m_images.clear();
+        m_buffers.clear();
+        m_passes.clear();
+        m_passOrder.clear();
+        m_transientMemory = nullptr;
+        m_transientMemorySize = 0;
+        m_finalImageStates.clear();
+        m_finalBufferStates.clear();
+    }
+
+    auto RenderGraph::get_image(RenderGraphImage image) const -> vk::Image
+    {
+        return image.index < m_images.size() ? m_images.at(image.index).image : vk::Image{};
+    }
+
+    auto RenderGraph::get_image_view(RenderGraphImage image) const -> vk::ImageView
+    {
+        return image.index < m_images.size() ? m_images.at(image.index).view : vk::ImageView{};
+    }
+
+    auto RenderGraph::get_pass_order() const -> std::vector<std::string>
+    {
+        std::vector<std::string> names{};
+        for (auto passIndex : m_passOrder)
+        {
+            names.push_back(m_passes.at(passIndex).info.name);
+        }
+        return names;
+    }
+
+    auto RenderGraph::get_transient_memory_size() const -> std::size_t
+    {
+        return m_transientMemorySize;
+    }
+
+    void RenderGraph::record_pass(CommandBuffer cmd, const Pass& pass)
+    {
+        if (!pass.imageBarriers.empty() || !pass.bufferBarriers.empty())
+        {
+            vk::DependencyInfo depInfo{};
+            depInfo.setImageMemoryBarriers(pass.imageBarriers);
+            depInfo.setBufferMemoryBarriers(pass.bufferBarriers);
+            static_cast<vk::CommandBuffer>(*cmd).pipelineBarrier2(depInfo);
+            internal::internal_stats_barriers_add(pass.imageBarriers.size(), pass.bufferBarriers.size(), 0);
+        }
+
+        if (pass.renderPass)
+        {
+            cmd->begin_pass(pass.renderPass);
+            cmd->set_viewport(0.0f, 0.0f, float(pass.width), float(pass.height));
+            cmd->set_scissor(0, 0, pass.width, pass.height);
+        }
+
+        if (pass.info.execute)
+        {
+            pass.info.execute(cmd);
+        }
+
+        if (pass.renderPass)
+        {
+            cmd->end_pass();
+        }
+    }
+
+    void RenderGraph::apply_final_states()
+    {
+        for (const auto& finalState : m_finalImageStates)
+        {
+            internal::internal_image_state_set(finalState.image, {}, { finalState.layout, finalState.access, finalState.stage });
+        }
+        for (const auto& finalState : m_finalBufferStates)
+        {
+            internal::internal_buffer_access_set(finalState.buffer, { finalState.access, finalState.stage });
+        }
+    }
+}
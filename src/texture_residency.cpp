@@ -0,0 +1,580 @@
+#include "vgw/texture_residency.hpp"
+
+#include "internal/internal_core.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+namespace vgw
+{
+    namespace
+    {
+        constexpr vk::ImageUsageFlags TEXTURE_USAGE =
+            vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst;
+        constexpr vk::PipelineStageFlags2 SAMPLE_STAGES =
+            vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader;
+
+        auto get_mip_extent(const ResidentTextureInfo& info, std::uint32_t mip) -> vk::Extent3D
+        {
+            return { std::max(info.width >> mip, 1u), std::max(info.height >> mip, 1u), 1 };
+        }
+
+        auto make_image_info(const ResidentTextureInfo& info, std::uint32_t baseMip) -> ImageInfo
+        {
+            const auto extent = get_mip_extent(info, baseMip);
+            return {
+                .type = vk::ImageType::e2D,
+                .width = extent.width,
+                .height = extent.height,
+                .depth = 1,
+                .mipLevels = info.mipLevels - baseMip,
+                .format = info.format,
+                .usage = TEXTURE_USAGE,
+            };
+        }
+
+        auto align_up(vk::DeviceSize value, vk::DeviceSize alignment) -> vk::DeviceSize
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    TextureResidency::~TextureResidency()
+    {
+        destroy();
+    }
+
+    auto TextureResidency::initialise(const TextureResidencyInfo& residencyInfo) -> ResultCode
+    {
+        if (m_isInitialised)
+        {
+            internal::log_warn("Texture residency is already initialised!");
+            return ResultCode::eSuccess;
+        }
+
+        const CmdBufferAllocInfo cmdAllocInfo{
+            .count = 1,
+            .level = vk::CommandBufferLevel::ePrimary,
+            .poolFlags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+            .queueIndex = residencyInfo.queueIndex,
+        };
+        auto cmdResult = allocate_command_buffers(cmdAllocInfo);
+        if (!cmdResult)
+        {
+            return cmdResult.error();
+        }
+        auto fenceResult = create_fence({});
+        if (!fenceResult)
+        {
+            free_command_buffers(cmdResult.value());
+            return fenceResult.error();
+        }
+
+        m_info = residencyInfo;
+        m_info.framesInFlight = std::max(m_info.framesInFlight, 1u);
+        m_cmd = cmdResult.value().front();
+        m_fence = fenceResult.value();
+        // Frame 0 means "never used".
+        m_frame = 1;
+        m_isInitialised = true;
+        return ResultCode::eSuccess;
+    }
+
+    void TextureResidency::destroy()
+    {
+        if (!m_isInitialised)
+        {
+            return;
+        }
+
+        for (const auto& texture : m_textures)
+        {
+            if (texture.isValid && texture.image)
+            {
+                destroy_image_view(texture.view);
+                destroy_image(texture.image);
+            }
+        }
+        for (const auto& retired : m_retiredImages)
+        {
+            destroy_image_view(retired.view);
+            destroy_image(retired.image);
+        }
+        free_command_buffers({ m_cmd });
+        destroy_fence(m_fence);
+
+        m_textures.clear();
+        m_freeTextures.clear();
+        m_retiredImages.clear();
+        m_cmd = nullptr;
+        m_fence = nullptr;
+        m_residentBytes = 0;
+        m_isInitialised = false;
+    }
+
+    auto TextureResidency::add_texture(const ResidentTextureInfo& textureInfo) -> std::expected<ResidentTexture, ResultCode>
+    {
+        if (!m_isInitialised)
+        {
+            internal::log_error("Texture residency is not initialised!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+        if (!textureInfo.loadMip || textureInfo.mipLevels == 0 || textureInfo.width == 0 || textureInfo.height == 0)
+        {
+            internal::log_error("Resident texture needs a size, at least one mip and a load function!");
+            return std::unexpected(ResultCode::eFailedToCreate);
+        }
+
+        std::uint32_t index{};
+        if (!m_freeTextures.empty())
+        {
+            index = m_freeTextures.back();
+            m_freeTextures.pop_back();
+        }
+        else
+        {
+            index = std::uint32_t(m_textures.size());
+            m_textures.emplace_back();
+        }
+
+        auto& texture = m_textures.at(index);
+        texture = {};
+        texture.info = textureInfo;
+        texture.residentMip = textureInfo.mipLevels;
+        texture.fallbackMip = textureInfo.mipLevels - 1;
+        for (std::uint32_t mip = 0; mip < textureInfo.mipLevels; ++mip)
+        {
+            const auto extent = get_mip_extent(textureInfo, mip);
+            if (std::max(extent.width, extent.height) <= m_info.fallbackSize)
+            {
+                texture.fallbackMip = mip;
+                break;
+            }
+        }
+        texture.isValid = true;
+
+        auto result = apply_changes({ { index, texture.fallbackMip } });
+        if (result != ResultCode::eSuccess)
+        {
+            m_textures.at(index).isValid = false;
+            m_freeTextures.push_back(index);
+            return std::unexpected(result);
+        }
+        return ResidentTexture{ index };
+    }
+
+    void TextureResidency::remove_texture(ResidentTexture texture)
+    {
+        if (texture.index >= m_textures.size() || !m_textures.at(texture.index).isValid)
+        {
+            internal::log_warn("Tried to remove unknown resident texture.");
+            return;
+        }
+
+        auto& textureRef = m_textures.at(texture.index);
+        retire_image(textureRef.image, textureRef.view);
+        m_residentBytes -= textureRef.residentBytes;
+        textureRef = {};
+        m_freeTextures.push_back(texture.index);
+    }
+
+    void TextureResidency::touch(ResidentTexture texture)
+    {
+        if (texture.index < m_textures.size())
+        {
+            m_textures.at(texture.index).lastUsedFrame = m_frame;
+        }
+    }
+
+    void TextureResidency::bind_to_set(ResidentTexture texture, const SetImageBindInfo& bindInfo)
+    {
+        if (texture.index >= m_textures.size() || !m_textures.at(texture.index).isValid)
+        {
+            internal::log_error("Tried to bind unknown resident texture!");
+            return;
+        }
+
+        auto& textureRef = m_textures.at(texture.index);
+        auto binding = bindInfo;
+        binding.imageView = textureRef.view;
+        binding.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        bind_image_to_set(binding);
+        textureRef.lastUsedFrame = m_frame;
+    }
+
+    auto TextureResidency::update() -> ResultCode
+    {
+        if (!m_isInitialised)
+        {
+            internal::log_error("Texture residency is not initialised!");
+            return ResultCode::eFailed;
+        }
+
+        ++m_frame;
+        std::erase_if(m_retiredImages,
+                      [&](const RetiredImage& retired)
+                      {
+                          if (retired.retiredFrame + m_info.framesInFlight > m_frame)
+                          {
+                              return false;
+                          }
+                          destroy_image_view(retired.view);
+                          destroy_image(retired.image);
+                          return true;
+                      });
+
+        // Plan streaming in the missing mips of recently used textures, most recently used first, within the upload limit.
+        std::vector<std::uint32_t> streamCandidates{};
+        std::vector<std::uint32_t> evictCandidates{};
+        for (std::uint32_t i = 0; i < m_textures.size(); ++i)
+        {
+            const auto& texture = m_textures.at(i);
+            if (!texture.isValid)
+            {
+                continue;
+            }
+            if (is_in_use(texture) && texture.residentMip > 0)
+            {
+                streamCandidates.push_back(i);
+            }
+            else if (!is_in_use(texture) && texture.residentMip < texture.fallbackMip)
+            {
+                evictCandidates.push_back(i);
+            }
+        }
+        std::ranges::sort(streamCandidates, std::greater<>{}, [&](std::uint32_t i) { return m_textures.at(i).lastUsedFrame; });
+        std::ranges::sort(evictCandidates, std::less<>{}, [&](std::uint32_t i) { return m_textures.at(i).lastUsedFrame; });
+
+        struct StreamPlan
+        {
+            Change change{};
+            vk::DeviceSize extraBytes{};
+        };
+        std::vector<StreamPlan> streamPlans{};
+        vk::DeviceSize uploadBudget = m_info.maxUploadBytesPerUpdate;
+        vk::DeviceSize streamBytes{};
+        for (auto index : streamCandidates)
+        {
+            const auto& texture = m_textures.at(index);
+            auto targetMip = texture.residentMip;
+            auto targetBytes = texture.residentBytes;
+            while (targetMip > 0)
+            {
+                const auto mipBytes = get_mip_chain_bytes(texture.info, targetMip - 1);
+                if (mipBytes - targetBytes > uploadBudget)
+                {
+                    break;
+                }
+                uploadBudget -= mipBytes - targetBytes;
+                targetBytes = mipBytes;
+                --targetMip;
+            }
+            if (targetMip < texture.residentMip)
+            {
+                streamPlans.push_back({ { index, targetMip }, targetBytes - texture.residentBytes });
+                streamBytes += targetBytes - texture.residentBytes;
+            }
+        }
+
+        // Evict the least recently used textures until the streamed in mips fit.
+        const auto limit = get_memory_limit();
+        vk::DeviceSize pressure = m_residentBytes + streamBytes > limit ? m_residentBytes + streamBytes - limit : 0;
+        std::vector<Change> changes{};
+        for (auto index : evictCandidates)
+        {
+            if (pressure == 0)
+            {
+                break;
+            }
+
+            const auto& texture = m_textures.at(index);
+            auto targetMip = texture.residentMip;
+            auto targetBytes = texture.residentBytes;
+            while (targetMip < texture.fallbackMip && pressure > 0)
+            {
+                ++targetMip;
+                const auto mipBytes = get_mip_chain_bytes(texture.info, targetMip);
+                pressure -= std::min(pressure, targetBytes - mipBytes);
+                targetBytes = mipBytes;
+            }
+            changes.push_back({ index, targetMip });
+        }
+
+        // Whatever could not be freed is taken from the least recently used streaming plans.
+        while (pressure > 0 && !streamPlans.empty())
+        {
+            pressure -= std::min(pressure, streamPlans.back().extraBytes);
+            streamPlans.pop_back();
+        }
+        for (const auto& plan : streamPlans)
+        {
+            changes.push_back(plan.change);
+        }
+
+        if (changes.empty())
+        {
+            return ResultCode::eSuccess;
+        }
+        return apply_changes(changes);
+    }
+
+    auto TextureResidency::get_image_view(ResidentTexture texture) const -> vk::ImageView
+    {
+        return texture.index < m_textures.size() ? m_textures.at(texture.index).view : vk::ImageView{};
+    }
+
+    auto TextureResidency::get_resident_mip(ResidentTexture texture) const -> std::uint32_t
+    {
+        return texture.index < m_textures.size() ? m_textures.at(texture.index).residentMip : 0;
+    }
+
+    auto TextureResidency::get_resident_bytes() const -> vk::DeviceSize
+    {
+        return m_residentBytes;
+    }
+
+    auto TextureResidency::get_memory_limit() const -> vk::DeviceSize
+    {
+        if (m_info.maxResidentBytes > 0)
+        {
+            return m_info.maxResidentBytes;
+        }
+
+        auto budgetResult = get_memory_budget();
+        if (!budgetResult)
+        {
+            return m_residentBytes;
+        }
+
+        vk::DeviceSize budget{};
+        vk::DeviceSize usage{};
+        for (const auto& heapBudget : budgetResult.value())
+        {
+            if (heapBudget.flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+            {
+                budget += heapBudget.budget;
+                usage += heapBudget.usage;
+            }
+        }
+
+        // Everything else using the heaps (including other processes, when VK_EXT_memory_budget is supported) keeps its memory.
+        const auto allowed = vk::DeviceSize(double(budget) * double(m_info.budgetFraction));
+        const auto otherUsage = usage > m_residentBytes ? usage - m_residentBytes : 0;
+        return allowed > otherUsage ? allowed - otherUsage : 0;
+    }
+
+    auto TextureResidency::get_mip_chain_bytes(const ResidentTextureInfo& info, std::uint32_t baseMip) const -> vk::DeviceSize
+    {
+        auto requirementsResult = get_image_memory_requirements(make_image_info(info, baseMip));
+        return requirementsResult ? requirementsResult.value().size : 0;
+    }
+
+    auto TextureResidency::is_in_use(const Texture& texture) const -> bool
+    {
+        return texture.lastUsedFrame != 0 && texture.lastUsedFrame + m_info.framesInFlight > m_frame;
+    }
+
+    auto TextureResidency::apply_changes(const std::vector<Change>& changes) -> ResultCode
+    {
+        struct Upload
+        {
+            std::uint32_t mip{};
+            vk::DeviceSize offset{};
+            std::vector<std::uint8_t> pixels{};
+        };
+        struct Replacement
+        {
+            std::uint32_t texture{};
+            std::uint32_t targetMip{};
+            vk::Image image{};
+            vk::ImageView view{};
+            std::vector<Upload> uploads{};
+        };
+
+        auto destroy_replacements = [](const std::vector<Replacement>& replacements)
+        {
+            for (const auto& replacement : replacements)
+            {
+                if (replacement.view)
+                {
+                    destroy_image_view(replacement.view);
+                }
+                destroy_image(replacement.image);
+            }
+        };
+
+        // Create the new images and load the mips the current images do not have.
+        std::vector<Replacement> replacements{};
+        vk::DeviceSize stagingSize{};
+        for (const auto& change : changes)
+        {
+            const auto& texture = m_textures.at(change.texture);
+            const auto imageInfo = make_image_info(texture.info, change.targetMip);
+            auto imageResult = create_image(imageInfo);
+            if (!imageResult)
+            {
+                destroy_replacements(replacements);
+                return imageResult.error();
+            }
+            auto& replacement = replacements.emplace_back(Replacement{ change.texture, change.targetMip, imageResult.value() });
+
+            const ImageViewInfo viewInfo{
+                .image = replacement.image,
+                .type = vk::ImageViewType::e2D,
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .mipLevelCount = imageInfo.mipLevels,
+            };
+            auto viewResult = create_image_view(viewInfo);
+            if (!viewResult)
+            {
+                destroy_replacements(replacements);
+                return viewResult.error();
+            }
+            replacement.view = viewResult.value();
+
+            const auto firstCopiedMip = texture.image ? texture.residentMip : texture.info.mipLevels;
+            for (auto mip = change.targetMip; mip < firstCopiedMip; ++mip)
+            {
+                auto pixels = texture.info.loadMip(mip);
+                const auto offset = align_up(stagingSize, 16);
+                stagingSize = offset + pixels.size();
+                replacement.uploads.push_back({ mip, offset, std::move(pixels) });
+            }
+        }
+
+        vk::Buffer stagingBuffer{};
+        if (stagingSize > 0)
+        {
+            const BufferInfo stagingInfo{
+                .size = stagingSize,
+                .usage = vk::BufferUsageFlagBits::eTransferSrc,
+                .memUsage = VMA_MEMORY_USAGE_AUTO,
+                .allocFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+            };
+            auto bufferResult = create_buffer(stagingInfo);
+            if (!bufferResult)
+            {
+                destroy_replacements(replacements);
+                return bufferResult.error();
+            }
+            stagingBuffer = bufferResult.value();
+
+            auto mapResult = map_buffer(stagingBuffer);
+            if (!mapResult)
+            {
+                destroy_buffer(stagingBuffer);
+                destroy_replacements(replacements);
+                return mapResult.error();
+            }
+            auto* mappedData = static_cast<std::uint8_t*>(mapResult.value());
+            for (const auto& replacement : replacements)
+            {
+                for (const auto& upload : replacement.uploads)
+                {
+                    std::memcpy(mappedData + upload.offset, upload.pixels.data(), upload.pixels.size());
+                }
+            }
+            unmap_buffer(stagingBuffer);
+        }
+
+        m_cmd->reset();
+        m_cmd->begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        for (const auto& replacement : replacements)
+        {
+            const auto& texture = m_textures.at(replacement.texture);
+            m_cmd->require_image_state(replacement.image,
+                                       vk::ImageLayout::eTransferDstOptimal,
+                                       vk::AccessFlagBits2::eTransferWrite,
+                                       vk::PipelineStageFlagBits2::eCopy);
+
+            // Mips both images hold are copied on the GPU.
+            if (texture.image)
+            {
+                CopyImageInfo copyInfo{
+                    .srcImage = texture.image,
+                    .srcImageLayout = vk::ImageLayout::eTransferSrcOptimal,
+                    .dstImage = replacement.image,
+                    .dstImageLayout = vk::ImageLayout::eTransferDstOptimal,
+                };
+                for (auto mip = std::max(replacement.targetMip, texture.residentMip); mip < texture.info.mipLevels; ++mip)
+                {
+                    const vk::ImageSubresourceLayers srcSubresource{ vk::ImageAspectFlagBits::eColor, mip - texture.residentMip, 0, 1 };
+                    const vk::ImageSubresourceLayers dstSubresource{ vk::ImageAspectFlagBits::eColor, mip - replacement.targetMip, 0, 1 };
+                    copyInfo.regions.push_back(
+                        vk::ImageCopy2(srcSubresource, {}, dstSubresource, {}, get_mip_extent(texture.info, mip)));
+                }
+                m_cmd->require_image_state(texture.image,
+                                           vk::ImageLayout::eTransferSrcOptimal,
+                                           vk::AccessFlagBits2::eTransferRead,
+                                           vk::PipelineStageFlagBits2::eCopy);
+                m_cmd->copy_image(copyInfo);
+                // Frames recorded before the swap keep sampling the old image until it is retired.
+                m_cmd->require_image_state(
+                    texture.image, vk::ImageLayout::eShaderReadOnlyOptimal, vk::AccessFlagBits2::eShaderRead, SAMPLE_STAGES);
+            }
+
+            if (!replacement.uploads.empty())
+            {
+                CopyBufferToImageInfo copyInfo{
+                    .srcBuffer = stagingBuffer,
+                    .dstImage = replacement.image,
+                    .dstImageLayout = vk::ImageLayout::eTransferDstOptimal,
+                };
+                for (const auto& upload : replacement.uploads)
+                {
+                    const auto dstMip = upload.mip - replacement.targetMip;
+                    const vk::ImageSubresourceLayers subresource{ vk::ImageAspectFlagBits::eColor, dstMip, 0, 1 };
+                    copyInfo.regions.push_back(
+                        vk::BufferImageCopy2(upload.offset, 0, 0, subresource, {}, get_mip_extent(texture.info, upload.mip)));
+                }
+                m_cmd->copy_buffer_to_image(copyInfo);
+            }
+
+            m_cmd->require_image_state(
+                replacement.image, vk::ImageLayout::eShaderReadOnlyOptimal, vk::AccessFlagBits2::eShaderRead, SAMPLE_STAGES);
+        }
+        m_cmd->end();
+
+        const SubmitInfo submitInfo{
+            .queueIndex = m_info.queueIndex,
+            .cmdBuffers = { *m_cmd },
+            .signalFence = m_fence,
+        };
+        submit(submitInfo);
+        wait_on_fence(m_fence);
+        reset_fence(m_fence);
+        if (stagingBuffer)
+        {
+            destroy_buffer(stagingBuffer);
+        }
+
+        // Swap in the new images. Sets are not rewritten here as frames in flight may still use them; the old views stay alive for
+        // `framesInFlight` frames and the new views are picked up by the next `bind_to_set()`.
+        for (const auto& replacement : replacements)
+        {
+            auto& texture = m_textures.at(replacement.texture);
+            if (texture.image)
+            {
+                retire_image(texture.image, texture.view);
+            }
+
+            const auto newBytes = get_mip_chain_bytes(texture.info, replacement.targetMip);
+            m_residentBytes = m_residentBytes - texture.residentBytes + newBytes;
+            texture.image = replacement.image;
+            texture.view = replacement.view;
+            texture.residentMip = replacement.targetMip;
+            texture.residentBytes = newBytes;
+        }
+
+        internal::log_debug("Texture residency: {} textures changed, {} bytes resident.", replacements.size(), m_residentBytes);
+        return ResultCode::eSuccess;
+    }
+
+    void TextureResidency::retire_image(vk::Image image, vk::ImageView view)
+    {
+        if (image)
+        {
+            m_retiredImages.push_back({ image, view, m_frame });
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include "vgw/utility.hpp"
+#include "vgw/vgw.hpp"
 
 #include "internal/internal_core.hpp"
+#include "internal/internal_trace.hpp"
 
 #include <shaderc/shaderc.hpp>
 
@@ -26,6 +28,7 @@ namespace vgw
 
     auto read_spirv_from_file(const std::filesystem::path& spirvFilename) -> std::expected<std::vector<std::uint32_t>, ResultCode>
     {
+        VGW_TRACE_SCOPE("read_spirv_from_file");
         auto file = std::ifstream(spirvFilename, std::ios::ate | std::ios::binary);
         if (!file.is_open())
         {
@@ -39,11 +42,47 @@ namespace vgw
         return buffer;
     }
 
+    auto read_pipeline_cache_from_file(const std::filesystem::path& cacheFilename) -> std::expected<std::vector<std::uint8_t>, ResultCode>
+    {
+        VGW_TRACE_SCOPE("read_pipeline_cache_from_file");
+        auto file = std::ifstream(cacheFilename, std::ios::ate | std::ios::binary);
+        if (!file.is_open())
+        {
+            return std::unexpected(ResultCode::eFailedIO);
+        }
+
+        std::vector<std::uint8_t> buffer(file.tellg());
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(buffer.data()), std::streamsize(buffer.size()));
+        return buffer;
+    }
+
+    auto write_pipeline_cache_to_file(const std::filesystem::path& cacheFilename) -> ResultCode
+    {
+        VGW_TRACE_SCOPE("write_pipeline_cache_to_file");
+        auto dataResult = get_pipeline_cache_data();
+        if (!dataResult)
+        {
+            return dataResult.error();
+        }
+
+        auto file = std::ofstream(cacheFilename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return ResultCode::eFailedIO;
+        }
+
+        const auto& data = dataResult.value();
+        file.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+        return file.good() ? ResultCode::eSuccess : ResultCode::eFailedIO;
+    }
+
     auto compile_glsl(const std::string& glslCode,
                       vk::ShaderStageFlagBits shaderStage,
                       bool generateDebugInfo,
                       std::string_view debugFilename) -> std::expected<std::vector<std::uint32_t>, ResultCode>
     {
+        VGW_TRACE_SCOPE("compile_glsl");
         if (glslCode.empty())
         {
             return {};
@@ -68,4 +107,25 @@ namespace vgw
 
         return std::vector(compileResult.cbegin(), compileResult.cend());
     }
+
+    auto write_trace_json(const std::filesystem::path& traceFilename) -> ResultCode
+    {
+#ifndef VGW_ENABLE_TRACING
+        internal::log_warn("vgw was built without VGW_ENABLE_TRACING. The trace will be empty.");
+#endif
+
+        auto file = std::ofstream(traceFilename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return ResultCode::eFailedIO;
+        }
+
+        file << internal::internal_trace_json_get();
+        return file.good() ? ResultCode::eSuccess : ResultCode::eFailedIO;
+    }
+
+    void clear_trace()
+    {
+        internal::internal_trace_clear();
+    }
 }
\ No newline at end of file
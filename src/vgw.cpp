@@ -9,214 +9,515 @@
 #include "internal/internal_pipelines.hpp"
 #include "internal/internal_buffers.hpp"
 #include "internal/internal_images.hpp"
+#include "internal/internal_memory.hpp"
+#include "internal/internal_defragmentation.hpp"
 #include "internal/internal_sets.hpp"
 #include "internal/internal_command_buffers.hpp"
 #include "internal/internal_synchronisation.hpp"
+#include "internal/internal_queries.hpp"
+#include "internal/internal_trace.hpp"
+#include "internal/internal_stats.hpp"
 
 #include <vulkan/vulkan_hash.hpp>
 
+#include <limits>
+
 namespace vgw
 {
+    namespace
+    {
+        /**
+         * End of a mip/layer range in 64 bits, so VK_REMAINING_MIP_LEVELS/VK_REMAINING_ARRAY_LAYERS (both ~0u) with a non-zero base
+         * cannot wrap around.
+         */
+        auto get_subresource_end(std::uint32_t base, std::uint32_t count) -> std::uint64_t
+        {
+            return count == VK_REMAINING_MIP_LEVELS ? std::numeric_limits<std::uint64_t>::max() : std::uint64_t(base) + count;
+        }
+
+        bool ranges_overlap(const vk::ImageSubresourceRange& lhs, const vk::ImageSubresourceRange& rhs)
+        {
+            const bool mipsOverlap = lhs.baseMipLevel < get_subresource_end(rhs.baseMipLevel, rhs.levelCount) &&
+                                     rhs.baseMipLevel < get_subresource_end(lhs.baseMipLevel, lhs.levelCount);
+            const bool layersOverlap = lhs.baseArrayLayer < get_subresource_end(rhs.baseArrayLayer, rhs.layerCount) &&
+                                       rhs.baseArrayLayer < get_subresource_end(lhs.baseArrayLayer, lhs.layerCount);
+            return bool(lhs.aspectMask & rhs.aspectMask) && mipsOverlap && layersOverlap;
+        }
+
+        auto get_range_end(std::size_t offset, std::size_t size) -> std::size_t
+        {
+            return size == VK_WHOLE_SIZE ? VK_WHOLE_SIZE : offset + size;
+        }
+
+        bool is_covered_by(const BufferBarrierInfo& bufferBarrier, const MemoryBarrierInfo& memoryBarrier)
+        {
+            return bufferBarrier.srcQueueFamily == VK_QUEUE_FAMILY_IGNORED &&
+                   (memoryBarrier.srcAccess & bufferBarrier.srcAccess) == bufferBarrier.srcAccess &&
+                   (memoryBarrier.dstAccess & bufferBarrier.dstAccess) == bufferBarrier.dstAccess &&
+                   (memoryBarrier.srcStage & bufferBarrier.srcStage) == bufferBarrier.srcStage &&
+                   (memoryBarrier.dstStage & bufferBarrier.dstStage) == bufferBarrier.dstStage;
+        }
+
+        auto to_vk_barrier(const MemoryBarrierInfo& barrierInfo) -> vk::MemoryBarrier2
+        {
+            vk::MemoryBarrier2 barrier{};
+            barrier.setSrcAccessMask(barrierInfo.srcAccess);
+            barrier.setDstAccessMask(barrierInfo.dstAccess);
+            barrier.setSrcStageMask(barrierInfo.srcStage);
+            barrier.setDstStageMask(barrierInfo.dstStage);
+            return barrier;
+        }
+
+        auto to_vk_barrier(const BufferBarrierInfo& barrierInfo) -> vk::BufferMemoryBarrier2
+        {
+            vk::BufferMemoryBarrier2 barrier{};
+            barrier.setBuffer(barrierInfo.buffer);
+            barrier.setOffset(barrierInfo.offset);
+            barrier.setSize(barrierInfo.size);
+            barrier.setSrcAccessMask(barrierInfo.srcAccess);
+            barrier.setDstAccessMask(barrierInfo.dstAccess);
+            barrier.setSrcStageMask(barrierInfo.srcStage);
+            barrier.setDstStageMask(barrierInfo.dstStage);
+            barrier.setSrcQueueFamilyIndex(barrierInfo.srcQueueFamily);
+            barrier.setDstQueueFamilyIndex(barrierInfo.dstQueueFamily);
+            return barrier;
+        }
+
+        auto to_vk_barrier(const ImageTransitionInfo& transitionInfo) -> vk::ImageMemoryBarrier2
+        {
+            vk::ImageMemoryBarrier2 barrier{};
+            barrier.setImage(transitionInfo.image);
+            barrier.setOldLayout(transitionInfo.oldLayout);
+            barrier.setNewLayout(transitionInfo.newLayout);
+            barrier.setSrcAccessMask(transitionInfo.srcAccess);
+            barrier.setDstAccessMask(transitionInfo.dstAccess);
+            barrier.setSrcStageMask(transitionInfo.srcStage);
+            barrier.setDstStageMask(transitionInfo.dstStage);
+            barrier.setSubresourceRange(transitionInfo.subresourceRange);
+            barrier.setSrcQueueFamilyIndex(transitionInfo.srcQueueFamily);
+            barrier.setDstQueueFamilyIndex(transitionInfo.dstQueueFamily);
+            return barrier;
+        }
+    }
+
     void set_message_callback(const MessageCallbackFn& callbackFn)
     {
+        VGW_TRACE_SCOPE("set_message_callback");
         internal::set_message_callback(callbackFn);
     }
 
+    void set_message_level(MessageType minLevel)
+    {
+        VGW_TRACE_SCOPE("set_message_level");
+        internal::set_message_level(minLevel);
+    }
+
+    void set_async_messages(bool enabled)
+    {
+        VGW_TRACE_SCOPE("set_async_messages");
+        internal::set_async_messages(enabled);
+    }
+
+    void flush_messages()
+    {
+        VGW_TRACE_SCOPE("flush_messages");
+        internal::flush_messages();
+    }
+
     auto initialise_context(const ContextInfo& contextInfo) -> ResultCode
     {
+        VGW_TRACE_SCOPE("initialise_context");
         return internal::internal_context_init(contextInfo);
     }
 
     void destroy_context()
     {
+        VGW_TRACE_SCOPE("destroy_context");
         internal::internal_context_destroy();
     }
 
     auto create_surface(void* platformSurfaceHandle) -> std::expected<vk::SurfaceKHR, ResultCode>
     {
+        VGW_TRACE_SCOPE("create_surface");
         return internal::internal_surface_create(platformSurfaceHandle);
     }
 
     auto initialise_device(const DeviceInfo& deviceInfo) -> ResultCode
     {
+        VGW_TRACE_SCOPE("initialise_device");
         return internal::internal_device_create(deviceInfo);
     }
 
     void destroy_device()
     {
+        VGW_TRACE_SCOPE("destroy_device");
         internal::internal_device_destroy();
     }
 
+    auto get_queue_family_index(std::uint32_t queueIndex) -> std::expected<std::uint32_t, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_queue_family_index");
+        return internal::internal_queue_family_get(queueIndex);
+    }
+
     auto create_swapchain(const SwapchainInfo& swapchainInfo) -> std::expected<vk::SwapchainKHR, ResultCode>
     {
+        VGW_TRACE_SCOPE("create_swapchain");
         return internal::internal_swapchain_create(swapchainInfo);
     }
 
     void destroy_swapchain(vk::SwapchainKHR swapchain)
     {
+        VGW_TRACE_SCOPE("destroy_swapchain");
         internal::internal_swapchain_destroy(swapchain);
     }
 
     auto get_swapchain_images(vk::SwapchainKHR swapchain) -> std::expected<std::vector<vk::Image>, ResultCode>
     {
+        VGW_TRACE_SCOPE("get_swapchain_images");
         return internal::internal_swapchain_images_get(swapchain);
     }
 
     auto get_swapchain_format(vk::SwapchainKHR swapchain) -> std::expected<vk::Format, ResultCode>
     {
+        VGW_TRACE_SCOPE("get_swapchain_format");
         return internal::internal_swapchain_format_get(swapchain);
     }
 
     auto acquire_next_swapchain_image(const AcquireInfo& acquireInfo) -> std::expected<std::uint32_t, ResultCode>
     {
+        VGW_TRACE_SCOPE("acquire_next_swapchain_image");
         return internal::internal_swapchain_acquire_next_image(acquireInfo);
     }
 
     auto present_swapchain(const PresentInfo& presentInfo) -> ResultCode
     {
+        VGW_TRACE_SCOPE("present_swapchain");
         return internal::internal_swapchain_present(presentInfo);
     }
 
     auto get_set_layout(const SetLayoutInfo& layoutInfo) -> std::expected<vk::DescriptorSetLayout, ResultCode>
     {
+        VGW_TRACE_SCOPE("get_set_layout");
         return internal::internal_set_layout_get(layoutInfo);
     }
 
     auto get_pipeline_layout(const PipelineLayoutInfo& layoutInfo) -> std::expected<vk::PipelineLayout, ResultCode>
     {
+        VGW_TRACE_SCOPE("get_pipeline_layout");
         return internal::internal_pipeline_layout_get(layoutInfo);
     }
 
     auto create_compute_pipeline(const ComputePipelineInfo& pipelineInfo) -> std::expected<vk::Pipeline, ResultCode>
     {
+        VGW_TRACE_SCOPE("create_compute_pipeline");
         return internal::internal_pipeline_compute_create(pipelineInfo);
     }
 
     auto create_graphics_pipeline(const GraphicsPipelineInfo& pipelineInfo) -> std::expected<vk::Pipeline, ResultCode>
     {
+        VGW_TRACE_SCOPE("create_graphics_pipeline");
         return internal::internal_pipeline_graphics_create(pipelineInfo);
     }
 
+    auto get_pipeline_feedback(vk::Pipeline pipeline) -> std::expected<PipelineFeedback, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_pipeline_feedback");
+        auto pipelineResult = internal::internal_pipeline_get(pipeline);
+        if (!pipelineResult)
+        {
+            return std::unexpected(pipelineResult.error());
+        }
+        return pipelineResult.value().get().feedback;
+    }
+
+    auto get_pipeline_feedback_report() -> std::vector<PipelineFeedback>
+    {
+        VGW_TRACE_SCOPE("get_pipeline_feedback_report");
+        return internal::internal_pipeline_feedback_report_get();
+    }
+
+    auto get_pipeline_cache_data() -> std::expected<std::vector<std::uint8_t>, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_pipeline_cache_data");
+        return internal::internal_pipeline_cache_data_get();
+    }
+
+    auto create_memory_pool(const PoolInfo& poolInfo) -> std::expected<MemoryPool, ResultCode>
+    {
+        VGW_TRACE_SCOPE("create_memory_pool");
+        return internal::internal_memory_pool_create(poolInfo);
+    }
+
+    void destroy_memory_pool(MemoryPool pool)
+    {
+        VGW_TRACE_SCOPE("destroy_memory_pool");
+        internal::internal_memory_pool_destroy(pool);
+    }
+
     auto create_buffer(const BufferInfo& bufferInfo) -> std::expected<vk::Buffer, ResultCode>
     {
+        VGW_TRACE_SCOPE("create_buffer");
         return internal::internal_buffer_create(bufferInfo);
     }
 
     void destroy_buffer(vk::Buffer buffer)
     {
+        VGW_TRACE_SCOPE("destroy_buffer");
         internal::internal_buffer_destroy(buffer);
     }
 
+    auto create_suballocated_buffer(const BufferInfo& bufferInfo) -> std::expected<SubBuffer, ResultCode>
+    {
+        VGW_TRACE_SCOPE("create_suballocated_buffer");
+        return internal::internal_suballocated_buffer_create(bufferInfo);
+    }
+
+    void destroy_suballocated_buffer(const SubBuffer& subBuffer)
+    {
+        VGW_TRACE_SCOPE("destroy_suballocated_buffer");
+        internal::internal_suballocated_buffer_destroy(subBuffer);
+    }
+
+    auto get_buffer_address(vk::Buffer buffer) -> std::expected<vk::DeviceAddress, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_buffer_address");
+        return internal::internal_buffer_address_get(buffer);
+    }
+
     auto map_buffer(vk::Buffer buffer) -> std::expected<void*, ResultCode>
     {
+        VGW_TRACE_SCOPE("map_buffer");
         return internal::internal_buffer_map(buffer);
     }
 
     void unmap_buffer(vk::Buffer buffer)
     {
+        VGW_TRACE_SCOPE("unmap_buffer");
         internal::internal_buffer_unmap(buffer);
     }
 
+    auto get_memory_budget() -> std::expected<std::vector<MemoryHeapBudget>, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_memory_budget");
+        return internal::internal_memory_budget_get();
+    }
+
+    auto get_memory_capabilities() -> std::expected<MemoryCapabilities, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_memory_capabilities");
+        return internal::internal_memory_capabilities_get();
+    }
+
+    auto get_memory_stats() -> std::expected<MemoryStats, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_memory_stats");
+        return internal::internal_memory_stats_get();
+    }
+
+    auto get_memory_pool_stats(MemoryPool pool) -> std::expected<MemoryStats, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_memory_pool_stats");
+        return internal::internal_memory_pool_stats_get(pool);
+    }
+
+    auto dump_memory_json(bool detailed) -> std::expected<std::string, ResultCode>
+    {
+        VGW_TRACE_SCOPE("dump_memory_json");
+        return internal::internal_memory_json_get(detailed);
+    }
+
     auto create_image(const ImageInfo& imageInfo) -> std::expected<vk::Image, ResultCode>
     {
+        VGW_TRACE_SCOPE("create_image");
         return internal::internal_image_create(imageInfo);
     }
 
     void destroy_image(vk::Image image)
     {
+        VGW_TRACE_SCOPE("destroy_image");
         internal::internal_image_destroy(image);
     }
 
+    auto upload_image_host(const ImageUploadInfo& uploadInfo) -> ResultCode
+    {
+        VGW_TRACE_SCOPE("upload_image_host");
+        return internal::internal_image_upload_host(uploadInfo);
+    }
+
+    auto is_host_image_copy_supported(vk::Format format) -> bool
+    {
+        VGW_TRACE_SCOPE("is_host_image_copy_supported");
+        return internal::internal_host_image_copy_supported(format);
+    }
+
+    auto get_buffer_memory_requirements(const BufferInfo& bufferInfo) -> std::expected<vk::MemoryRequirements, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_buffer_memory_requirements");
+        return internal::internal_buffer_memory_requirements_get(bufferInfo);
+    }
+
+    auto get_image_memory_requirements(const ImageInfo& imageInfo) -> std::expected<vk::MemoryRequirements, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_image_memory_requirements");
+        return internal::internal_image_memory_requirements_get(imageInfo);
+    }
+
+    auto create_aliasing_heap(const AliasingHeapInfo& heapInfo) -> std::expected<AliasingHeapLayout, ResultCode>
+    {
+        VGW_TRACE_SCOPE("create_aliasing_heap");
+        return internal::internal_aliasing_heap_create(heapInfo);
+    }
+
+    void destroy_aliasing_heap(AliasingHeap heap)
+    {
+        VGW_TRACE_SCOPE("destroy_aliasing_heap");
+        internal::internal_aliasing_heap_destroy(heap);
+    }
+
+    auto begin_defragmentation(const DefragmentationInfo& defragInfo) -> ResultCode
+    {
+        VGW_TRACE_SCOPE("begin_defragmentation");
+        return internal::internal_defragmentation_begin(defragInfo);
+    }
+
+    auto defragment(double timeBudgetMs) -> std::expected<bool, ResultCode>
+    {
+        VGW_TRACE_SCOPE("defragment");
+        return internal::internal_defragmentation_step(timeBudgetMs);
+    }
+
+    auto end_defragmentation() -> DefragmentationStats
+    {
+        VGW_TRACE_SCOPE("end_defragmentation");
+        return internal::internal_defragmentation_end();
+    }
+
     auto create_image_view(const ImageViewInfo& imageViewInfo) -> std::expected<vk::ImageView, ResultCode>
     {
+        VGW_TRACE_SCOPE("create_image_view");
         return internal::internal_image_view_create(imageViewInfo);
     }
 
     void destroy_image_view(vk::ImageView imageView)
     {
+        VGW_TRACE_SCOPE("destroy_image_view");
         internal::internal_image_view_destroy(imageView);
     }
 
     auto get_sampler(const SamplerInfo& samplerInfo) -> std::expected<vk::Sampler, ResultCode>
     {
+        VGW_TRACE_SCOPE("get_sampler");
         return internal::internal_sampler_get(samplerInfo);
     }
 
     auto create_render_pass(const RenderPassInfo& renderPassInfo) -> std::expected<RenderPass, ResultCode>
     {
+        VGW_TRACE_SCOPE("create_render_pass");
         return internal::internal_render_pass_create(renderPassInfo);
     }
 
     void destroy_render_pass(RenderPass renderPass)
     {
+        VGW_TRACE_SCOPE("destroy_render_pass");
         internal::internal_render_pass_destroy(renderPass);
     }
 
     auto allocate_sets(const SetAllocInfo& allocInfo) -> std::expected<std::vector<vk::DescriptorSet>, ResultCode>
     {
+        VGW_TRACE_SCOPE("allocate_sets");
         return internal::internal_sets_allocate(allocInfo);
     }
 
     void free_sets(const std::vector<vk::DescriptorSet>& sets)
     {
+        VGW_TRACE_SCOPE("free_sets");
         internal::internal_sets_free(sets);
     }
 
     void bind_buffer_to_set(const SetBufferBindInfo& bindInfo)
     {
+        VGW_TRACE_SCOPE("bind_buffer_to_set");
         internal::internal_sets_bind_buffer(bindInfo);
     }
 
+    void bind_buffer_to_set(vk::DescriptorSet set, std::uint32_t binding, vk::DescriptorType type, const SubBuffer& subBuffer)
+    {
+        bind_buffer_to_set({
+            .set = set,
+            .binding = binding,
+            .type = type,
+            .buffer = subBuffer.buffer,
+            .offset = subBuffer.offset,
+            .range = subBuffer.size,
+        });
+    }
+
     void bind_image_to_set(const SetImageBindInfo& bindInfo)
     {
+        VGW_TRACE_SCOPE("bind_image_to_set");
         internal::internal_sets_bind_image(bindInfo);
     }
 
     void flush_set_writes()
     {
+        VGW_TRACE_SCOPE("flush_set_writes");
         internal::internal_sets_flush_writes();
     }
 
     auto allocate_command_buffers(const CmdBufferAllocInfo& allocInfo) -> std::expected<std::vector<CommandBuffer>, ResultCode>
     {
+        VGW_TRACE_SCOPE("allocate_command_buffers");
         return internal::internal_cmd_buffers_allocate(allocInfo);
     }
 
-    auto free_command_buffers(const std::vector<CommandBuffer>& cmdBuffers)
+    void free_command_buffers(const std::vector<CommandBuffer>& cmdBuffers)
     {
-        return internal::internal_cmd_buffers_free(cmdBuffers);
+        VGW_TRACE_SCOPE("free_command_buffers");
+        internal::internal_cmd_buffers_free(cmdBuffers);
     }
 
     void CommandBuffer_T::reset()
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::reset");
         m_commandBuffer.reset();
+        internal::internal_cmd_buffer_retired_release(m_commandBuffer);
     }
 
     void CommandBuffer_T::begin(const vk::CommandBufferBeginInfo& beginInfo)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::begin");
+        // Beginning implies the previous submission of this command buffer has completed.
+        internal::internal_cmd_buffer_retired_release(m_commandBuffer);
         m_commandBuffer.begin(beginInfo);
         m_boundPipeline = nullptr;
+        m_boundSets.clear();
+        m_gpuScopeStack.clear();
     }
 
     void CommandBuffer_T::end()
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::end");
         flush_pending_barriers();
         m_commandBuffer.end();
     }
 
     void CommandBuffer_T::begin_pass(RenderPass renderPass)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::begin_pass");
         flush_pending_barriers();
         internal::internal_render_pass_begin(m_commandBuffer, renderPass);
     }
 
     void CommandBuffer_T::end_pass()
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::end_pass");
         m_commandBuffer.endRendering();
     }
 
     void CommandBuffer_T::set_viewport(float x, float y, float width, float height, float minDepth, float maxDepth)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::set_viewport");
         vk::Viewport viewport{};
         viewport.setX(x);
         viewport.setY(y);
@@ -229,6 +530,7 @@ namespace vgw
 
     void CommandBuffer_T::set_scissor(std::int32_t x, std::int32_t y, std::uint32_t width, std::uint32_t height)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::set_scissor");
         vk::Rect2D scissor{};
         scissor.setOffset({ x, y });
         scissor.setExtent({ width, height });
@@ -237,26 +539,37 @@ namespace vgw
 
     void CommandBuffer_T::bind_pipeline(vk::Pipeline pipeline)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::bind_pipeline");
         if (m_boundPipeline == pipeline)
         {
             return;
         }
         internal::internal_pipeline_bind(m_commandBuffer, pipeline);
         m_boundPipeline = pipeline;
+        internal::internal_stats_add(internal::internal_stats_get().pipelineBinds);
     }
 
     void CommandBuffer_T::bind_sets(std::uint32_t firstSet, const std::vector<vk::DescriptorSet>& sets)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::bind_sets");
         if (!m_boundPipeline)
         {
             internal::log_error("No pipeline is bound!");
             return;
         }
         internal::internal_sets_bind(m_commandBuffer, m_boundPipeline, firstSet, sets);
+        internal::internal_stats_add(internal::internal_stats_get().setBinds);
+
+        if (m_boundSets.size() < firstSet + sets.size())
+        {
+            m_boundSets.resize(firstSet + sets.size());
+        }
+        std::ranges::copy(sets, m_boundSets.begin() + firstSet);
     }
 
     void CommandBuffer_T::set_constants(vk::ShaderStageFlags shadeStages, std::uint64_t offset, std::uint64_t size, const void* data)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::set_constants");
         if (!m_boundPipeline)
         {
             internal::log_error("No pipeline is bound!");
@@ -271,16 +584,29 @@ namespace vgw
         const auto& pipelineRef = pipelineResult.value().get();
 
         m_commandBuffer.pushConstants(pipelineRef.layout, shadeStages, offset, size, data);
+        internal::internal_stats_add(internal::internal_stats_get().pushConstantUpdates);
+    }
+
+    void CommandBuffer_T::bind_vertex_buffer(vk::Buffer buffer, vk::DeviceSize offset)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::bind_vertex_buffer");
+        m_commandBuffer.bindVertexBuffers(0, buffer, offset);
     }
 
-    void CommandBuffer_T::bind_vertex_buffer(vk::Buffer buffer)
+    void CommandBuffer_T::bind_index_buffer(vk::Buffer buffer, vk::IndexType indexType, vk::DeviceSize offset)
     {
-        m_commandBuffer.bindVertexBuffers(0, buffer, { 0 });
+        VGW_TRACE_SCOPE("CommandBuffer_T::bind_index_buffer");
+        m_commandBuffer.bindIndexBuffer(buffer, offset, indexType);
     }
 
-    void CommandBuffer_T::bind_index_buffer(vk::Buffer buffer, vk::IndexType indexType)
+    void CommandBuffer_T::bind_vertex_buffer(const SubBuffer& subBuffer)
     {
-        m_commandBuffer.bindIndexBuffer(buffer, 0, indexType);
+        bind_vertex_buffer(subBuffer.buffer, subBuffer.offset);
+    }
+
+    void CommandBuffer_T::bind_index_buffer(const SubBuffer& subBuffer, vk::IndexType indexType)
+    {
+        bind_index_buffer(subBuffer.buffer, indexType, subBuffer.offset);
     }
 
     void CommandBuffer_T::draw(std::uint32_t vertexCount,
@@ -288,8 +614,10 @@ namespace vgw
                                std::uint32_t firstVertex,
                                std::uint32_t firstInstance)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::draw");
         flush_pending_barriers();
         m_commandBuffer.draw(vertexCount, instanceCount, firstVertex, firstInstance);
+        internal::internal_stats_add(internal::internal_stats_get().draws);
     }
 
     void CommandBuffer_T::draw_indexed(std::uint32_t indexCount,
@@ -298,23 +626,479 @@ namespace vgw
                                        std::int32_t vertexOffset,
                                        std::uint32_t firstInstance)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::draw_indexed");
         flush_pending_barriers();
         m_commandBuffer.drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+        internal::internal_stats_add(internal::internal_stats_get().draws);
     }
 
     void CommandBuffer_T::dispatch(std::uint32_t groupCountX, std::uint32_t groupCountY, std::uint32_t groupCountZ)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::dispatch");
+        track_bound_storage_buffers();
         flush_pending_barriers();
         m_commandBuffer.dispatch(groupCountX, groupCountY, groupCountZ);
+        internal::internal_stats_add(internal::internal_stats_get().dispatches);
     }
 
     void CommandBuffer_T::transition_image(const ImageTransitionInfo& transitionInfo)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::transition_image");
         m_pendingImageTransitions.push_back(transitionInfo);
+        if (m_stateTracking)
+        {
+            internal::internal_image_state_set(transitionInfo.image,
+                                               transitionInfo.subresourceRange,
+                                               { transitionInfo.newLayout, transitionInfo.dstAccess, transitionInfo.dstStage });
+        }
+    }
+
+    void CommandBuffer_T::require_image_state(vk::Image image,
+                                              vk::ImageLayout layout,
+                                              vk::AccessFlags2 access,
+                                              vk::PipelineStageFlags2 stage,
+                                              const vk::ImageSubresourceRange& subresourceRange)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::require_image_state");
+        if (!m_stateTracking)
+        {
+            internal::log_error("Cannot require an image state while state tracking is disabled!");
+            return;
+        }
+        auto transitionsResult = internal::internal_image_require_state(image, subresourceRange, { layout, access, stage });
+        if (!transitionsResult)
+        {
+            internal::log_error("Failed to get image!");
+            return;
+        }
+
+        for (const auto& transition : transitionsResult.value())
+        {
+            // A pending barrier on the same subresources has not executed yet, so it can simply be retargeted.
+            auto it = std::ranges::find_if(m_pendingImageTransitions,
+                                           [&](const ImageTransitionInfo& pending)
+                                           {
+                                               return pending.image == transition.image &&
+                                                      ranges_overlap(pending.subresourceRange, transition.subresourceRange);
+                                           });
+            if (it != m_pendingImageTransitions.end() && it->subresourceRange == transition.subresourceRange &&
+                it->srcQueueFamily == VK_QUEUE_FAMILY_IGNORED)
+            {
+                it->newLayout = transition.newLayout;
+                it->dstAccess |= transition.dstAccess;
+                it->dstStage |= transition.dstStage;
+                continue;
+            }
+            if (it != m_pendingImageTransitions.end())
+            {
+                flush_pending_barriers();
+            }
+            m_pendingImageTransitions.push_back(transition);
+        }
+    }
+
+    void CommandBuffer_T::buffer_barrier(const BufferBarrierInfo& barrierInfo)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::buffer_barrier");
+        if (m_stateTracking)
+        {
+            internal::internal_buffer_access_set(barrierInfo.buffer, { barrierInfo.dstAccess, barrierInfo.dstStage });
+        }
+
+        // Barriers in one batch are unordered with respect to each other, so barriers on the same buffer are merged into one.
+        if (barrierInfo.srcQueueFamily == VK_QUEUE_FAMILY_IGNORED)
+        {
+            auto it = std::ranges::find_if(m_pendingBufferBarriers,
+                                           [&](const BufferBarrierInfo& pending)
+                                           {
+                                               return pending.buffer == barrierInfo.buffer &&
+                                                      pending.srcQueueFamily == VK_QUEUE_FAMILY_IGNORED;
+                                           });
+            if (it != m_pendingBufferBarriers.end())
+            {
+                const auto pendingEnd = get_range_end(it->offset, it->size);
+                const auto newEnd = get_range_end(barrierInfo.offset, barrierInfo.size);
+                it->offset = std::min(it->offset, barrierInfo.offset);
+                const bool wholeSize = pendingEnd == VK_WHOLE_SIZE || newEnd == VK_WHOLE_SIZE;
+                it->size = wholeSize ? VK_WHOLE_SIZE : std::max(pendingEnd, newEnd) - it->offset;
+                it->srcAccess |= barrierInfo.srcAccess;
+                it->dstAccess |= barrierInfo.dstAccess;
+                it->srcStage |= barrierInfo.srcStage;
+                it->dstStage |= barrierInfo.dstStage;
+                return;
+            }
+        }
+
+        m_pendingBufferBarriers.push_back(barrierInfo);
+    }
+
+    void CommandBuffer_T::memory_barrier(const MemoryBarrierInfo& barrierInfo)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::memory_barrier");
+        if (!m_pendingMemoryBarrier)
+        {
+            m_pendingMemoryBarrier = barrierInfo;
+            return;
+        }
+
+        m_pendingMemoryBarrier->srcAccess |= barrierInfo.srcAccess;
+        m_pendingMemoryBarrier->dstAccess |= barrierInfo.dstAccess;
+        m_pendingMemoryBarrier->srcStage |= barrierInfo.srcStage;
+        m_pendingMemoryBarrier->dstStage |= barrierInfo.dstStage;
+    }
+
+    void CommandBuffer_T::set_buffer_hazard_tracking(bool enabled)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::set_buffer_hazard_tracking");
+        m_bufferHazardTracking = enabled;
+    }
+
+    void CommandBuffer_T::set_state_tracking(bool enabled)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::set_state_tracking");
+        m_stateTracking = enabled;
+    }
+
+    void CommandBuffer_T::signal_event(vk::Event event, const EventDependencyInfo& dependency)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::signal_event");
+        auto eventResult = internal::internal_event_get(event);
+        if (!eventResult)
+        {
+            internal::log_error("Failed to get event!");
+            return;
+        }
+        auto& eventRef = eventResult.value().get();
+
+        eventRef.memoryBarriers.clear();
+        eventRef.bufferBarriers.clear();
+        eventRef.imageBarriers.clear();
+        for (const auto& barrierInfo : dependency.memoryBarriers)
+        {
+            eventRef.memoryBarriers.push_back(to_vk_barrier(barrierInfo));
+        }
+        for (const auto& barrierInfo : dependency.bufferBarriers)
+        {
+            eventRef.bufferBarriers.push_back(to_vk_barrier(barrierInfo));
+            if (m_stateTracking)
+            {
+                internal::internal_buffer_access_set(barrierInfo.buffer, { barrierInfo.dstAccess, barrierInfo.dstStage });
+            }
+        }
+        for (const auto& transitionInfo : dependency.imageTransitions)
+        {
+            eventRef.imageBarriers.push_back(to_vk_barrier(transitionInfo));
+            if (m_stateTracking)
+            {
+                internal::internal_image_state_set(transitionInfo.image,
+                                                   transitionInfo.subresourceRange,
+                                                   { transitionInfo.newLayout, transitionInfo.dstAccess, transitionInfo.dstStage });
+            }
+        }
+
+        vk::DependencyInfo depInfo{};
+        depInfo.setMemoryBarriers(eventRef.memoryBarriers);
+        depInfo.setBufferMemoryBarriers(eventRef.bufferBarriers);
+        depInfo.setImageMemoryBarriers(eventRef.imageBarriers);
+        m_commandBuffer.setEvent2(event, depInfo);
+        internal::internal_cmd_buffer_use_event(m_commandBuffer, event);
+    }
+
+    void CommandBuffer_T::wait_event(vk::Event event)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::wait_event");
+        auto eventResult = internal::internal_event_get(event);
+        if (!eventResult)
+        {
+            internal::log_error("Failed to get event!");
+            return;
+        }
+        const auto& eventRef = eventResult.value().get();
+
+        vk::PipelineStageFlags2 dstStages{};
+        for (const auto& barrier : eventRef.memoryBarriers)
+        {
+            dstStages |= barrier.dstStageMask;
+        }
+        for (const auto& barrier : eventRef.bufferBarriers)
+        {
+            dstStages |= barrier.dstStageMask;
+        }
+        for (const auto& barrier : eventRef.imageBarriers)
+        {
+            dstStages |= barrier.dstStageMask;
+        }
+
+        vk::DependencyInfo depInfo{};
+        depInfo.setMemoryBarriers(eventRef.memoryBarriers);
+        depInfo.setBufferMemoryBarriers(eventRef.bufferBarriers);
+        depInfo.setImageMemoryBarriers(eventRef.imageBarriers);
+        m_commandBuffer.waitEvents2(event, depInfo);
+        m_commandBuffer.resetEvent2(event, dstStages ? dstStages : vk::PipelineStageFlagBits2::eAllCommands);
+        internal::internal_cmd_buffer_use_event(m_commandBuffer, event);
+    }
+
+    void CommandBuffer_T::release_buffer(const BufferOwnershipTransferInfo& transferInfo)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::release_buffer");
+        const auto srcFamily = internal::internal_queue_family_get(transferInfo.srcQueueIndex);
+        const auto dstFamily = internal::internal_queue_family_get(transferInfo.dstQueueIndex);
+        if (!srcFamily || !dstFamily)
+        {
+            internal::log_error("Invalid queue index for buffer ownership transfer!");
+            return;
+        }
+        if (srcFamily.value() == dstFamily.value())
+        {
+            return;
+        }
+
+        buffer_barrier({
+            .buffer = transferInfo.buffer,
+            .offset = transferInfo.offset,
+            .size = transferInfo.size,
+            .srcAccess = transferInfo.srcAccess,
+            .srcStage = transferInfo.srcStage,
+            .srcQueueFamily = srcFamily.value(),
+            .dstQueueFamily = dstFamily.value(),
+        });
+    }
+
+    void CommandBuffer_T::acquire_buffer(const BufferOwnershipTransferInfo& transferInfo)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::acquire_buffer");
+        const auto srcFamily = internal::internal_queue_family_get(transferInfo.srcQueueIndex);
+        const auto dstFamily = internal::internal_queue_family_get(transferInfo.dstQueueIndex);
+        if (!srcFamily || !dstFamily)
+        {
+            internal::log_error("Invalid queue index for buffer ownership transfer!");
+            return;
+        }
+
+        if (srcFamily.value() != dstFamily.value())
+        {
+            buffer_barrier({
+                .buffer = transferInfo.buffer,
+                .offset = transferInfo.offset,
+                .size = transferInfo.size,
+                .dstAccess = transferInfo.dstAccess,
+                .dstStage = transferInfo.dstStage,
+                .srcQueueFamily = srcFamily.value(),
+                .dstQueueFamily = dstFamily.value(),
+            });
+        }
+        else
+        {
+            buffer_barrier({
+                .buffer = transferInfo.buffer,
+                .offset = transferInfo.offset,
+                .size = transferInfo.size,
+                .srcAccess = transferInfo.srcAccess,
+                .dstAccess = transferInfo.dstAccess,
+                .srcStage = transferInfo.srcStage,
+                .dstStage = transferInfo.dstStage,
+            });
+        }
+    }
+
+    void CommandBuffer_T::release_image(const ImageOwnershipTransferInfo& transferInfo)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::release_image");
+        const auto srcFamily = internal::internal_queue_family_get(transferInfo.srcQueueIndex);
+        const auto dstFamily = internal::internal_queue_family_get(transferInfo.dstQueueIndex);
+        if (!srcFamily || !dstFamily)
+        {
+            internal::log_error("Invalid queue index for image ownership transfer!");
+            return;
+        }
+        if (srcFamily.value() == dstFamily.value())
+        {
+            return;
+        }
+
+        transition_image({
+            .image = transferInfo.image,
+            .oldLayout = transferInfo.oldLayout,
+            .newLayout = transferInfo.newLayout,
+            .srcAccess = transferInfo.srcAccess,
+            .srcStage = transferInfo.srcStage,
+            .subresourceRange = transferInfo.subresourceRange,
+            .srcQueueFamily = srcFamily.value(),
+            .dstQueueFamily = dstFamily.value(),
+        });
+    }
+
+    void CommandBuffer_T::acquire_image(const ImageOwnershipTransferInfo& transferInfo)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::acquire_image");
+        const auto srcFamily = internal::internal_queue_family_get(transferInfo.srcQueueIndex);
+        const auto dstFamily = internal::internal_queue_family_get(transferInfo.dstQueueIndex);
+        if (!srcFamily || !dstFamily)
+        {
+            internal::log_error("Invalid queue index for image ownership transfer!");
+            return;
+        }
+
+        if (srcFamily.value() != dstFamily.value())
+        {
+            transition_image({
+                .image = transferInfo.image,
+                .oldLayout = transferInfo.oldLayout,
+                .newLayout = transferInfo.newLayout,
+                .dstAccess = transferInfo.dstAccess,
+                .dstStage = transferInfo.dstStage,
+                .subresourceRange = transferInfo.subresourceRange,
+                .srcQueueFamily = srcFamily.value(),
+                .dstQueueFamily = dstFamily.value(),
+            });
+        }
+        else
+        {
+            transition_image({
+                .image = transferInfo.image,
+                .oldLayout = transferInfo.oldLayout,
+                .newLayout = transferInfo.newLayout,
+                .srcAccess = transferInfo.srcAccess,
+                .dstAccess = transferInfo.dstAccess,
+                .srcStage = transferInfo.srcStage,
+                .dstStage = transferInfo.dstStage,
+                .subresourceRange = transferInfo.subresourceRange,
+            });
+        }
+    }
+
+    void CommandBuffer_T::copy_buffer(const CopyBufferInfo& copyInfo)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::copy_buffer");
+        flush_pending_barriers();
+
+        vk::CopyBufferInfo2 copyBufferInfo{};
+        copyBufferInfo.setSrcBuffer(copyInfo.srcBuffer);
+        copyBufferInfo.setDstBuffer(copyInfo.dstBuffer);
+        copyBufferInfo.setRegions(copyInfo.regions);
+        m_commandBuffer.copyBuffer2(copyBufferInfo);
+    }
+
+    void CommandBuffer_T::copy_buffer(const SubBuffer& srcBuffer, const SubBuffer& dstBuffer)
+    {
+        copy_buffer({
+            .srcBuffer = srcBuffer.buffer,
+            .dstBuffer = dstBuffer.buffer,
+            .regions = { vk::BufferCopy2{ srcBuffer.offset, dstBuffer.offset, std::min(srcBuffer.size, dstBuffer.size) } },
+        });
+    }
+
+    auto CommandBuffer_T::resize_buffer(const ResizeBufferInfo& resizeInfo) -> std::expected<vk::Buffer, ResultCode>
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::resize_buffer");
+        if (!m_stateTracking)
+        {
+            internal::log_error("Cannot resize a buffer while state tracking is disabled!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+        auto bufferResult = internal::internal_buffer_get(resizeInfo.buffer);
+        if (!bufferResult)
+        {
+            internal::log_error("Cannot resize unknown buffer!");
+            return std::unexpected(ResultCode::eInvalidHandle);
+        }
+        const auto oldInfo = bufferResult.value().get().info;
+        if (oldInfo.aliasing.heap)
+        {
+            internal::log_error("Cannot resize a buffer placed in an aliasing heap!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+        if (internal::internal_buffer_is_suballocation_block(resizeInfo.buffer))
+        {
+            internal::log_error("Cannot resize a buffer shared by sub-allocated buffers!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+        if (resizeInfo.preserve && !(oldInfo.usage & vk::BufferUsageFlagBits::eTransferSrc))
+        {
+            internal::log_error("Cannot preserve the contents of a buffer created without eTransferSrc usage!");
+            return std::unexpected(ResultCode::eFailed);
+        }
+
+        auto newInfo = oldInfo;
+        newInfo.size = resizeInfo.size;
+        if (resizeInfo.growthFactor > 1.0f)
+        {
+            if (oldInfo.size >= resizeInfo.size)
+            {
+                return resizeInfo.buffer;
+            }
+            newInfo.size = std::max(resizeInfo.size, vk::DeviceSize(double(oldInfo.size) * double(resizeInfo.growthFactor)));
+        }
+        else if (oldInfo.size == resizeInfo.size)
+        {
+            return resizeInfo.buffer;
+        }
+        newInfo.usage |= vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst;
+
+        auto newBufferResult = internal::internal_buffer_create(newInfo);
+        if (!newBufferResult)
+        {
+            return std::unexpected(newBufferResult.error());
+        }
+        const auto newBuffer = newBufferResult.value();
+
+        const auto copySize = std::min<vk::DeviceSize>(oldInfo.size, newInfo.size);
+        if (resizeInfo.preserve && copySize > 0)
+        {
+            // Writes to the old buffer are only tracked for storage buffers, so untracked writes are waited on conservatively.
+            const internal::BufferAccessState copyState{ vk::AccessFlagBits2::eTransferRead, vk::PipelineStageFlagBits2::eCopy };
+            auto barrierResult = internal::internal_buffer_require_access(resizeInfo.buffer, copyState);
+            auto barrierInfo = barrierResult && barrierResult.value() ? barrierResult.value().value() : BufferBarrierInfo{};
+            if (!barrierInfo.srcStage)
+            {
+                barrierInfo.srcAccess = vk::AccessFlagBits2::eMemoryWrite;
+                barrierInfo.srcStage = vk::PipelineStageFlagBits2::eAllCommands;
+            }
+            barrierInfo.buffer = resizeInfo.buffer;
+            barrierInfo.dstAccess = copyState.access;
+            barrierInfo.dstStage = copyState.stage;
+            buffer_barrier(barrierInfo);
+
+            const CopyBufferInfo copyInfo{
+                .srcBuffer = resizeInfo.buffer,
+                .dstBuffer = newBuffer,
+                .regions = { vk::BufferCopy2(0, 0, copySize) },
+            };
+            copy_buffer(copyInfo);
+
+            // The new buffer may be used in any way next.
+            const BufferBarrierInfo copyBarrierInfo{
+                .buffer = newBuffer,
+                .srcAccess = vk::AccessFlagBits2::eTransferWrite,
+                .dstAccess = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite,
+                .srcStage = vk::PipelineStageFlagBits2::eCopy,
+                .dstStage = vk::PipelineStageFlagBits2::eAllCommands,
+            };
+            buffer_barrier(copyBarrierInfo);
+        }
+
+        internal::internal_cmd_buffer_retire_buffer(m_commandBuffer, resizeInfo.buffer);
+        internal::log_debug("Resized buffer from {} to {} bytes.", oldInfo.size, newInfo.size);
+        return newBuffer;
+    }
+
+    void CommandBuffer_T::copy_image(const CopyImageInfo& copyInfo)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::copy_image");
+        flush_pending_barriers();
+
+        vk::CopyImageInfo2 copyImageInfo{};
+        copyImageInfo.setSrcImage(copyInfo.srcImage);
+        copyImageInfo.setSrcImageLayout(copyInfo.srcImageLayout);
+        copyImageInfo.setDstImage(copyInfo.dstImage);
+        copyImageInfo.setDstImageLayout(copyInfo.dstImageLayout);
+        copyImageInfo.setRegions(copyInfo.regions);
+        m_commandBuffer.copyImage2(copyImageInfo);
     }
 
     void CommandBuffer_T::copy_buffer_to_image(const CopyBufferToImageInfo& copyInfo)
     {
+        VGW_TRACE_SCOPE("CommandBuffer_T::copy_buffer_to_image");
         flush_pending_barriers();
 
         vk::CopyBufferToImageInfo2 copyBufferToImageInfo{};
@@ -325,69 +1109,310 @@ namespace vgw
         m_commandBuffer.copyBufferToImage2(copyBufferToImageInfo);
     }
 
+    void CommandBuffer_T::copy_image_to_buffer(const CopyImageToBufferInfo& copyInfo)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::copy_image_to_buffer");
+        flush_pending_barriers();
+
+        vk::CopyImageToBufferInfo2 copyImageToBufferInfo{};
+        copyImageToBufferInfo.setSrcImage(copyInfo.srcImage);
+        copyImageToBufferInfo.setSrcImageLayout(copyInfo.srcImageLayout);
+        copyImageToBufferInfo.setDstBuffer(copyInfo.dstBuffer);
+        copyImageToBufferInfo.setRegions(copyInfo.regions);
+        m_commandBuffer.copyImageToBuffer2(copyImageToBufferInfo);
+    }
+
+    void CommandBuffer_T::begin_gpu_scope(std::string_view name)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::begin_gpu_scope");
+        const auto parent = m_gpuScopeStack.empty() ? -1 : m_gpuScopeStack.back();
+        m_gpuScopeStack.push_back(internal::internal_gpu_scope_begin(m_commandBuffer, name, parent));
+    }
+
+    void CommandBuffer_T::end_gpu_scope()
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::end_gpu_scope");
+        if (m_gpuScopeStack.empty())
+        {
+            internal::log_error("end_gpu_scope() called without a matching begin_gpu_scope()!");
+            return;
+        }
+
+        internal::internal_gpu_scope_end(m_commandBuffer, m_gpuScopeStack.back());
+        m_gpuScopeStack.pop_back();
+    }
+
+    void CommandBuffer_T::begin_query(Query query)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::begin_query");
+        flush_pending_barriers();
+        internal::internal_query_begin(m_commandBuffer, query);
+    }
+
+    void CommandBuffer_T::end_query(Query query)
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::end_query");
+        flush_pending_barriers();
+        internal::internal_query_end(m_commandBuffer, query);
+    }
+
+    void CommandBuffer_T::track_bound_storage_buffers()
+    {
+        VGW_TRACE_SCOPE("CommandBuffer_T::track_bound_storage_buffers");
+        if (!m_bufferHazardTracking || !m_stateTracking)
+        {
+            return;
+        }
+
+        // Only dispatches are tracked. Draws happen inside a pass, where barriers cannot be recorded.
+        const internal::BufferAccessState readState{ vk::AccessFlagBits2::eShaderStorageRead, vk::PipelineStageFlagBits2::eComputeShader };
+        const internal::BufferAccessState writeState{ vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite,
+                                                      vk::PipelineStageFlagBits2::eComputeShader };
+        for (auto set : m_boundSets)
+        {
+            auto storageResult = internal::internal_sets_storage_buffers_get(set);
+            if (!storageResult)
+            {
+                continue;
+            }
+
+            for (const auto& storageBinding : storageResult.value().get())
+            {
+                auto barrierResult = internal::internal_buffer_require_access(storageBinding.buffer,
+                                                                              storageBinding.readOnly ? readState : writeState);
+                if (barrierResult && barrierResult.value())
+                {
+                    buffer_barrier(barrierResult.value().value());
+                }
+            }
+        }
+    }
+
     void CommandBuffer_T::flush_pending_barriers()
     {
-        if (m_pendingImageTransitions.empty())
+        VGW_TRACE_SCOPE("CommandBuffer_T::flush_pending_barriers");
+        if (m_pendingImageTransitions.empty() && m_pendingBufferBarriers.empty() && !m_pendingMemoryBarrier)
         {
             return;
         }
 
-        std::vector<vk::ImageMemoryBarrier2> imageBarriers(m_pendingImageTransitions.size());
-        for (int i = 0; i < m_pendingImageTransitions.size(); ++i)
+        std::vector<vk::ImageMemoryBarrier2> imageBarriers{};
+        imageBarriers.reserve(m_pendingImageTransitions.size());
+        for (const auto& transition : m_pendingImageTransitions)
         {
-            const auto& transition = m_pendingImageTransitions.at(i);
-            auto& barrier = imageBarriers.at(i);
-            barrier.setImage(transition.image);
-            barrier.setOldLayout(transition.oldLayout);
-            barrier.setNewLayout(transition.newLayout);
-            barrier.setSrcAccessMask(transition.srcAccess);
-            barrier.setDstAccessMask(transition.dstAccess);
-            barrier.setSrcStageMask(transition.srcStage);
-            barrier.setDstStageMask(transition.dstStage);
-            barrier.setSubresourceRange(transition.subresourceRange);
+            imageBarriers.push_back(to_vk_barrier(transition));
         }
 
+        std::vector<vk::BufferMemoryBarrier2> bufferBarriers{};
+        bufferBarriers.reserve(m_pendingBufferBarriers.size());
+        for (const auto& pending : m_pendingBufferBarriers)
+        {
+            if (m_pendingMemoryBarrier && is_covered_by(pending, m_pendingMemoryBarrier.value()))
+            {
+                continue;
+            }
+
+            bufferBarriers.push_back(to_vk_barrier(pending));
+        }
+
+        vk::MemoryBarrier2 memoryBarrier{};
         vk::DependencyInfo depInfo{};
+        if (m_pendingMemoryBarrier)
+        {
+            memoryBarrier = to_vk_barrier(m_pendingMemoryBarrier.value());
+            depInfo.setMemoryBarriers(memoryBarrier);
+        }
+        depInfo.setBufferMemoryBarriers(bufferBarriers);
         depInfo.setImageMemoryBarriers(imageBarriers);
         m_commandBuffer.pipelineBarrier2(depInfo);
+        internal::internal_stats_barriers_add(imageBarriers.size(), bufferBarriers.size(), m_pendingMemoryBarrier ? 1 : 0);
 
         m_pendingImageTransitions.clear();
+        m_pendingBufferBarriers.clear();
+        m_pendingMemoryBarrier.reset();
     }
 
     void submit(const SubmitInfo& submitInfo)
     {
+        VGW_TRACE_SCOPE("submit");
         internal::internal_submit(submitInfo);
     }
 
     auto create_fence(const FenceInfo& fenceInfo) -> std::expected<vk::Fence, ResultCode>
     {
+        VGW_TRACE_SCOPE("create_fence");
         return internal::internal_fence_create(fenceInfo);
     }
 
     void destroy_fence(vk::Fence fence)
     {
+        VGW_TRACE_SCOPE("destroy_fence");
         internal::internal_fence_destroy(fence);
     }
 
     void wait_on_fence(vk::Fence fence)
     {
+        VGW_TRACE_SCOPE("wait_on_fence");
         internal::internal_fence_wait(fence);
     }
 
     void reset_fence(vk::Fence fence)
     {
+        VGW_TRACE_SCOPE("reset_fence");
         internal::internal_fence_reset(fence);
     }
 
     auto create_semaphore() -> std::expected<vk::Semaphore, ResultCode>
     {
+        VGW_TRACE_SCOPE("create_semaphore");
         return internal::internal_semaphore_create();
     }
 
     void destroy_semaphore(vk::Semaphore semaphore)
     {
+        VGW_TRACE_SCOPE("destroy_semaphore");
         internal::internal_semaphore_destroy(semaphore);
     }
+
+    auto create_event() -> std::expected<vk::Event, ResultCode>
+    {
+        VGW_TRACE_SCOPE("create_event");
+        return internal::internal_event_create();
+    }
+
+    void destroy_event(vk::Event event)
+    {
+        VGW_TRACE_SCOPE("destroy_event");
+        internal::internal_event_destroy(event);
+    }
+
+    auto create_timeline_semaphore(std::uint64_t initialValue) -> std::expected<vk::Semaphore, ResultCode>
+    {
+        VGW_TRACE_SCOPE("create_timeline_semaphore");
+        return internal::internal_timeline_semaphore_create(initialValue);
+    }
+
+    auto get_semaphore_value(vk::Semaphore semaphore) -> std::expected<std::uint64_t, ResultCode>
+    {
+        VGW_TRACE_SCOPE("get_semaphore_value");
+        return internal::internal_semaphore_value_get(semaphore);
+    }
+
+    void wait_on_semaphore(vk::Semaphore semaphore, std::uint64_t value)
+    {
+        VGW_TRACE_SCOPE("wait_on_semaphore");
+        internal::internal_semaphore_wait(semaphore, value);
+    }
+
+    auto initialise_gpu_profiler(const GpuProfilerInfo& profilerInfo) -> ResultCode
+    {
+        VGW_TRACE_SCOPE("initialise_gpu_profiler");
+        return internal::internal_gpu_profiler_create(profilerInfo);
+    }
+
+    void destroy_gpu_profiler()
+    {
+        VGW_TRACE_SCOPE("destroy_gpu_profiler");
+        internal::internal_gpu_profiler_destroy();
+    }
+
+    void begin_gpu_profiler_frame()
+    {
+        VGW_TRACE_SCOPE("begin_gpu_profiler_frame");
+        internal::internal_gpu_profiler_frame_begin();
+    }
+
+    auto get_gpu_frame_report() -> std::optional<GpuFrameReport>
+    {
+        VGW_TRACE_SCOPE("get_gpu_frame_report");
+        return internal::internal_gpu_frame_report_get();
+    }
+
+    auto format_gpu_frame_report(const GpuFrameReport& report) -> std::string
+    {
+        VGW_TRACE_SCOPE("format_gpu_frame_report");
+        auto output = std::format("GPU frame {}: {:.3f} ms\n", report.frameNumber, report.frameMs);
+        for (const auto& scope : report.scopes)
+        {
+            output += std::format("{:{}}{}: {:.3f} ms\n", "", (scope.depth + 1) * 2, scope.name, scope.durationMs);
+        }
+        return output;
+    }
+
+    auto get_gpu_scope_stats() -> std::vector<GpuScopeStats>
+    {
+        VGW_TRACE_SCOPE("get_gpu_scope_stats");
+        return internal::internal_gpu_scope_stats_get();
+    }
+
+    auto get_frame_stats() -> FrameStats
+    {
+        VGW_TRACE_SCOPE("get_frame_stats");
+        return internal::internal_frame_stats_get();
+    }
+
+    void reset_frame_stats()
+    {
+        VGW_TRACE_SCOPE("reset_frame_stats");
+        internal::internal_frame_stats_reset();
+    }
+
+    auto create_query(QueryType type) -> std::expected<Query, ResultCode>
+    {
+        VGW_TRACE_SCOPE("create_query");
+        return internal::internal_query_create(type);
+    }
+
+    void destroy_query(Query query)
+    {
+        VGW_TRACE_SCOPE("destroy_query");
+        internal::internal_query_destroy(query);
+    }
+
+    auto get_occlusion_result(Query query) -> std::optional<std::uint64_t>
+    {
+        VGW_TRACE_SCOPE("get_occlusion_result");
+        auto queryResult = internal::internal_query_get(query);
+        if (!queryResult || queryResult.value().get().type != vk::QueryType::eOcclusion)
+        {
+            internal::log_error("Query is not an occlusion query!");
+            return std::nullopt;
+        }
+        auto results = internal::internal_query_results_get(query);
+        if (!results)
+        {
+            return std::nullopt;
+        }
+        return results->front();
+    }
+
+    auto get_pipeline_statistics(Query query) -> std::optional<PipelineStatistics>
+    {
+        VGW_TRACE_SCOPE("get_pipeline_statistics");
+        auto queryResult = internal::internal_query_get(query);
+        if (!queryResult || queryResult.value().get().type != vk::QueryType::ePipelineStatistics)
+        {
+            internal::log_error("Query is not a pipeline statistics query!");
+            return std::nullopt;
+        }
+        auto results = internal::internal_query_results_get(query);
+        if (!results || results->size() != 7)
+        {
+            return std::nullopt;
+        }
+
+        // Values are written in order of the statistic flag bits.
+        const auto& values = results.value();
+        return PipelineStatistics{
+            .inputAssemblyVertices = values.at(0),
+            .inputAssemblyPrimitives = values.at(1),
+            .vertexShaderInvocations = values.at(2),
+            .clippingInvocations = values.at(3),
+            .clippingPrimitives = values.at(4),
+            .fragmentShaderInvocations = values.at(5),
+            .computeShaderInvocations = values.at(6),
+        };
+    }
 }
 
 namespace std